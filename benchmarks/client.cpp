@@ -0,0 +1,149 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+// Sends commands from the client library to a server run by the epoll transport over a socket pair and
+// reports the commands per second the pair sustains for several pipeline windows
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atcmd/client/client.h>
+#include <atcmd/host/epolltransport.h>
+
+struct Ping : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "PING";
+
+		struct Value : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 1000000}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			server_handle.makeInformationText().printText("+PING:1");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Settings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Ping>;
+
+	static constexpr std::size_t max_commands_per_line = 1;
+};
+
+static constexpr uint32_t l_commands = 200000;
+
+static void writeToFd(const char* data, std::size_t size, void* context)
+{
+	int fd = *static_cast<int*>(context);
+	while (size != 0)
+	{
+		ssize_t n = write(fd, data, size);
+		if (n > 0)
+		{
+			data += n;
+			size -= static_cast<std::size_t>(n);
+		}
+		else if ((n < 0) && (errno != EAGAIN) && (errno != EINTR))
+		{
+			std::perror("write");
+			std::exit(1);
+		}
+	}
+}
+
+static void countResponse(const atcmd::client::Response& response, void* context)
+{
+	if ((response.result != atcmd::RESULT_CODE::OK) || (response.lines.size() != 1))
+	{
+		std::fprintf(stderr, "unexpected response\n");
+		std::exit(1);
+	}
+	++*static_cast<uint32_t*>(context);
+}
+
+static double run(std::size_t window)
+{
+	int fds[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+	{
+		std::perror("socketpair");
+		std::exit(1);
+	}
+	fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+	atcmd::host::EpollTransport<Settings> transport;
+	transport.getSession(transport.add(fds[0])).getCommunicationParameters().setEchoEnabled(false);
+	atcmd::client::Client client(writeToFd, &fds[1], window);
+
+	uint32_t received = 0;
+	uint32_t sent = 0;
+	auto start = std::chrono::steady_clock::now();
+	while (received != l_commands)
+	{
+		// Keeps a window ahead of the server so that the pipeline never drains
+		while ((sent != l_commands) && (client.getQueuedCount() < window))
+		{
+			client.send(atcmd::client::Line().write<Ping>(sent++), countResponse, &received);
+		}
+		transport.poll(0);
+		char buf[4096];
+		ssize_t n;
+		while ((n = read(fds[1], buf, sizeof(buf))) > 0)
+		{
+			client.feed(buf, static_cast<std::size_t>(n));
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	close(fds[1]);
+	return seconds;
+}
+
+int main()
+{
+	for (std::size_t window : {1, 4, 16, 64})
+	{
+		double seconds = run(window);
+		std::printf("window %-3zu %u commands in %.3f s: %.0f commands/s\n", window, l_commands, seconds,
+				l_commands / seconds);
+	}
+	return 0;
+}
@@ -0,0 +1,146 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+// Runs the same write command line, once received as text through the character state machine and once as
+// a binary frame composed by FrameEncoder and passed to execFrame()
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+#include <atcmd/server/frame.h>
+#include <atcmd/server/server.h>
+
+static uint64_t l_sum = 0;
+
+struct Tune : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "TUNE";
+
+		struct Channel : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 100000}};
+		};
+
+		struct Label : public StringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_length = 16;
+			static constexpr const char* default_value = "";
+		};
+
+		struct Key : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_size = 8;
+			static constexpr uint8_t default_value[] = {0x00};
+		};
+
+		struct Power : public EnumParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr const char* values[] = {"LOW", "MEDIUM", "HIGH"};
+			static constexpr uint8_t default_value = 0;
+		};
+
+		using Parameters = ParameterList<Channel, Label, Key, Power>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			l_sum += parameters.getNumeric<Channel>() + parameters.getEnum<Power>();
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct BenchmarkSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Tune>;
+
+	static constexpr std::size_t max_commands_per_line = 2;
+};
+
+using BenchmarkServer = atcmd::server::Server<BenchmarkSettings>;
+
+static constexpr std::size_t l_lines = 1024 * 1024;
+
+static void printChar(char /*ch*/, void* /*context*/)
+{}
+
+template<class Exec>
+static double run(Exec&& exec)
+{
+	l_sum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < l_lines; i++)
+	{
+		exec();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (l_sum != l_lines * 2 * (12345 + 2))
+	{
+		std::printf("Unexpected sum %llu\n", static_cast<unsigned long long>(l_sum));
+	}
+	return seconds;
+}
+
+static void report(const char* name, double seconds)
+{
+	std::printf("%-6s %zu lines in %.3f s: %.0f lines/s\n", name, l_lines, seconds, l_lines / seconds);
+}
+
+int main()
+{
+	BenchmarkServer server(printChar);
+	server.getCommunicationParameters().setEchoEnabled(false);
+
+	static constexpr std::string_view line =
+			"AT+TUNE=12345,\"channel label\",\"0102030405060708\",\"HIGH\";+TUNE=12345,\"x\",\"01\",\"HIGH\"\r";
+	double text = run([&server]()
+	{
+		server.feed(line.data(), line.size());
+	});
+	report("text", text);
+
+	static constexpr uint8_t key[] = {1, 2, 3, 4, 5, 6, 7, 8};
+	static constexpr uint8_t short_key[] = {1};
+	std::array<uint8_t, 128> buffer;
+	atcmd::server::FrameEncoder<BenchmarkSettings> encoder(buffer);
+	encoder.write<Tune>(12345, "channel label", key, 2).write<Tune>(12345, "x", short_key, 2);
+	std::span<const uint8_t> frame = encoder.getFrame();
+	double binary = run([&server, frame]()
+	{
+		server.execFrame(frame);
+	});
+	report("frame", binary);
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+
+// Parses the information text of a read command received in 64-byte chunks, once by collecting each line into a
+// string and splitting it into strings, as a host would do with std::getline and a stringstream, and once with
+// ResponseParser decoding the fields in place
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <atcmd/responseparser.h>
+
+struct Report : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "REP";
+
+		struct Level : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 100000}};
+		};
+
+		struct Label : public StringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_length = 8;
+			static constexpr const char* default_value = "";
+		};
+
+		struct Key : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_size = 4;
+			static constexpr uint8_t default_value[] = {0x00};
+		};
+
+		struct Mask : public HexadecimalNumericParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr Range ranges[] = {{0, 0xFFFF}};
+			static constexpr uint32_t default_value = 0;
+		};
+
+		using Parameters = ParameterList<Level, Label, Key, Mask>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle /*server_handle*/)
+		{
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+static constexpr std::size_t l_lines = 4 * 1024 * 1024;
+static constexpr char l_response[] = "\r\n+REP:12345,\"a, b\",\"01A2FF\",BEEF\r\n\r\nOK\r\n";
+static constexpr std::size_t l_response_size = sizeof(l_response) - 1;
+static constexpr std::size_t l_chunk_size = 64;
+
+template<class Parse>
+static double run(Parse&& parse)
+{
+	static char input[l_response_size * 1024];
+	for (std::size_t i = 0; i < sizeof(input); i++)
+	{
+		input[i] = l_response[i % l_response_size];
+	}
+
+	uint64_t sum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t line = 0; line < l_lines; line += 1024)
+	{
+		for (std::size_t offset = 0; offset < sizeof(input); offset += l_chunk_size)
+		{
+			std::size_t size = sizeof(input) - offset < l_chunk_size ? sizeof(input) - offset : l_chunk_size;
+			sum += parse(input + offset, size);
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (sum != l_lines * (12345 + 0xBEEF))
+	{
+		std::printf("Unexpected sum %llu\n", static_cast<unsigned long long>(sum));
+	}
+	return seconds;
+}
+
+static void report(const char* name, double seconds)
+{
+	std::printf("%-10s %zu responses in %.3f s: %.0f responses/s\n", name, l_lines, seconds, l_lines / seconds);
+}
+
+int main()
+{
+	std::string line;
+	std::vector<std::string> fields;
+	double copying = run([&line, &fields](const char* data, std::size_t size)
+	{
+		uint64_t r = 0;
+		for (std::size_t i = 0; i < size; i++)
+		{
+			if ((data[i] != '\r') && (data[i] != '\n'))
+			{
+				line += data[i];
+				continue;
+			}
+			if (line.starts_with("+REP:"))
+			{
+				fields.clear();
+				std::string field;
+				bool is_quoted = false;
+				for (char ch : line.substr(5))
+				{
+					if ((ch == ',') && !is_quoted)
+					{
+						fields.push_back(field);
+						field.clear();
+						continue;
+					}
+					is_quoted ^= ch == '"';
+					field += ch;
+				}
+				fields.push_back(field);
+				r += std::strtoul(fields[0].c_str(), nullptr, 10) + std::strtoul(fields[3].c_str(), nullptr, 16);
+			}
+			line.clear();
+		}
+		return r;
+	});
+	report("copying", copying);
+
+	atcmd::ResponseParser<Report> parser;
+	double in_place = run([&parser](const char* data, std::size_t size)
+	{
+		uint64_t r = 0;
+		std::size_t offset = 0;
+		while (offset != size)
+		{
+			offset += parser.feed(data + offset, size - offset);
+			if (parser.hasFields())
+			{
+				r += parser.getNumeric<Report::Definition::Level>() + parser.getNumeric<Report::Definition::Mask>();
+			}
+		}
+		return r;
+	});
+	report("in place", in_place);
+
+	return 0;
+}
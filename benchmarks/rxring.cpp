@@ -0,0 +1,167 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+// Moves received command lines from the UART interrupt to the parser, once through a lock-protected pipe written
+// and read one character at a time and fed per character as the Zephyr example did, and once through RxRing
+// written from the FIFO in bulk and drained into the parser in spans. The interrupt is interleaved in the server
+// thread, a burst of FIFO contents at a time, so scheduling does not dominate the measurement
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+#include <atcmd/rxring.h>
+#include <atcmd/server/server.h>
+
+struct Settings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<>;
+
+	static constexpr std::size_t max_commands_per_line = 1;
+};
+
+static constexpr std::size_t l_lines = 1024 * 1024;
+static constexpr char l_line[] = "AT\r";
+static constexpr std::size_t l_line_size = sizeof(l_line) - 1;
+static constexpr std::size_t l_buffer_size = 128;
+
+static std::size_t l_output_size;
+
+static void printChar(char /*ch*/, void* /*context*/)
+{
+	l_output_size++;
+}
+
+static void printText(const char* /*text*/, std::size_t size, void* /*context*/)
+{
+	l_output_size += size;
+}
+
+// A bounded byte pipe guarded by a lock, as a kernel pipe object is
+class BytePipe
+{
+public:
+	bool write(char ch)
+	{
+		std::lock_guard lock(m_mutex);
+		if (m_tail - m_head == l_buffer_size)
+		{
+			return false;
+		}
+		m_data[m_tail++ % l_buffer_size] = ch;
+		return true;
+	}
+
+	bool read(char& ch)
+	{
+		std::lock_guard lock(m_mutex);
+		if (m_tail == m_head)
+		{
+			return false;
+		}
+		ch = m_data[m_head++ % l_buffer_size];
+		return true;
+	}
+
+private:
+	std::mutex m_mutex;
+	char m_data[l_buffer_size];
+	std::size_t m_head = 0;
+	std::size_t m_tail = 0;
+};
+
+static constexpr std::size_t l_fifo_size = 16;
+
+// Feeds the input in FIFO-sized bursts, each followed by a pass of the main loop
+template<class Interrupt, class Loop>
+static double run(Interrupt&& interrupt, Loop&& loop)
+{
+	static char input[l_line_size * 1024];
+	for (std::size_t i = 0; i < sizeof(input); i++)
+	{
+		input[i] = l_line[i % l_line_size];
+	}
+
+	l_output_size = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t line = 0; line < l_lines; line += 1024)
+	{
+		for (std::size_t offset = 0; offset < sizeof(input); offset += l_fifo_size)
+		{
+			std::size_t size = sizeof(input) - offset < l_fifo_size ? sizeof(input) - offset : l_fifo_size;
+			interrupt(input + offset, size);
+			loop();
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (l_output_size != l_lines * 6)
+	{
+		std::printf("Unexpected output size %zu\n", l_output_size);
+	}
+	return seconds;
+}
+
+static void report(const char* name, double seconds)
+{
+	std::printf("%-10s %zu lines in %.3f s: %.0f bytes/s\n", name, l_lines, seconds,
+			l_lines * l_line_size / seconds);
+}
+
+int main()
+{
+	atcmd::server::Server<Settings> server(printChar);
+	server.setPrintTextCallback(printText);
+	server.getCommunicationParameters().setEchoEnabled(false);
+
+	BytePipe pipe;
+	report("pipe", run([&pipe](const char* data, std::size_t size)
+	{
+		for (std::size_t i = 0; i < size; i++)
+		{
+			pipe.write(data[i]);
+		}
+	}, [&pipe, &server]()
+	{
+		char ch;
+		while (pipe.read(ch))
+		{
+			server.feed(ch);
+		}
+	}));
+
+	atcmd::RxRing<l_buffer_size> ring;
+	report("RxRing", run([&ring](const char* data, std::size_t size)
+	{
+		ring.write(data, size);
+	}, [&ring, &server]()
+	{
+		ring.drain([&server](const char* data, std::size_t size)
+		{
+			return server.feed(data, size);
+		});
+	}));
+	return 0;
+}
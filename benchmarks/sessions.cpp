@@ -0,0 +1,148 @@
+/**
+* Copyright © 2026 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+// Feeds the same command lines to many sessions in round robin, as a modem bank would
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include <atcmd/server/server.h>
+
+struct Gmi : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "GMI";
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeParameterInformationText(name)
+				.printStringParameter("Benchmark Manufacturer");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Cfg : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "CFG";
+
+		struct Mode : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 255}};
+		};
+
+		struct Label : public StringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_length = 16;
+			static constexpr const char* default_value = "";
+		};
+
+		using Parameters = ParameterList<Mode, Label>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle /*server_handle*/)
+		{
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.printInformationText<Parameters, "+CFG:{},\"{}\"">(1, "label");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Settings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Gmi, Cfg>;
+
+	static constexpr std::size_t max_commands_per_line = 2;
+};
+
+using Session = atcmd::server::Session<Settings>;
+
+static std::size_t l_output_size;
+
+static void printChar(char /*ch*/, void* /*context*/)
+{
+	l_output_size++;
+}
+
+static void printText(const char* /*text*/, std::size_t size, void* /*context*/)
+{
+	l_output_size += size;
+}
+
+int main()
+{
+	static constexpr std::size_t session_count = 1000;
+	static constexpr std::size_t rounds = 1000;
+	static constexpr const char* lines[] =
+	{
+		"AT+GMI?\r",
+		"AT+CFG=3,\"channel\";+CFG?\r",
+		"AT\r"
+	};
+
+	std::vector<std::unique_ptr<Session>> sessions;
+	for (std::size_t i = 0; i < session_count; i++)
+	{
+		sessions.push_back(std::make_unique<Session>(printChar));
+		sessions.back()->setPrintTextCallback(printText);
+		sessions.back()->getCommunicationParameters().setEchoEnabled(false);
+	}
+
+	std::size_t line_count = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t r = 0; r < rounds; r++)
+	{
+		const char* line = lines[r % std::size(lines)];
+		for (auto& session : sessions)
+		{
+			for (const char* ch = line; *ch != '\0'; ch++)
+			{
+				session->feed(*ch);
+			}
+		}
+		line_count += sessions.size();
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::printf("sizeof(Session): %zu bytes\n", sizeof(Session));
+	std::printf("%zu sessions, %zu lines in %.3f s: %.0f lines/s, %zu output bytes\n",
+			session_count, line_count, elapsed.count(), line_count / elapsed.count(), l_output_size);
+	return 0;
+}
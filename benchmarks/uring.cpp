@@ -0,0 +1,258 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+// Serves the same commands over loopback sockets with the io_uring transport and with a plain epoll loop of
+// read() and write() calls, reporting the server-side system calls per command
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atcmd/host/uringtransport.h>
+
+struct Ping : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "PING";
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeParameterInformationText(name)
+				.printStringParameter("pong");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Settings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Ping>;
+
+	static constexpr std::size_t max_commands_per_line = 1;
+};
+
+using Session = atcmd::server::Session<Settings>;
+
+static constexpr std::size_t l_client_count = 64;
+static constexpr std::size_t l_rounds = 2000;
+static constexpr char l_command[] = "AT+PING?\r";
+static constexpr std::size_t l_response_size = sizeof("\r\n+PING:\"pong\"\r\n\r\nOK\r\n") - 1;
+
+struct Result
+{
+	double seconds;
+	uint64_t syscalls;
+};
+
+static void openClients(std::vector<int>& servers, std::vector<int>& clients)
+{
+	for (std::size_t i = 0; i < l_client_count; i++)
+	{
+		int fds[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+		{
+			std::perror("socketpair");
+			std::exit(1);
+		}
+		fcntl(fds[1], F_SETFL, O_NONBLOCK);
+		servers.push_back(fds[0]);
+		clients.push_back(fds[1]);
+	}
+}
+
+// Sends a command from every client and runs the server loop until all responses are back
+template<class Poll>
+static void runRound(const std::vector<int>& clients, Poll&& poll)
+{
+	for (int client : clients)
+	{
+		if (write(client, l_command, sizeof(l_command) - 1) != sizeof(l_command) - 1)
+		{
+			std::perror("write");
+			std::exit(1);
+		}
+	}
+	std::vector<std::size_t> received(clients.size(), 0);
+	std::size_t done = 0;
+	while (done != clients.size())
+	{
+		poll();
+		for (std::size_t i = 0; i < clients.size(); i++)
+		{
+			char buf[256];
+			ssize_t n = read(clients[i], buf, sizeof(buf));
+			if (n > 0)
+			{
+				received[i] += static_cast<std::size_t>(n);
+				if (received[i] == l_response_size)
+				{
+					done++;
+				}
+			}
+		}
+	}
+}
+
+static Result runUring()
+{
+	atcmd::host::UringTransport<Settings> transport;
+	if (!transport.isValid())
+	{
+		std::fprintf(stderr, "io_uring is not available\n");
+		std::exit(1);
+	}
+	std::vector<int> servers;
+	std::vector<int> clients;
+	openClients(servers, clients);
+	for (int fd : servers)
+	{
+		int index = transport.add(fd);
+		transport.getSession(index).getCommunicationParameters().setEchoEnabled(false);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	uint64_t syscalls = transport.getSyscallCount();
+	for (std::size_t r = 0; r < l_rounds; r++)
+	{
+		runRound(clients, [&] { transport.poll(1); });
+	}
+	Result result{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+			transport.getSyscallCount() - syscalls};
+	for (int client : clients)
+	{
+		close(client);
+	}
+	return result;
+}
+
+struct PlainEndpoint
+{
+	explicit PlainEndpoint(int fd) :
+		fd{fd},
+		session{printChar, this}
+	{
+		session.setPrintTextCallback(printText);
+		session.getCommunicationParameters().setEchoEnabled(false);
+	}
+
+	static void printChar(char ch, void* context)
+	{
+		static_cast<PlainEndpoint*>(context)->output += ch;
+	}
+
+	static void printText(const char* text, std::size_t size, void* context)
+	{
+		static_cast<PlainEndpoint*>(context)->output.append(text, size);
+	}
+
+	int fd;
+	std::string output;
+	Session session;
+};
+
+static Result runPlain()
+{
+	int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	std::vector<int> servers;
+	std::vector<int> clients;
+	openClients(servers, clients);
+	std::vector<std::unique_ptr<PlainEndpoint>> endpoints;
+	for (int fd : servers)
+	{
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+		epoll_event event = {};
+		event.events = EPOLLIN | EPOLLET;
+		event.data.u64 = endpoints.size();
+		epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+		endpoints.push_back(std::make_unique<PlainEndpoint>(fd));
+	}
+
+	uint64_t syscalls = 0;
+	auto poll = [&]
+	{
+		epoll_event events[64];
+		syscalls++;
+		int count = epoll_wait(epoll_fd, events, 64, 1);
+		for (int i = 0; i < count; i++)
+		{
+			PlainEndpoint& endpoint = *endpoints[events[i].data.u64];
+			char buf[512];
+			ssize_t n;
+			// Drained until EAGAIN as the edge-triggered mode requires
+			while (syscalls++, (n = read(endpoint.fd, buf, sizeof(buf))) > 0)
+			{
+				endpoint.session.feed(buf, static_cast<std::size_t>(n));
+			}
+			if (!endpoint.output.empty())
+			{
+				syscalls++;
+				if (write(endpoint.fd, endpoint.output.data(), endpoint.output.size()) > 0)
+				{
+					endpoint.output.clear();
+				}
+			}
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t r = 0; r < l_rounds; r++)
+	{
+		runRound(clients, poll);
+	}
+	Result result{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), syscalls};
+	for (std::size_t i = 0; i < l_client_count; i++)
+	{
+		close(servers[i]);
+		close(clients[i]);
+	}
+	close(epoll_fd);
+	return result;
+}
+
+static void report(const char* name, const Result& result)
+{
+	double commands = static_cast<double>(l_client_count * l_rounds);
+	std::printf("%-10s %zu commands in %.3f s: %.0f commands/s, %.3f syscalls/command\n", name,
+			l_client_count * l_rounds, result.seconds, commands / result.seconds, result.syscalls / commands);
+}
+
+int main()
+{
+	report("read/write", runPlain());
+	report("io_uring", runUring());
+	return 0;
+}
@@ -0,0 +1,125 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_CLIENT_H
+#define ATCMD_CLIENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <atcmd/common.h>
+#include <atcmd/client/line.h>
+
+namespace atcmd::client {
+
+struct Response
+{
+	atcmd::RESULT_CODE result;
+
+	// Information text lines without the framing, in the order received
+	std::vector<std::string> lines;
+};
+
+// Sends bytes to the server, e.g. writes them to a socket or a serial port
+typedef void (*WriteCallback)(const char* data, std::size_t size, void* context);
+
+// Called once per request after its final result code. A data mode command is also reported with CONNECT
+// when the server waits for its payload, the lines received up to then come with it
+typedef void (*ResponseCallback)(const Response& response, void* context);
+
+// A line received while no request is in flight, RING, or information text of a command not in the request
+typedef void (*UnsolicitedCallback)(std::string_view line, void* context);
+
+// Host-side client talking to a server in verbose mode over any byte stream. Up to window lines are in flight,
+// the following ones are queued and sent as the earlier ones complete. Received lines are matched to the
+// oldest request in flight: information text is collected until a final result code completes it.
+// A window above 1 suits commands completing synchronously, a character received while an asynchronous
+// command is in progress may abort it, and a line sent behind a data mode command is taken for its payload
+class Client
+{
+public:
+	Client(WriteCallback write_callback, void* context = nullptr, std::size_t window = 1);
+
+	Client(const Client&) = delete;
+	Client& operator=(const Client&) = delete;
+
+	// Echoed lines are expected and dropped when the server has echo enabled, the default of V.250
+	void setEchoExpected(bool is_expected);
+
+	void setUnsolicitedCallback(UnsolicitedCallback callback, void* context = nullptr);
+
+	// Returns false for an invalid line
+	bool send(const Line& line, ResponseCallback callback, void* context = nullptr);
+
+	// A raw command line without the termination character, e.g. "ATS3?"
+	bool send(std::string_view text, ResponseCallback callback, void* context = nullptr);
+
+	// Received bytes, in any split
+	void feed(const char* data, std::size_t size);
+
+	// The payload of the data mode command reported with CONNECT, sent as is. The queued lines wait for its
+	// final result code. Returns false if the oldest request is not in data mode
+	bool sendData(const char* data, std::size_t size);
+
+	std::size_t getInFlightCount() const;
+	std::size_t getQueuedCount() const;
+	uint64_t getCompletedCount() const;
+
+private:
+	struct Request
+	{
+		std::string text;
+		ResponseCallback callback;
+		void* context;
+		bool is_echoed;
+		bool is_connected;
+		Response response;
+	};
+
+	void transmit();
+	void processLine(std::string_view line);
+	void processUnsolicitedLine(std::string_view line);
+
+	WriteCallback m_write_callback;
+	void* m_context;
+	std::size_t m_window;
+	bool m_is_echo_expected;
+
+	UnsolicitedCallback m_unsolicited_callback;
+	void* m_unsolicited_context;
+
+	std::deque<Request> m_in_flight;
+	std::deque<Request> m_queued;
+	std::string m_line;
+	uint64_t m_completed;
+};
+
+} /* namespace atcmd::client */
+
+#endif // ATCMD_CLIENT_H
@@ -0,0 +1,219 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_LINE_H
+#define ATCMD_LINE_H
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include <atcmd/detail/basiccmddef.h>
+#include <atcmd/detail/cmdparamdef.h>
+#include <atcmd/server/basiccommand.h>
+#include <atcmd/server/extendedcommand.h>
+
+namespace atcmd::client {
+
+namespace detail {
+
+template<class T>
+struct ExtendedParameters;
+
+template<class... Ts>
+struct ExtendedParameters<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>
+{
+	static constexpr std::size_t count = sizeof...(Ts);
+
+	// Parameters after the last mandatory one can be left out
+	static constexpr std::size_t mandatory_count = []()
+	{
+		constexpr bool is_optional[] = {Ts::is_optional..., true};
+		std::size_t r = 0;
+		for (std::size_t i = 0; i < count; i++)
+		{
+			if (!is_optional[i])
+			{
+				r = i + 1;
+			}
+		}
+		return r;
+	}();
+
+	template<std::size_t index>
+	using Type = std::tuple_element_t<index, std::tuple<Ts...>>;
+};
+
+} /* namespace detail */
+
+// A command line composed from the command definitions shared with the server, e.g.
+// Line().write<Cfg>(5, "abc", std::nullopt).read<Mode>(). Values are checked the way the server checks them,
+// a rejected value invalidates the line
+class Line
+{
+public:
+	Line();
+
+	template<atcmd::server::concepts::ExtendedCommand Cmd>
+	Line& read()
+	{
+		startExtended(Cmd::Definition::name);
+		m_text += '?';
+		return *this;
+	}
+
+	template<atcmd::server::concepts::ExtendedCommand Cmd>
+	Line& test()
+	{
+		startExtended(Cmd::Definition::name);
+		m_text += "=?";
+		return *this;
+	}
+
+	// std::nullopt leaves an optional parameter out, the server uses its default value
+	template<atcmd::server::concepts::ExtendedCommand Cmd, class... Args>
+	Line& write(const Args&... args)
+	{
+		using Parameters = detail::ExtendedParameters<typename Cmd::Definition::Parameters>;
+		static_assert(sizeof...(Args) <= Parameters::count, "Too many parameters");
+		static_assert(sizeof...(Args) >= Parameters::mandatory_count, "A mandatory parameter is missing");
+
+		startExtended(Cmd::Definition::name);
+		m_text += '=';
+		[&]<std::size_t... Is>(std::index_sequence<Is...>)
+		{
+			(appendParameter<typename Parameters::template Type<Is>>(Is, args), ...);
+		}(std::index_sequence_for<Args...>());
+		return *this;
+	}
+
+	template<atcmd::server::concepts::BasicCommand Cmd>
+	Line& basic(uint32_t value)
+	{
+		return appendBasic<Cmd>("", value);
+	}
+
+	template<atcmd::server::concepts::AmpersandCommand Cmd>
+	Line& ampersand(uint32_t value)
+	{
+		return appendBasic<Cmd>("&", value);
+	}
+
+	// False after a value the server would reject
+	bool isValid() const;
+
+	// Without the termination character
+	std::string_view getText() const;
+
+private:
+	using CmdParamDef = atcmd::server::detail::CmdParamDef;
+
+	void startExtended(const char* name);
+	void appendNumber(uint32_t value, uint32_t base);
+	void appendString(std::string_view value, std::size_t max_length);
+	void appendHexString(std::span<const uint8_t> value, std::size_t max_size);
+
+	template<class Cmd>
+	Line& appendBasic(const char* prefix, uint32_t value)
+	{
+		using Builder = atcmd::server::detail::BasicCmdDef::ParameterBuilder<typename Cmd::Definition::Parameters>;
+		m_text += prefix;
+		m_text += Cmd::Definition::name;
+		m_is_valid &= CmdParamDef::validateNumericRanges(Builder::ranges, value);
+		appendNumber(value, 10);
+		m_is_extended = false;
+		return *this;
+	}
+
+	template<class P, class Arg>
+	void appendParameter(std::size_t index, const Arg& arg)
+	{
+		if (index != 0)
+		{
+			m_text += ',';
+		}
+		if constexpr (std::same_as<Arg, std::nullopt_t>)
+		{
+			static_assert(P::is_optional, "Only optional parameters can be left out");
+		}
+		else if constexpr (atcmd::server::concepts::NumericParameter<P>)
+		{
+			static_assert(std::integral<Arg>, "A numeric parameter takes an integer");
+			static constexpr CmdParamDef::Ranges ranges =
+			{
+				.count = std::size(P::ranges),
+				.ranges = P::ranges
+			};
+			m_is_valid &= std::in_range<uint32_t>(arg) &&
+					CmdParamDef::validateNumericRanges(ranges, static_cast<uint32_t>(arg));
+			if constexpr (atcmd::server::concepts::HexadecimalNumericParameter<P>)
+			{
+				appendNumber(static_cast<uint32_t>(arg), 16);
+			}
+			else if constexpr (atcmd::server::concepts::BinaryNumericParameter<P>)
+			{
+				appendNumber(static_cast<uint32_t>(arg), 2);
+			}
+			else
+			{
+				appendNumber(static_cast<uint32_t>(arg), 10);
+			}
+		}
+		else if constexpr (atcmd::server::concepts::StringParameter<P>)
+		{
+			static_assert(std::convertible_to<const Arg&, std::string_view>, "A string parameter takes a string");
+			appendString(arg, P::max_length);
+		}
+		else if constexpr (atcmd::server::concepts::EnumParameter<P>)
+		{
+			static_assert(std::integral<Arg>, "An enumerated parameter takes the index of its keyword");
+			bool is_known = std::in_range<std::size_t>(arg) && (static_cast<std::size_t>(arg) < std::size(P::values));
+			m_is_valid &= is_known;
+			std::string_view value = is_known ? P::values[arg] : "";
+			appendString(value, value.size());
+		}
+		else
+		{
+			static_assert(std::convertible_to<const Arg&, std::span<const uint8_t>>, "A hexadecimal string parameter takes bytes");
+			appendHexString(arg, P::max_size);
+		}
+	}
+
+	std::string m_text;
+	bool m_is_valid;
+
+	// Extended commands are separated by ';' from the next command
+	bool m_is_extended;
+};
+
+} /* namespace atcmd::client */
+
+#endif // ATCMD_LINE_H
@@ -0,0 +1,274 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <atcmd/client/client.h>
+
+#include <cctype>
+#include <utility>
+
+namespace atcmd::client {
+
+namespace {
+
+struct FinalResultCode
+{
+	std::string_view text;
+	atcmd::RESULT_CODE result;
+};
+
+// Verbose final result codes of V.250. RING is unsolicited, CONNECT precedes the payload of a data mode command
+constexpr FinalResultCode l_final_result_codes[] =
+{
+	{"OK", atcmd::RESULT_CODE::OK},
+	{"NO CARRIER", atcmd::RESULT_CODE::NO_CARRIER},
+	{"ERROR", atcmd::RESULT_CODE::ERROR},
+	{"NO DIALTONE", atcmd::RESULT_CODE::NO_DIALTONE},
+	{"BUSY", atcmd::RESULT_CODE::BUSY},
+	{"NO ANSWER", atcmd::RESULT_CODE::NO_ANSWER}
+};
+
+// The "+NAME" of information text such as "+NAME:1", empty for other lines
+std::string_view getInformationTextName(std::string_view line)
+{
+	if (line.empty() || (line[0] != '+'))
+	{
+		return {};
+	}
+	std::size_t end = line.find(':');
+	return end == std::string_view::npos ? std::string_view() : line.substr(0, end);
+}
+
+// Whether the command line has an extended command with the name, e.g. "+LIST" in "AT+VAL=1;+list?"
+bool hasExtendedCommand(std::string_view text, std::string_view name)
+{
+	bool is_quoted = false;
+	for (std::size_t i = 0; i < text.size(); i++)
+	{
+		if (text[i] == '"')
+		{
+			is_quoted = !is_quoted;
+		}
+		if (is_quoted || (text[i] != '+') || (text.size() - i < name.size()))
+		{
+			continue;
+		}
+		std::size_t j = 1;
+		while ((j < name.size()) &&
+				(std::toupper(static_cast<unsigned char>(text[i + j])) == std::toupper(static_cast<unsigned char>(name[j]))))
+		{
+			j++;
+		}
+		if ((j == name.size()) &&
+			((i + j == text.size()) || (text[i + j] == '=') || (text[i + j] == '?') || (text[i + j] == ';')))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+} /* anonymous namespace */
+
+Client::Client(WriteCallback write_callback, void* context, std::size_t window) :
+	m_write_callback{write_callback},
+	m_context{context},
+	m_window{window == 0 ? 1 : window},
+	m_is_echo_expected{false},
+	m_unsolicited_callback{nullptr},
+	m_unsolicited_context{nullptr},
+	m_completed{0}
+{}
+
+void Client::setEchoExpected(bool is_expected)
+{
+	m_is_echo_expected = is_expected;
+}
+
+void Client::setUnsolicitedCallback(UnsolicitedCallback callback, void* context)
+{
+	m_unsolicited_callback = callback;
+	m_unsolicited_context = context;
+}
+
+bool Client::send(const Line& line, ResponseCallback callback, void* context)
+{
+	if (!line.isValid())
+	{
+		return false;
+	}
+	return send(line.getText(), callback, context);
+}
+
+bool Client::send(std::string_view text, ResponseCallback callback, void* context)
+{
+	if (text.empty() || (text.find('\r') != std::string_view::npos))
+	{
+		return false;
+	}
+	m_queued.push_back(Request{std::string(text), callback, context, false, false, {}});
+	transmit();
+	return true;
+}
+
+void Client::feed(const char* data, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; i++)
+	{
+		char ch = data[i];
+		if ((ch == '\r') || (ch == '\n'))
+		{
+			if (!m_line.empty())
+			{
+				processLine(m_line);
+				m_line.clear();
+			}
+		}
+		else
+		{
+			m_line += ch;
+		}
+	}
+}
+
+bool Client::sendData(const char* data, std::size_t size)
+{
+	if (m_in_flight.empty() || !m_in_flight.front().is_connected)
+	{
+		return false;
+	}
+	m_write_callback(data, size, m_context);
+	return true;
+}
+
+std::size_t Client::getInFlightCount() const
+{
+	return m_in_flight.size();
+}
+
+std::size_t Client::getQueuedCount() const
+{
+	return m_queued.size();
+}
+
+uint64_t Client::getCompletedCount() const
+{
+	return m_completed;
+}
+
+void Client::transmit()
+{
+	if ((m_in_flight.size() >= m_window) || m_queued.empty())
+	{
+		return;
+	}
+	if (!m_in_flight.empty() && m_in_flight.front().is_connected)
+	{
+		// The server takes whatever follows CONNECT for the payload
+		return;
+	}
+	// All lines the window allows go out with a single write
+	std::string data;
+	while ((m_in_flight.size() < m_window) && !m_queued.empty())
+	{
+		m_in_flight.push_back(std::move(m_queued.front()));
+		m_queued.pop_front();
+		data += m_in_flight.back().text;
+		data += '\r';
+	}
+	m_write_callback(data.data(), data.size(), m_context);
+}
+
+void Client::processLine(std::string_view line)
+{
+	if (m_is_echo_expected)
+	{
+		// Lines are echoed in the order they were sent, each before its own responses
+		for (Request& request : m_in_flight)
+		{
+			if (!request.is_echoed)
+			{
+				if (line == request.text)
+				{
+					request.is_echoed = true;
+					return;
+				}
+				break;
+			}
+		}
+	}
+
+	if (m_in_flight.empty())
+	{
+		processUnsolicitedLine(line);
+		return;
+	}
+
+	Request& request = m_in_flight.front();
+	std::string_view name = getInformationTextName(line);
+	if ((line == "RING") || (!name.empty() && !hasExtendedCommand(request.text, name)))
+	{
+		processUnsolicitedLine(line);
+		return;
+	}
+	if (line == "CONNECT")
+	{
+		// The request stays in flight until the final result code following the payload
+		request.is_connected = true;
+		request.response.result = atcmd::RESULT_CODE::CONNECT;
+		if (request.callback != nullptr)
+		{
+			request.callback(request.response, request.context);
+		}
+		request.response.lines.clear();
+		return;
+	}
+	for (const FinalResultCode& code : l_final_result_codes)
+	{
+		if (line == code.text)
+		{
+			request.response.result = code.result;
+			Request done = std::move(request);
+			m_in_flight.pop_front();
+			m_completed++;
+			transmit();
+			if (done.callback != nullptr)
+			{
+				done.callback(done.response, done.context);
+			}
+			return;
+		}
+	}
+	request.response.lines.emplace_back(line);
+}
+
+void Client::processUnsolicitedLine(std::string_view line)
+{
+	if (m_unsolicited_callback != nullptr)
+	{
+		m_unsolicited_callback(line, m_unsolicited_context);
+	}
+}
+
+} /* namespace atcmd::client */
@@ -0,0 +1,93 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <atcmd/client/line.h>
+
+namespace atcmd::client {
+
+Line::Line() :
+	m_text{"AT"},
+	m_is_valid{true},
+	m_is_extended{false}
+{}
+
+bool Line::isValid() const
+{
+	return m_is_valid;
+}
+
+std::string_view Line::getText() const
+{
+	return m_text;
+}
+
+void Line::startExtended(const char* name)
+{
+	if (m_is_extended)
+	{
+		m_text += ';';
+	}
+	m_text += '+';
+	m_text += name;
+	m_is_extended = true;
+}
+
+void Line::appendNumber(uint32_t value, uint32_t base)
+{
+	char buf[32];
+	std::size_t size = 0;
+	do
+	{
+		buf[size++] = "0123456789ABCDEF"[value % base];
+		value /= base;
+	} while (value != 0);
+	while (size != 0)
+	{
+		m_text += buf[--size];
+	}
+}
+
+void Line::appendString(std::string_view value, std::size_t max_length)
+{
+	// The parser has no escapes, a quote would end the string
+	m_is_valid &= (value.size() <= max_length) && (value.find_first_of("\"\r") == std::string_view::npos);
+	m_text += '"';
+	m_text += value;
+	m_text += '"';
+}
+
+void Line::appendHexString(std::span<const uint8_t> value, std::size_t max_size)
+{
+	m_is_valid &= value.size() <= max_size;
+	m_text += '"';
+	for (uint8_t byte : value)
+	{
+		m_text += "0123456789ABCDEF"[byte >> 4];
+		m_text += "0123456789ABCDEF"[byte & 0x0F];
+	}
+	m_text += '"';
+}
+
+} /* namespace atcmd::client */
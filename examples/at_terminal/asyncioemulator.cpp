@@ -34,9 +34,7 @@ AsyncIoEmulator::AsyncIoEmulator(std::mutex& mutex, std::condition_variable& con
 	AsyncWorker(mutex, cond),
 	m_d{},
 	m_write_ongoing{false},
-	m_write_done{false},
 	m_write_terminated{false},
-	m_read_done{false},
 	m_read_thread(std::bind_front(&AsyncIoEmulator::read_, this))
 {}
 
@@ -47,7 +45,6 @@ void AsyncIoEmulator::write(uint_fast8_t index, uint32_t data)
 		return;
 	}
 	m_write_ongoing = true;
-	m_write_done = false;
 	m_write_terminated = false;
 	m_write_future = std::async(std::launch::async, &AsyncIoEmulator::write_, this, index, data);
 }
@@ -58,9 +55,7 @@ void AsyncIoEmulator::writeTerminate()
 }
 
 void AsyncIoEmulator::read()
-{
-	m_read_done = false;
-}
+{}
 
 void AsyncIoEmulator::get(uint32_t& d0, uint32_t& d1, uint32_t& d2) const
 {
@@ -72,16 +67,7 @@ void AsyncIoEmulator::get(uint32_t& d0, uint32_t& d1, uint32_t& d2) const
 
 void AsyncIoEmulator::poll()
 {
-	if (m_write_done)
-	{
-		m_write_ongoing = false;
-		m_write_done = false;
-		server.onExtendedCommandWriteUpdate<Test4async>();
-	}
-	if (m_read_done)
-	{
-		server.onExtendedCommandReadUpdate<Test4async>();
-	}
+	server.processCompletions();
 }
 
 void AsyncIoEmulator::write_(uint_fast8_t index, uint32_t data)
@@ -98,9 +84,12 @@ void AsyncIoEmulator::write_(uint_fast8_t index, uint32_t data)
 		}
 	}
 	m_d[index] = data;
+	m_write_ongoing = false;
 
+	server.postExtendedCommandWriteUpdate<Test4async>();
+
+	// Only wakes the main loop up, the update itself is passed through the server's completion queue
 	std::lock_guard lock2(m_mutex);
-	m_write_done = true;
 	m_cond.notify_all();
 }
 
@@ -110,8 +99,9 @@ void AsyncIoEmulator::read_(std::stop_token stop_token)
 	{
 		std::this_thread::sleep_for(std::chrono::seconds(3));
 
+		server.postExtendedCommandReadUpdate<Test4async>();
+
 		std::lock_guard lock2(m_mutex);
-		m_read_done = true;
 		m_cond.notify_all();
 	}
 }
@@ -52,11 +52,9 @@ private:
 	uint32_t m_d[3];
 
 	std::atomic_bool  m_write_ongoing;
-	std::atomic_bool  m_write_done;
 	std::atomic_bool  m_write_terminated;
 	std::future<void> m_write_future;
 
-	std::atomic_bool  m_read_done;
 	std::jthread      m_read_thread;
 };
 
@@ -24,21 +24,22 @@
 
 #include "gci.h"
 
+#include <atcmd/server/server_base.h>
+
 uint32_t l_gci;
 
 atcmd::RESULT_CODE Gci::Definition::onWrite(WriteServerHandle server_handle)
 {
 	Parameters parameters(server_handle);
 	l_gci = parameters.getNumeric<CountryCode>();
+	// Shared by all the sessions
+	server_handle.getServer().invalidateAllResponseCaches();
 	return atcmd::RESULT_CODE::OK;
 }
 
 atcmd::RESULT_CODE Gci::Definition::onRead(ReadServerHandle server_handle)
 {
-	// server_handle.makeParameterInformationText(name)
-	// 		.printNumericParameter(m_gci, 16);
-	server_handle.makeParameterInformationText<Parameters>(name)
-			.printNumericParameter<CountryCode>(l_gci);
+	server_handle.printInformationText<Parameters, "+GCI:{}">(l_gci);
 	return atcmd::RESULT_CODE::OK;
 }
 
@@ -42,6 +42,9 @@ struct Gci : public atcmd::server::ExtendedCommand
 
 		using Parameters = ParameterList<CountryCode>;
 
+		// The response is replayed from the cache instead of calling the handler
+		static constexpr uint16_t read_cache_size = 16;
+
 		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle);
 		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle);
 		static const char* onTest(TestServerHandle server_handle);
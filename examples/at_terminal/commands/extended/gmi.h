@@ -36,6 +36,9 @@ struct Gmi : public atcmd::server::ExtendedCommand
 
 		using Parameters = ParameterList<>;
 
+		// The response is replayed from the cache instead of calling the handler
+		static constexpr uint16_t read_cache_size = 48;
+
 		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle);
 	};
 };
@@ -25,44 +25,26 @@
 #include "test4async.h"
 #include "../../asyncioemulator.h"
 
-static uint8_t l_write_index = 0;
-
-atcmd::RESULT_CODE Test4async::Definition::onWrite(WriteServerHandle server_handle)
+atcmd::server::Task Test4async::Definition::onWrite(WriteServerHandle server_handle)
 {
 	Parameters parameters(server_handle);
 	AsyncIoEmulator* io = reinterpret_cast<AsyncIoEmulator*>(server_handle.getContext());
 
-	switch (server_handle.getCallType()) {
-	case WriteServerHandle::CALL_TYPE::REQUEST:
-		l_write_index = 0;
-		io->write(0, parameters.getNumeric<Param0>());
-		return atcmd::RESULT_CODE::ASYNC;
-	case WriteServerHandle::CALL_TYPE::ABORT:
-		io->writeTerminate();
-		return atcmd::RESULT_CODE::ERROR;
-	case WriteServerHandle::CALL_TYPE::RESPONSE:
-		if (l_write_index == 2)
-		{
-			return atcmd::RESULT_CODE::OK;
-		}
-		else
+	const uint32_t values[] = {
+		parameters.getNumeric<Param0>(),
+		parameters.getNumeric<Param1>(),
+		parameters.getNumeric<Param2>()
+	};
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		io->write(i, values[i]);
+		if (!co_await Task::nextResponse())
 		{
-			l_write_index++;
-			switch (l_write_index) {
-			case 1:
-				io->write(1, parameters.getNumeric<Param1>());
-				break;
-			case 2:
-				io->write(2, parameters.getNumeric<Param2>());
-				break;
-			default:
-				break;
-			}
-			return atcmd::RESULT_CODE::ASYNC;
+			io->writeTerminate();
+			co_return atcmd::RESULT_CODE::ERROR;
 		}
-	default:
-		return atcmd::RESULT_CODE::ERROR;
 	}
+	co_return atcmd::RESULT_CODE::OK;
 }
 
 atcmd::RESULT_CODE Test4async::Definition::onRead(ReadServerHandle server_handle)
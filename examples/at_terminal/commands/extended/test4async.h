@@ -30,7 +30,8 @@
 struct Test4async : public atcmd::server::ExtendedCommand
 {
 	// Test command
-	// Accepts 3 decimal integers. Demonstrates asynchronous processing.
+	// Accepts 3 decimal integers. Demonstrates asynchronous processing: the write handler is a coroutine,
+	// the read handler is a state machine.
 	struct Definition
 	{
 		static constexpr char name[] = "TEST4_ASYNC";
@@ -55,7 +56,7 @@ struct Test4async : public atcmd::server::ExtendedCommand
 
 		using Parameters = ParameterList<Param0, Param1, Param2>;
 
-		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle);
+		static Task onWrite(WriteServerHandle server_handle);
 		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle);
 		static const char* onTest(TestServerHandle server_handle);
 	};
@@ -55,6 +55,12 @@ struct ServerSettings
 	>;
 
 	static constexpr std::size_t max_commands_per_line = 3;
+
+	// Asynchronous updates are posted from the I/O threads
+	static constexpr std::size_t completion_queue_size = 8;
+
+	// Frame of the TEST4_ASYNC coroutine write handler
+	static constexpr std::size_t coroutine_frame_size = 256;
 };
 
 extern atcmd::server::Server<ServerSettings> server;
@@ -26,12 +26,14 @@
 #include <zephyr/device.h>
 #include <zephyr/drivers/uart.h>
 
+#include <atcmd/rxring.h>
 #include <atcmd/server/server.h>
 
 #define UART_DEVICE_NODE DT_CHOSEN(zephyr_shell_uart)
 static const struct device *const uart_dev = DEVICE_DT_GET(UART_DEVICE_NODE);
 
-K_PIPE_DEFINE(rx_buf, 100, 1);
+static atcmd::RxRing<128> rx_ring;
+K_SEM_DEFINE(rx_sem, 0, 1);
 
 static void printChar(char ch, void* /*context*/)
 {
@@ -55,11 +57,29 @@ static void usart_irq_cb(const struct device *dev, void *user_data)
 
 	if (uart_irq_rx_ready(dev))
 	{
-		uint8_t data;
-		while (uart_fifo_read(dev, &data, 1))
+		// The FIFO is read straight into the ring
+		while (true)
 		{
-			k_pipe_write(&rx_buf, &data, 1, K_NO_WAIT);
+			std::span<char> span = rx_ring.writeSpan();
+			if (span.empty())
+			{
+				// The ring is full, the FIFO is still emptied and the characters are dropped
+				char ch;
+				if (uart_fifo_read(dev, reinterpret_cast<uint8_t*>(&ch), 1) <= 0)
+				{
+					break;
+				}
+				rx_ring.write(&ch, 1);
+				continue;
+			}
+			int size = uart_fifo_read(dev, reinterpret_cast<uint8_t*>(span.data()), static_cast<int>(span.size()));
+			if (size <= 0)
+			{
+				break;
+			}
+			rx_ring.commit(static_cast<std::size_t>(size));
 		}
+		k_sem_give(&rx_sem);
 	}
 }
 
@@ -70,10 +90,13 @@ int main(void)
 	uart_irq_callback_user_data_set(uart_dev, usart_irq_cb, (void *)uart_dev);
 	uart_irq_rx_enable(uart_dev);
 
-	uint8_t data;
-	while (k_pipe_read(&rx_buf, &data, 1, K_FOREVER))
+	while (true)
 	{
-		server.feed(static_cast<char>(data), false);
+		k_sem_take(&rx_sem, K_FOREVER);
+		rx_ring.drain([](const char* data, std::size_t size)
+		{
+			return server.feed(data, size, false);
+		});
 	}
 
 	return 0;
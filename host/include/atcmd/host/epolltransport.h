@@ -0,0 +1,393 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_EPOLLTRANSPORT_H
+#define ATCMD_EPOLLTRANSPORT_H
+
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <atcmd/server/server.h>
+
+namespace atcmd::host {
+
+namespace detail {
+
+bool setNonBlocking(int fd);
+
+// Creates a pty in raw mode, returns the master side or -1
+int openPty(std::string* slave_name);
+
+// Sets up the eventfd that wakes the loop up from other threads
+int openWakeEvent();
+void signalWakeEvent(int fd);
+void clearWakeEvent(int fd);
+
+} /* namespace detail */
+
+// Single-threaded Linux transport serving a session per endpoint (a pty master or a connected Unix socket).
+// An edge-triggered epoll loop reads into per-endpoint buffers, feeds them to the sessions in blocks and
+// flushes the buffered responses once per iteration
+template<atcmd::server::concepts::ServerSettings Settings, std::size_t input_buffer_size = 512>
+class EpollTransport
+{
+public:
+	using Session = atcmd::server::Session<Settings>;
+
+	EpollTransport() :
+		m_epoll_fd{epoll_create1(EPOLL_CLOEXEC)},
+		m_wake_fd{detail::openWakeEvent()}
+	{
+		if ((m_epoll_fd >= 0) && (m_wake_fd >= 0))
+		{
+			epoll_event event = {};
+			event.events = EPOLLIN | EPOLLET;
+			event.data.u64 = wake_index;
+			epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wake_fd, &event);
+		}
+	}
+
+	~EpollTransport()
+	{
+		for (auto& endpoint : m_endpoints)
+		{
+			if (endpoint->is_open)
+			{
+				close(endpoint->fd);
+			}
+		}
+		if (m_wake_fd >= 0)
+		{
+			close(m_wake_fd);
+		}
+		if (m_epoll_fd >= 0)
+		{
+			close(m_epoll_fd);
+		}
+	}
+
+	EpollTransport(const EpollTransport&) = delete;
+	EpollTransport& operator=(const EpollTransport&) = delete;
+
+	bool isValid() const
+	{
+		return (m_epoll_fd >= 0) && (m_wake_fd >= 0);
+	}
+
+	// Takes over the descriptor, returns the session index or -1
+	int add(int fd, bool is_pty = false)
+	{
+		if (!detail::setNonBlocking(fd))
+		{
+			return -1;
+		}
+		std::size_t index = m_endpoints.size();
+		m_endpoints.push_back(std::make_unique<Endpoint>(fd, is_pty));
+		// Offloaded handlers wake the loop up when they return
+		m_endpoints.back()->session.setWakeCallback(onWake, this);
+
+		epoll_event event = {};
+		event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+		event.data.u64 = index;
+		if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+		{
+			m_endpoints.pop_back();
+			return -1;
+		}
+		// Input may have arrived before the registration
+		activate(index);
+		return static_cast<int>(index);
+	}
+
+	// Creates an emulated port, the slave device name is returned for the peer to open
+	int addPty(std::string* slave_name = nullptr)
+	{
+		int fd = detail::openPty(slave_name);
+		if (fd < 0)
+		{
+			return -1;
+		}
+		int index = add(fd, true);
+		if (index < 0)
+		{
+			close(fd);
+		}
+		return index;
+	}
+
+	std::size_t size() const
+	{
+		return m_endpoints.size();
+	}
+
+	Session& getSession(std::size_t index)
+	{
+		return m_endpoints[index]->session;
+	}
+
+	// False after the peer of a socket has disconnected
+	bool isOpen(std::size_t index) const
+	{
+		return m_endpoints[index]->is_open;
+	}
+
+	// Can be called from any thread, e.g. after posting a completion to a session
+	void wake()
+	{
+		detail::signalWakeEvent(m_wake_fd);
+	}
+
+	// Runs one iteration of the loop: waits up to timeout_ms for events, feeds the received input and flushes
+	// the responses. Returns false if waiting failed
+	bool poll(int timeout_ms)
+	{
+		epoll_event events[max_events];
+		int count = epoll_wait(m_epoll_fd, events, max_events, timeout_ms);
+		if (count < 0)
+		{
+			return errno == EINTR;
+		}
+
+		bool woken = false;
+		for (int i = 0; i < count; i++)
+		{
+			if (events[i].data.u64 == wake_index)
+			{
+				detail::clearWakeEvent(m_wake_fd);
+				woken = true;
+				continue;
+			}
+			Endpoint& endpoint = *m_endpoints[events[i].data.u64];
+			if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+			{
+				endpoint.is_readable = true;
+				activate(events[i].data.u64);
+			}
+			if (events[i].events & EPOLLOUT)
+			{
+				endpoint.is_writable = true;
+			}
+		}
+
+		if constexpr (atcmd::server::concepts::CompletionQueueSettings<Settings>)
+		{
+			if (woken)
+			{
+				for (auto& endpoint : m_endpoints)
+				{
+					endpoint->session.processCompletions();
+				}
+			}
+		}
+
+		// Endpoints blocked by offloaded handlers are retried first to keep their input in order
+		m_active.insert(m_active.begin(), m_blocked.begin(), m_blocked.end());
+		m_blocked.clear();
+		for (std::size_t index : m_active)
+		{
+			m_endpoints[index]->is_active = false;
+			service(index);
+		}
+		m_active.clear();
+
+		// Responses of asynchronous commands may appear in any session
+		for (auto& endpoint : m_endpoints)
+		{
+			if (!endpoint->output.empty())
+			{
+				flush(*endpoint);
+			}
+		}
+		return true;
+	}
+
+private:
+	static constexpr int max_events = 64;
+	static constexpr uint64_t wake_index = ~uint64_t(0);
+
+	struct Endpoint
+	{
+		Endpoint(int fd, bool is_pty) :
+			fd{fd},
+			is_pty{is_pty},
+			session{printChar, this}
+		{
+			session.setPrintTextCallback(printText);
+		}
+
+		int fd;
+		bool is_pty;
+		bool is_open = true;
+		bool is_readable = true;
+		bool is_writable = true;
+		bool is_active = false;
+		bool is_blocked = false;
+
+		std::size_t input_offset = 0;
+		std::size_t input_size = 0;
+		char input[input_buffer_size];
+
+		std::string output;
+
+		Session session;
+	};
+
+	static void onWake(void* context)
+	{
+		static_cast<EpollTransport*>(context)->wake();
+	}
+
+	static void printChar(char ch, void* context)
+	{
+		static_cast<Endpoint*>(context)->output += ch;
+	}
+
+	static void printText(const char* text, std::size_t size, void* context)
+	{
+		static_cast<Endpoint*>(context)->output.append(text, size);
+	}
+
+	void activate(std::size_t index)
+	{
+		Endpoint& endpoint = *m_endpoints[index];
+		if (!endpoint.is_active && !endpoint.is_blocked)
+		{
+			endpoint.is_active = true;
+			m_active.push_back(index);
+		}
+	}
+
+	// Reads until the socket is drained, as required by the edge-triggered mode
+	void service(std::size_t index)
+	{
+		Endpoint& endpoint = *m_endpoints[index];
+		endpoint.is_blocked = false;
+		while (endpoint.is_open)
+		{
+			if (endpoint.input_size != 0)
+			{
+				std::size_t consumed = endpoint.session.feed(
+						endpoint.input + endpoint.input_offset, endpoint.input_size, true);
+				endpoint.input_offset += consumed;
+				endpoint.input_size -= consumed;
+				if (endpoint.input_size != 0)
+				{
+					endpoint.is_blocked = true;
+					m_blocked.push_back(index);
+					return;
+				}
+			}
+			if (!endpoint.is_readable)
+			{
+				return;
+			}
+
+			ssize_t size = read(endpoint.fd, endpoint.input, input_buffer_size);
+			if (size > 0)
+			{
+				endpoint.input_offset = 0;
+				endpoint.input_size = static_cast<std::size_t>(size);
+				continue;
+			}
+			if ((size < 0) && (errno == EINTR))
+			{
+				continue;
+			}
+			endpoint.is_readable = false;
+			if ((size < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+			{
+				return;
+			}
+			if (endpoint.is_pty)
+			{
+				// EIO while no process has the slave side open, the port stays available
+				return;
+			}
+			closeEndpoint(endpoint);
+		}
+	}
+
+	void flush(Endpoint& endpoint)
+	{
+		std::size_t offset = 0;
+		while (endpoint.is_open && endpoint.is_writable && (offset != endpoint.output.size()))
+		{
+			ssize_t size = write(endpoint.fd, endpoint.output.data() + offset, endpoint.output.size() - offset);
+			if (size > 0)
+			{
+				offset += static_cast<std::size_t>(size);
+			}
+			else if ((size < 0) && (errno == EINTR))
+			{
+				continue;
+			}
+			else if ((size < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+			{
+				// EPOLLOUT resumes the flush
+				endpoint.is_writable = false;
+			}
+			else if (endpoint.is_pty)
+			{
+				// Nobody reads the slave side, the responses are discarded
+				offset = endpoint.output.size();
+			}
+			else
+			{
+				closeEndpoint(endpoint);
+			}
+		}
+		if (!endpoint.is_open)
+		{
+			endpoint.output.clear();
+		}
+		else
+		{
+			endpoint.output.erase(0, offset);
+		}
+	}
+
+	void closeEndpoint(Endpoint& endpoint)
+	{
+		epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, endpoint.fd, nullptr);
+		close(endpoint.fd);
+		endpoint.is_open = false;
+		endpoint.input_size = 0;
+	}
+
+	int m_epoll_fd;
+	int m_wake_fd;
+	std::vector<std::unique_ptr<Endpoint>> m_endpoints;
+	std::vector<std::size_t> m_active;
+	std::vector<std::size_t> m_blocked;
+};
+
+} /* namespace atcmd::host */
+
+#endif // ATCMD_EPOLLTRANSPORT_H
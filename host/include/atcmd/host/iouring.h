@@ -0,0 +1,97 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_IOURING_H
+#define ATCMD_IOURING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <linux/io_uring.h>
+
+namespace atcmd::host::detail {
+
+// Minimal io_uring wrapper over the raw system calls: a submission and a completion queue and a registered
+// ring of provided buffers. Single-threaded, every io_uring_enter() is counted for benchmarking
+class IoUring
+{
+public:
+	explicit IoUring(unsigned entries);
+	~IoUring();
+
+	IoUring(const IoUring&) = delete;
+	IoUring& operator=(const IoUring&) = delete;
+
+	bool isValid() const;
+
+	// A cleared entry, nullptr if the submission queue is full
+	io_uring_sqe* getSqe();
+
+	// Submits the queued entries and waits up to timeout_ms for a completion in a single system call.
+	// A negative timeout waits forever, zero does not wait
+	int submitAndWait(int timeout_ms);
+
+	bool popCqe(io_uring_cqe& cqe);
+
+	// Buffers the kernel picks from for the reads with IOSQE_BUFFER_SELECT, count must be a power of two
+	bool registerBufferRing(uint16_t group, uint32_t buffer_size, uint16_t buffer_count);
+	char* getBuffer(uint16_t id) const;
+	void returnBuffer(uint16_t id);
+
+	uint64_t getEnterCount() const;
+
+private:
+	int m_fd;
+
+	void* m_sq_ring;
+	std::size_t m_sq_ring_size;
+	unsigned* m_sq_head;
+	unsigned* m_sq_tail;
+	unsigned* m_sq_array;
+	unsigned m_sq_mask;
+	unsigned m_sq_entries;
+	unsigned m_sq_local_tail;
+	io_uring_sqe* m_sqes;
+	std::size_t m_sqes_size;
+
+	void* m_cq_ring;
+	std::size_t m_cq_ring_size;
+	unsigned* m_cq_head;
+	unsigned* m_cq_tail;
+	io_uring_cqe* m_cqes;
+	unsigned m_cq_mask;
+
+	io_uring_buf* m_buf_ring;
+	std::size_t m_buf_ring_size;
+	char* m_buffers;
+	uint32_t m_buffer_size;
+	uint16_t m_buffer_mask;
+	uint16_t m_buffer_tail;
+
+	uint64_t m_enter_count;
+};
+
+} /* namespace atcmd::host::detail */
+
+#endif // ATCMD_IOURING_H
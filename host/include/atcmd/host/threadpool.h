@@ -0,0 +1,86 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_THREADPOOL_H
+#define ATCMD_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace atcmd::host {
+
+// Work-stealing thread pool for offloadable command handlers. Every worker owns a job deque: it takes
+// its own jobs from the back and steals the oldest jobs of the others from the front when it runs out.
+// The destructor runs the jobs still queued, including the ones they submit, before joining the workers
+class ThreadPool
+{
+public:
+	explicit ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency());
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void submit(void (*job)(void* arg), void* arg);
+
+	// Matches atcmd::ExecuteCallback, context is the pool:
+	// server.setExecutor(atcmd::host::ThreadPool::execute, &pool)
+	static void execute(void (*job)(void* arg), void* arg, void* context);
+
+private:
+	struct Job
+	{
+		void (*job)(void* arg);
+		void* arg;
+	};
+
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	bool pop(std::size_t index, Job& job);
+	bool steal(std::size_t index, Job& job);
+	void run(std::stop_token stop_token, std::size_t index);
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::atomic<std::size_t> m_next_worker;
+
+	std::mutex m_mutex;
+	std::condition_variable_any m_cond;
+	std::atomic<std::size_t> m_pending;
+
+	std::vector<std::jthread> m_threads;
+};
+
+} /* namespace atcmd::host */
+
+#endif // ATCMD_THREADPOOL_H
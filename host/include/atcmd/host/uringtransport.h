@@ -0,0 +1,498 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_URINGTRANSPORT_H
+#define ATCMD_URINGTRANSPORT_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atcmd/host/epolltransport.h>
+#include <atcmd/host/iouring.h>
+#include <atcmd/server/server.h>
+
+namespace atcmd::host {
+
+// Single-threaded Linux transport built on io_uring, a drop-in alternative to EpollTransport.
+// Sockets are read with a multishot receive and ptys with re-armed reads, both picking buffers from a registered
+// ring which are fed to the sessions in place. The responses are written with one request per endpoint and
+// submitted together with the wait for the next completions, so an iteration costs a single system call
+template<atcmd::server::concepts::ServerSettings Settings, std::size_t buffer_size = 512,
+		uint16_t buffer_count = 64, unsigned queue_depth = 256>
+class UringTransport
+{
+	static_assert((buffer_count != 0) && ((buffer_count & (buffer_count - 1)) == 0),
+			"The buffer count must be a power of two");
+
+public:
+	using Session = atcmd::server::Session<Settings>;
+
+	UringTransport() :
+		m_ring{queue_depth},
+		m_wake_fd{detail::openWakeEvent()},
+		m_wake_value{0},
+		m_wake_armed{false},
+		m_has_buffers{m_ring.isValid() && m_ring.registerBufferRing(buffer_group, buffer_size, buffer_count)},
+		m_buffers_held{0},
+		m_hung_up{0}
+	{
+	}
+
+	~UringTransport()
+	{
+		for (auto& endpoint : m_endpoints)
+		{
+			if (endpoint->is_open)
+			{
+				close(endpoint->fd);
+			}
+		}
+		if (m_wake_fd >= 0)
+		{
+			close(m_wake_fd);
+		}
+	}
+
+	UringTransport(const UringTransport&) = delete;
+	UringTransport& operator=(const UringTransport&) = delete;
+
+	bool isValid() const
+	{
+		return m_has_buffers && (m_wake_fd >= 0);
+	}
+
+	// Takes over the descriptor, returns the session index or -1
+	int add(int fd, bool is_pty = false)
+	{
+		// Blocking descriptors let io_uring wait for readiness instead of failing with EAGAIN
+		int flags = fcntl(fd, F_GETFL);
+		if ((flags < 0) || (fcntl(fd, F_SETFL, flags & ~O_NONBLOCK) != 0))
+		{
+			return -1;
+		}
+		std::size_t index = m_endpoints.size();
+		m_endpoints.push_back(std::make_unique<Endpoint>(fd, is_pty));
+		// Offloaded handlers wake the loop up when they return
+		m_endpoints.back()->session.setWakeCallback(onWake, this);
+		return static_cast<int>(index);
+	}
+
+	// Creates an emulated port, the slave device name is returned for the peer to open
+	int addPty(std::string* slave_name = nullptr)
+	{
+		int fd = detail::openPty(slave_name);
+		if (fd < 0)
+		{
+			return -1;
+		}
+		int index = add(fd, true);
+		if (index < 0)
+		{
+			close(fd);
+		}
+		return index;
+	}
+
+	std::size_t size() const
+	{
+		return m_endpoints.size();
+	}
+
+	Session& getSession(std::size_t index)
+	{
+		return m_endpoints[index]->session;
+	}
+
+	// False after the peer of a socket has disconnected
+	bool isOpen(std::size_t index) const
+	{
+		return m_endpoints[index]->is_open;
+	}
+
+	// Can be called from any thread, e.g. after posting a completion to a session
+	void wake()
+	{
+		detail::signalWakeEvent(m_wake_fd);
+	}
+
+	// Number of io_uring_enter() calls made so far
+	uint64_t getSyscallCount() const
+	{
+		return m_ring.getEnterCount();
+	}
+
+	// Runs one iteration of the loop: submits the pending reads and writes, waits up to timeout_ms for
+	// completions, feeds the received input and queues the responses. Returns false if waiting failed
+	bool poll(int timeout_ms)
+	{
+		if ((m_hung_up != 0) && ((timeout_ms < 0) || (timeout_ms > retry_timeout_ms)))
+		{
+			// Ports without a peer are retried by reading again
+			timeout_ms = retry_timeout_ms;
+		}
+		armReads();
+
+		if (m_ring.submitAndWait(timeout_ms) < 0)
+		{
+			return errno == EINTR;
+		}
+
+		bool woken = false;
+		bool completed = false;
+		io_uring_cqe cqe;
+		while (m_ring.popCqe(cqe))
+		{
+			completed = true;
+			if (cqe.user_data == wake_tag)
+			{
+				m_wake_armed = false;
+				woken = true;
+				continue;
+			}
+			if (cqe.user_data == cancel_tag)
+			{
+				continue;
+			}
+			std::size_t index = static_cast<std::size_t>(cqe.user_data >> 1);
+			if (cqe.user_data & write_tag)
+			{
+				onWrite(*m_endpoints[index], cqe.res);
+			}
+			else
+			{
+				onRead(index, cqe);
+			}
+		}
+		if (!completed && (m_hung_up != 0))
+		{
+			// Reading a port without a peer fails right away, it is retried only once the loop is idle
+			for (auto& endpoint : m_endpoints)
+			{
+				endpoint->is_hung_up = false;
+			}
+			m_hung_up = 0;
+		}
+
+		if constexpr (atcmd::server::concepts::CompletionQueueSettings<Settings>)
+		{
+			if (woken)
+			{
+				for (auto& endpoint : m_endpoints)
+				{
+					endpoint->session.processCompletions();
+				}
+			}
+		}
+
+		std::vector<std::size_t> blocked;
+		blocked.swap(m_blocked);
+		for (std::size_t index : blocked)
+		{
+			feedPending(index);
+		}
+
+		// Responses of asynchronous commands may appear in any session
+		for (std::size_t index = 0; index < m_endpoints.size(); index++)
+		{
+			queueWrite(index);
+		}
+		return true;
+	}
+
+private:
+	static constexpr uint16_t buffer_group = 0;
+	static constexpr uint64_t write_tag = 1;
+	static constexpr uint64_t wake_tag = ~uint64_t(0);
+	static constexpr uint64_t cancel_tag = ~uint64_t(1);
+	static constexpr int retry_timeout_ms = 1;
+
+	struct Input
+	{
+		uint16_t id;
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	struct Endpoint
+	{
+		Endpoint(int fd, bool is_pty) :
+			fd{fd},
+			is_pty{is_pty},
+			session{printChar, this}
+		{
+			session.setPrintTextCallback(printText);
+		}
+
+		int fd;
+		bool is_pty;
+		bool is_open = true;
+		bool is_read_armed = false;
+		bool is_read_cancelled = false;
+		bool is_hung_up = false;
+		bool is_write_in_flight = false;
+
+		// Ring buffers holding input not consumed yet, returned after being fed
+		std::deque<Input> input;
+
+		// Collects the responses while the previous ones are being written
+		std::string output;
+		std::string writing;
+		std::size_t written = 0;
+
+		Session session;
+	};
+
+	static void onWake(void* context)
+	{
+		static_cast<UringTransport*>(context)->wake();
+	}
+
+	static void printChar(char ch, void* context)
+	{
+		static_cast<Endpoint*>(context)->output += ch;
+	}
+
+	static void printText(const char* text, std::size_t size, void* context)
+	{
+		static_cast<Endpoint*>(context)->output.append(text, size);
+	}
+
+	void armReads()
+	{
+		if (!m_wake_armed)
+		{
+			if (io_uring_sqe* sqe = m_ring.getSqe())
+			{
+				sqe->opcode = IORING_OP_READ;
+				sqe->fd = m_wake_fd;
+				sqe->addr = reinterpret_cast<uint64_t>(&m_wake_value);
+				sqe->len = sizeof(m_wake_value);
+				sqe->user_data = wake_tag;
+				m_wake_armed = true;
+			}
+		}
+
+		// Without free buffers a read would fail with ENOBUFS right away
+		if (m_buffers_held == buffer_count)
+		{
+			return;
+		}
+		for (std::size_t index = 0; index < m_endpoints.size(); index++)
+		{
+			Endpoint& endpoint = *m_endpoints[index];
+			// A blocked session takes no more buffers until its input is fed
+			if (!endpoint.is_open || endpoint.is_read_armed || endpoint.is_hung_up || !endpoint.input.empty())
+			{
+				continue;
+			}
+			io_uring_sqe* sqe = m_ring.getSqe();
+			if (sqe == nullptr)
+			{
+				return;
+			}
+			if (endpoint.is_pty)
+			{
+				sqe->opcode = IORING_OP_READ;
+				sqe->len = buffer_size;
+				sqe->off = ~uint64_t(0);
+			}
+			else
+			{
+				sqe->opcode = IORING_OP_RECV;
+				sqe->ioprio = IORING_RECV_MULTISHOT;
+			}
+			sqe->fd = endpoint.fd;
+			sqe->flags = IOSQE_BUFFER_SELECT;
+			sqe->buf_group = buffer_group;
+			sqe->user_data = index << 1;
+			endpoint.is_read_armed = true;
+		}
+	}
+
+	void onRead(std::size_t index, const io_uring_cqe& cqe)
+	{
+		Endpoint& endpoint = *m_endpoints[index];
+		if (!(cqe.flags & IORING_CQE_F_MORE))
+		{
+			endpoint.is_read_armed = false;
+			endpoint.is_read_cancelled = false;
+		}
+		if (cqe.res > 0)
+		{
+			uint16_t id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+			if (!endpoint.is_open)
+			{
+				m_ring.returnBuffer(id);
+				return;
+			}
+			m_buffers_held++;
+			endpoint.input.push_back({id, 0, static_cast<uint32_t>(cqe.res)});
+			if (endpoint.input.size() == 1)
+			{
+				feedPending(index);
+			}
+			return;
+		}
+		if (!endpoint.is_open || (cqe.res == -ENOBUFS) || (cqe.res == -EINTR) || (cqe.res == -EAGAIN) ||
+			(cqe.res == -ECANCELED))
+		{
+			// Re-armed by the next iteration
+			return;
+		}
+		if (endpoint.is_pty)
+		{
+			// EIO while no process has the slave side open, the port stays available
+			endpoint.is_hung_up = true;
+			m_hung_up++;
+			return;
+		}
+		closeEndpoint(index);
+	}
+
+	void feedPending(std::size_t index)
+	{
+		Endpoint& endpoint = *m_endpoints[index];
+		while (endpoint.is_open && !endpoint.input.empty())
+		{
+			Input& input = endpoint.input.front();
+			std::size_t consumed = endpoint.session.feed(m_ring.getBuffer(input.id) + input.offset, input.size, true);
+			input.offset += static_cast<uint32_t>(consumed);
+			input.size -= static_cast<uint32_t>(consumed);
+			if (input.size != 0)
+			{
+				// The rest waits for the session, e.g. for an offloaded handler, without holding up the others
+				m_blocked.push_back(index);
+				cancelRead(index);
+				return;
+			}
+			m_ring.returnBuffer(input.id);
+			m_buffers_held--;
+			endpoint.input.pop_front();
+		}
+	}
+
+	// A multishot receive keeps taking buffers and holds the socket until cancelled
+	void cancelRead(std::size_t index)
+	{
+		Endpoint& endpoint = *m_endpoints[index];
+		if (!endpoint.is_read_armed || endpoint.is_read_cancelled)
+		{
+			return;
+		}
+		if (io_uring_sqe* sqe = m_ring.getSqe())
+		{
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->fd = -1;
+			sqe->addr = index << 1;
+			sqe->user_data = cancel_tag;
+			endpoint.is_read_cancelled = true;
+		}
+	}
+
+	void onWrite(Endpoint& endpoint, int32_t res)
+	{
+		endpoint.is_write_in_flight = false;
+		if (res > 0)
+		{
+			endpoint.written += static_cast<std::size_t>(res);
+		}
+		else if ((res != -EINTR) && (res != -EAGAIN))
+		{
+			// A closed socket or nobody reading the slave side of a pty, the responses are discarded
+			endpoint.written = endpoint.writing.size();
+		}
+		if (endpoint.written == endpoint.writing.size())
+		{
+			endpoint.writing.clear();
+			endpoint.written = 0;
+		}
+	}
+
+	// Prepares the write, it is submitted with the next wait
+	void queueWrite(std::size_t index)
+	{
+		Endpoint& endpoint = *m_endpoints[index];
+		if (!endpoint.is_open || endpoint.is_write_in_flight)
+		{
+			return;
+		}
+		if (endpoint.writing.empty())
+		{
+			if (endpoint.output.empty())
+			{
+				return;
+			}
+			endpoint.writing.swap(endpoint.output);
+		}
+		io_uring_sqe* sqe = m_ring.getSqe();
+		if (sqe == nullptr)
+		{
+			return;
+		}
+		sqe->opcode = IORING_OP_WRITE;
+		sqe->fd = endpoint.fd;
+		sqe->addr = reinterpret_cast<uint64_t>(endpoint.writing.data() + endpoint.written);
+		sqe->len = static_cast<uint32_t>(endpoint.writing.size() - endpoint.written);
+		sqe->off = ~uint64_t(0);
+		sqe->user_data = (index << 1) | write_tag;
+		endpoint.is_write_in_flight = true;
+	}
+
+	void closeEndpoint(std::size_t index)
+	{
+		Endpoint& endpoint = *m_endpoints[index];
+		cancelRead(index);
+		close(endpoint.fd);
+		endpoint.is_open = false;
+		for (const Input& input : endpoint.input)
+		{
+			m_ring.returnBuffer(input.id);
+			m_buffers_held--;
+		}
+		endpoint.input.clear();
+		endpoint.output.clear();
+	}
+
+	detail::IoUring m_ring;
+	int m_wake_fd;
+	uint64_t m_wake_value;
+	bool m_wake_armed;
+	bool m_has_buffers;
+	uint16_t m_buffers_held;
+	unsigned m_hung_up;
+	std::vector<std::unique_ptr<Endpoint>> m_endpoints;
+	std::vector<std::size_t> m_blocked;
+};
+
+} /* namespace atcmd::host */
+
+#endif // ATCMD_URINGTRANSPORT_H
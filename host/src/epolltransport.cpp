@@ -0,0 +1,91 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <atcmd/host/epolltransport.h>
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <termios.h>
+
+namespace atcmd::host::detail {
+
+bool setNonBlocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL);
+	return (flags >= 0) && (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0);
+}
+
+int openPty(std::string* slave_name)
+{
+	int fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	char name[64];
+	termios attributes;
+	if ((grantpt(fd) != 0) || (unlockpt(fd) != 0) || (ptsname_r(fd, name, sizeof(name)) != 0) ||
+			(tcgetattr(fd, &attributes) != 0))
+	{
+		close(fd);
+		return -1;
+	}
+
+	// No echo and no line editing, the server sees the bytes as they were written
+	cfmakeraw(&attributes);
+	if (tcsetattr(fd, TCSANOW, &attributes) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	if (slave_name != nullptr)
+	{
+		*slave_name = name;
+	}
+	return fd;
+}
+
+int openWakeEvent()
+{
+	return eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+void signalWakeEvent(int fd)
+{
+	uint64_t value = 1;
+	[[maybe_unused]] ssize_t r = write(fd, &value, sizeof(value));
+}
+
+void clearWakeEvent(int fd)
+{
+	uint64_t value;
+	[[maybe_unused]] ssize_t r = read(fd, &value, sizeof(value));
+}
+
+} /* namespace atcmd::host::detail */
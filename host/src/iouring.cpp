@@ -0,0 +1,279 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <atcmd/host/iouring.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace atcmd::host::detail {
+
+namespace {
+
+unsigned loadAcquire(unsigned* p)
+{
+	return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire);
+}
+
+void storeRelease(unsigned* p, unsigned value)
+{
+	std::atomic_ref<unsigned>(*p).store(value, std::memory_order_release);
+}
+
+void* mapRing(int fd, std::size_t size, off_t offset)
+{
+	void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+	return p == MAP_FAILED ? nullptr : p;
+}
+
+} /* anonymous namespace */
+
+IoUring::IoUring(unsigned entries) :
+	m_fd{-1},
+	m_sq_ring{nullptr},
+	m_sq_ring_size{0},
+	m_sq_head{nullptr},
+	m_sq_tail{nullptr},
+	m_sq_array{nullptr},
+	m_sq_mask{0},
+	m_sq_entries{0},
+	m_sq_local_tail{0},
+	m_sqes{nullptr},
+	m_sqes_size{0},
+	m_cq_ring{nullptr},
+	m_cq_ring_size{0},
+	m_cq_head{nullptr},
+	m_cq_tail{nullptr},
+	m_cqes{nullptr},
+	m_cq_mask{0},
+	m_buf_ring{nullptr},
+	m_buf_ring_size{0},
+	m_buffers{nullptr},
+	m_buffer_size{0},
+	m_buffer_mask{0},
+	m_buffer_tail{0},
+	m_enter_count{0}
+{
+	io_uring_params params = {};
+	m_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+	if (m_fd < 0)
+	{
+		return;
+	}
+
+	m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+	}
+
+	m_sq_ring = mapRing(m_fd, m_sq_ring_size, IORING_OFF_SQ_RING);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		m_cq_ring = m_sq_ring;
+	}
+	else
+	{
+		m_cq_ring = mapRing(m_fd, m_cq_ring_size, IORING_OFF_CQ_RING);
+	}
+	m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+	m_sqes = static_cast<io_uring_sqe*>(mapRing(m_fd, m_sqes_size, IORING_OFF_SQES));
+	if ((m_sq_ring == nullptr) || (m_cq_ring == nullptr) || (m_sqes == nullptr))
+	{
+		close(m_fd);
+		m_fd = -1;
+		return;
+	}
+
+	char* sq = static_cast<char*>(m_sq_ring);
+	m_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+	m_sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	m_sq_entries = params.sq_entries;
+	m_sq_local_tail = *m_sq_tail;
+
+	char* cq = static_cast<char*>(m_cq_ring);
+	m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+	m_cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+}
+
+IoUring::~IoUring()
+{
+	if (m_buf_ring != nullptr)
+	{
+		munmap(m_buf_ring, m_buf_ring_size);
+		delete[] m_buffers;
+	}
+	if (m_sqes != nullptr)
+	{
+		munmap(m_sqes, m_sqes_size);
+	}
+	if ((m_cq_ring != nullptr) && (m_cq_ring != m_sq_ring))
+	{
+		munmap(m_cq_ring, m_cq_ring_size);
+	}
+	if (m_sq_ring != nullptr)
+	{
+		munmap(m_sq_ring, m_sq_ring_size);
+	}
+	if (m_fd >= 0)
+	{
+		close(m_fd);
+	}
+}
+
+bool IoUring::isValid() const
+{
+	return m_fd >= 0;
+}
+
+io_uring_sqe* IoUring::getSqe()
+{
+	if (m_sq_local_tail - loadAcquire(m_sq_head) >= m_sq_entries)
+	{
+		return nullptr;
+	}
+	unsigned index = m_sq_local_tail & m_sq_mask;
+	m_sq_array[index] = index;
+	m_sq_local_tail++;
+	io_uring_sqe* sqe = &m_sqes[index];
+	std::memset(sqe, 0, sizeof(*sqe));
+	return sqe;
+}
+
+int IoUring::submitAndWait(int timeout_ms)
+{
+	unsigned to_submit = m_sq_local_tail - *m_sq_tail;
+	storeRelease(m_sq_tail, m_sq_local_tail);
+
+	unsigned flags = 0;
+	unsigned min_complete = 0;
+	io_uring_getevents_arg arg = {};
+	__kernel_timespec timeout = {};
+	if (timeout_ms != 0)
+	{
+		flags |= IORING_ENTER_GETEVENTS;
+		min_complete = 1;
+		if (timeout_ms > 0)
+		{
+			timeout.tv_sec = timeout_ms / 1000;
+			timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+			flags |= IORING_ENTER_EXT_ARG;
+			arg.ts = reinterpret_cast<uint64_t>(&timeout);
+		}
+	}
+	else if (to_submit == 0)
+	{
+		return 0;
+	}
+
+	m_enter_count++;
+	int r = static_cast<int>(syscall(__NR_io_uring_enter, m_fd, to_submit, min_complete, flags,
+			(flags & IORING_ENTER_EXT_ARG) ? static_cast<void*>(&arg) : nullptr,
+			(flags & IORING_ENTER_EXT_ARG) ? sizeof(arg) : 0));
+	if ((r < 0) && ((errno == ETIME) || (errno == EINTR)))
+	{
+		return 0;
+	}
+	return r;
+}
+
+bool IoUring::popCqe(io_uring_cqe& cqe)
+{
+	unsigned head = *m_cq_head;
+	if (head == loadAcquire(m_cq_tail))
+	{
+		return false;
+	}
+	cqe = m_cqes[head & m_cq_mask];
+	storeRelease(m_cq_head, head + 1);
+	return true;
+}
+
+bool IoUring::registerBufferRing(uint16_t group, uint32_t buffer_size, uint16_t buffer_count)
+{
+	m_buf_ring_size = buffer_count * sizeof(io_uring_buf);
+	void* ring = mmap(nullptr, m_buf_ring_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+	if (ring == MAP_FAILED)
+	{
+		return false;
+	}
+	m_buf_ring = static_cast<io_uring_buf*>(ring);
+
+	io_uring_buf_reg reg = {};
+	reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+	reg.ring_entries = buffer_count;
+	reg.bgid = group;
+	if (syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0)
+	{
+		munmap(ring, m_buf_ring_size);
+		m_buf_ring = nullptr;
+		return false;
+	}
+
+	m_buffers = new char[static_cast<std::size_t>(buffer_size) * buffer_count];
+	m_buffer_size = buffer_size;
+	m_buffer_mask = buffer_count - 1;
+	m_buffer_tail = 0;
+	for (uint16_t i = 0; i < buffer_count; i++)
+	{
+		returnBuffer(i);
+	}
+	return true;
+}
+
+char* IoUring::getBuffer(uint16_t id) const
+{
+	return m_buffers + static_cast<std::size_t>(id) * m_buffer_size;
+}
+
+void IoUring::returnBuffer(uint16_t id)
+{
+	// The ring is indexed directly, the flexible array of io_uring_buf_ring gets an offset in C++. The tail
+	// overlays the reserved field of the first entry
+	io_uring_buf& buf = m_buf_ring[m_buffer_tail & m_buffer_mask];
+	buf.addr = reinterpret_cast<uint64_t>(getBuffer(id));
+	buf.len = m_buffer_size;
+	buf.bid = id;
+	m_buffer_tail++;
+	std::atomic_ref<uint16_t>(m_buf_ring[0].resv).store(m_buffer_tail, std::memory_order_release);
+}
+
+uint64_t IoUring::getEnterCount() const
+{
+	return m_enter_count;
+}
+
+} /* namespace atcmd::host::detail */
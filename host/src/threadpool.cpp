@@ -0,0 +1,157 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <atcmd/host/threadpool.h>
+
+#include <functional>
+
+namespace atcmd::host {
+
+namespace {
+
+// Index of the pool worker the calling thread belongs to, jobs submitted from a handler stay on its own deque
+thread_local const ThreadPool* l_pool = nullptr;
+thread_local std::size_t l_worker_index = 0;
+
+} /* anonymous namespace */
+
+ThreadPool::ThreadPool(std::size_t thread_count) :
+	m_next_worker(0),
+	m_pending(0)
+{
+	if (thread_count == 0)
+	{
+		thread_count = 1;
+	}
+	m_workers.reserve(thread_count);
+	for (std::size_t i = 0; i < thread_count; i++)
+	{
+		m_workers.push_back(std::make_unique<Worker>());
+	}
+	m_threads.reserve(thread_count);
+	for (std::size_t i = 0; i < thread_count; i++)
+	{
+		m_threads.emplace_back(std::bind_front(&ThreadPool::run, this), i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	for (auto& thread : m_threads)
+	{
+		thread.request_stop();
+	}
+	{
+		std::lock_guard lock(m_mutex);
+	}
+	m_cond.notify_all();
+	m_threads.clear();
+}
+
+void ThreadPool::submit(void (*job)(void* arg), void* arg)
+{
+	std::size_t index;
+	if (l_pool == this)
+	{
+		index = l_worker_index;
+	}
+	else
+	{
+		index = m_next_worker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+	}
+	{
+		std::lock_guard lock(m_workers[index]->mutex);
+		m_workers[index]->jobs.push_back(Job{job, arg});
+	}
+	{
+		std::lock_guard lock(m_mutex);
+		m_pending.fetch_add(1, std::memory_order_relaxed);
+	}
+	m_cond.notify_one();
+}
+
+void ThreadPool::execute(void (*job)(void* arg), void* arg, void* context)
+{
+	static_cast<ThreadPool*>(context)->submit(job, arg);
+}
+
+bool ThreadPool::pop(std::size_t index, Job& job)
+{
+	Worker& worker = *m_workers[index];
+	std::lock_guard lock(worker.mutex);
+	if (worker.jobs.empty())
+	{
+		return false;
+	}
+	job = worker.jobs.back();
+	worker.jobs.pop_back();
+	return true;
+}
+
+bool ThreadPool::steal(std::size_t index, Job& job)
+{
+	for (std::size_t i = 1; i < m_workers.size(); i++)
+	{
+		Worker& victim = *m_workers[(index + i) % m_workers.size()];
+		std::unique_lock lock(victim.mutex, std::try_to_lock);
+		if (!lock.owns_lock() || victim.jobs.empty())
+		{
+			continue;
+		}
+		job = victim.jobs.front();
+		victim.jobs.pop_front();
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::run(std::stop_token stop_token, std::size_t index)
+{
+	l_pool = this;
+	l_worker_index = index;
+
+	while (true)
+	{
+		Job job;
+		if (pop(index, job) || steal(index, job))
+		{
+			m_pending.fetch_sub(1, std::memory_order_relaxed);
+			job.job(job.arg);
+			continue;
+		}
+
+		// The queued jobs are run before stopping, an offloaded server waits for the completion of its job
+		if (stop_token.stop_requested() && (m_pending.load(std::memory_order_relaxed) == 0))
+		{
+			return;
+		}
+
+		std::unique_lock lock(m_mutex);
+		m_cond.wait(lock, stop_token, [this] {
+			return m_pending.load(std::memory_order_relaxed) != 0;
+		});
+	}
+}
+
+} /* namespace atcmd::host */
@@ -0,0 +1,644 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_CMUX_H
+#define ATCMD_CMUX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include <atcmd/server/server.h>
+
+namespace atcmd {
+
+namespace detail {
+
+// 3GPP TS 27.010 basic option framing
+class CmuxCodec
+{
+public:
+	static constexpr uint8_t flag = 0xF9;
+
+	// Address and length octets
+	static constexpr uint8_t ea = 0x01;
+	static constexpr uint8_t cr = 0x02;
+
+	// Control field, the P/F bit cleared
+	static constexpr uint8_t pf = 0x10;
+	static constexpr uint8_t sabm = 0x2F;
+	static constexpr uint8_t ua = 0x63;
+	static constexpr uint8_t dm = 0x0F;
+	static constexpr uint8_t disc = 0x43;
+	static constexpr uint8_t uih = 0xEF;
+	static constexpr uint8_t ui = 0x03;
+
+	// Control channel message types, the C/R and EA bits cleared
+	static constexpr uint8_t pn = 0x80;
+	static constexpr uint8_t cld = 0xC0;
+	static constexpr uint8_t test = 0x20;
+	static constexpr uint8_t fcon = 0xA0;
+	static constexpr uint8_t fcoff = 0x60;
+	static constexpr uint8_t msc = 0xE0;
+	static constexpr uint8_t nsc = 0x10;
+
+	// V.24 signals of a modem status command
+	static constexpr uint8_t v24_fc = 0x02;
+	static constexpr uint8_t v24_rtc = 0x04;
+	static constexpr uint8_t v24_rtr = 0x08;
+
+	static constexpr uint16_t max_info_size = 0x7FFF;
+	// Flags, address, control, two length octets and the FCS
+	static constexpr std::size_t max_overhead = 7;
+	// Remainder of the CRC over a frame and its FCS
+	static constexpr uint8_t good_crc = 0xCF;
+
+	static constexpr uint8_t makeAddress(uint8_t dlci, bool cr_bit)
+	{
+		return static_cast<uint8_t>((dlci << 2) | (cr_bit ? cr : 0) | ea);
+	}
+
+	// CRC-8 with the reflected polynomial x^8 + x^2 + x + 1, a byte per table lookup
+	static uint8_t updateCrc(uint8_t crc, const uint8_t* data, std::size_t size);
+
+	// Writes a complete frame to dest, which must hold size + max_overhead bytes. Returns the frame size
+	static std::size_t encode(uint8_t* dest, uint8_t address, uint8_t control, const uint8_t* info, std::size_t size);
+};
+
+struct CmuxFrame
+{
+	uint8_t address;
+	uint8_t control;
+	std::span<const uint8_t> info;
+};
+
+// Finds frames in the received stream. Information fields are copied to the given buffer in runs,
+// frames with a bad FCS or not fitting the buffer are discarded and the decoder hunts for the next flag
+class CmuxDecoder
+{
+public:
+	CmuxDecoder(uint8_t* buffer, uint16_t capacity);
+
+	// Consumes data up to the end of the next valid frame, returns the number of bytes consumed.
+	// hasFrame() tells whether a frame ended there
+	std::size_t feed(const uint8_t* data, std::size_t size);
+
+	bool hasFrame() const
+	{
+		return m_state == State::FRAME;
+	}
+
+	CmuxFrame getFrame() const
+	{
+		return {m_header[0], m_header[1], {m_buffer, m_length}};
+	}
+
+	uint32_t getDiscarded() const
+	{
+		return m_discarded;
+	}
+
+private:
+	enum class State : uint8_t
+	{
+		HUNT,
+		ADDRESS,
+		CONTROL,
+		LENGTH,
+		LENGTH_HIGH,
+		INFO,
+		FCS,
+		CLOSING_FLAG,
+		FRAME
+	};
+
+	void startInfo();
+	void discard();
+
+	uint8_t* m_buffer;
+	uint16_t m_capacity;
+	uint16_t m_length;
+	uint16_t m_received;
+	uint8_t m_header[4];
+	uint8_t m_header_size;
+	State m_state;
+	uint32_t m_discarded;
+};
+
+} /* namespace detail */
+
+typedef void (*CmuxWriteCallback)(const uint8_t* data, std::size_t size, void* context);
+
+// 3GPP TS 27.010 basic option multiplexer serving a session per DLCI over one link. DLCI 1 is the session 0.
+// The information field of a frame is fed to its session as a block. Responses are buffered per channel and
+// sent a frame per channel in turn, so a long response does not hold the other channels back. While an
+// offloaded handler blocks a session its input is kept, and the peer is asked to stop with a modem status
+// command. max_info_size is the N1 of the link, a PN command can only lower it per channel
+template<atcmd::server::concepts::ServerSettings Settings, std::size_t channel_count,
+		std::size_t max_info_size = 127, std::size_t output_buffer_size = 512>
+class Cmux
+{
+	static_assert((channel_count != 0) && (channel_count <= 62), "Channel count must be 1 to 62");
+	static_assert((max_info_size != 0) && (max_info_size <= detail::CmuxCodec::max_info_size),
+			"Information field size must be 1 to 32767");
+	static_assert((output_buffer_size != 0) && (output_buffer_size <= 0xFFFF), "Output buffer size must be 1 to 65535");
+
+	using Codec = detail::CmuxCodec;
+
+public:
+	using Session = atcmd::server::Session<Settings>;
+
+	Cmux(CmuxWriteCallback write_callback, void* context = nullptr) :
+		m_write_callback{write_callback},
+		m_context{context},
+		m_decoder{m_input, max_info_size},
+		m_is_open{false},
+		m_is_stopped{false},
+		m_next_channel{0},
+		m_dropped{0}
+	{
+		for (std::size_t i = 0; i < channel_count; i++)
+		{
+			m_channels[i].mux = this;
+			m_channels[i].dlci = static_cast<uint8_t>(i + 1);
+		}
+	}
+
+	Cmux(const Cmux&) = delete;
+	Cmux& operator=(const Cmux&) = delete;
+
+	Session& getSession(std::size_t index)
+	{
+		return m_channels[index].session;
+	}
+
+	// After the peer has opened the control channel and until it closes the multiplexer
+	bool isOpen() const
+	{
+		return m_is_open;
+	}
+
+	bool isChannelOpen(std::size_t index) const
+	{
+		return m_channels[index].is_open;
+	}
+
+	// Frames with a bad FCS or too long
+	uint32_t getDiscardedFrameCount() const
+	{
+		return m_decoder.getDiscarded();
+	}
+
+	// Input not fitting a blocked channel and output of closed or stopped channels
+	uint32_t getDroppedCount() const
+	{
+		return m_dropped;
+	}
+
+	// Feeds the bytes received from the link, then sends the responses
+	void feed(const uint8_t* data, std::size_t size)
+	{
+		while (size != 0)
+		{
+			std::size_t consumed = m_decoder.feed(data, size);
+			data += consumed;
+			size -= consumed;
+			if (m_decoder.hasFrame())
+			{
+				dispatch(m_decoder.getFrame());
+			}
+		}
+		transmit();
+	}
+
+	// Handles the completions of the sessions and the input held back by offloaded handlers, then sends the
+	// responses. To be called after asynchronous updates of the sessions
+	void poll()
+	{
+		for (Channel& channel : m_channels)
+		{
+			if constexpr (atcmd::server::concepts::CompletionQueueSettings<Settings>)
+			{
+				channel.session.processCompletions();
+			}
+			if (channel.input_size != 0)
+			{
+				resume(channel);
+			}
+		}
+		transmit();
+	}
+
+private:
+	struct Channel
+	{
+		Channel() :
+			session{printChar, this}
+		{
+			session.setPrintTextCallback(printText);
+		}
+
+		Cmux* mux = nullptr;
+		uint8_t dlci = 0;
+		bool is_open = false;
+		// The peer has asked to stop sending
+		bool is_stopped = false;
+		// The peer has been asked to stop sending
+		bool is_throttled = false;
+		uint16_t frame_size = max_info_size;
+		uint16_t input_offset = 0;
+		uint16_t input_size = 0;
+		uint16_t output_offset = 0;
+		uint16_t output_size = 0;
+		uint8_t input[max_info_size];
+		uint8_t output[output_buffer_size];
+		Session session;
+	};
+
+	static void printChar(char ch, void* context)
+	{
+		printText(&ch, 1, context);
+	}
+
+	static void printText(const char* text, std::size_t size, void* context)
+	{
+		Channel& channel = *static_cast<Channel*>(context);
+		channel.mux->append(channel, reinterpret_cast<const uint8_t*>(text), size);
+	}
+
+	Channel* getChannel(uint8_t dlci)
+	{
+		return ((dlci != 0) && (dlci <= channel_count)) ? &m_channels[dlci - 1] : nullptr;
+	}
+
+	void dispatch(const detail::CmuxFrame& frame)
+	{
+		uint8_t dlci = frame.address >> 2;
+		uint8_t control = frame.control & ~Codec::pf;
+		uint8_t pf = frame.control & Codec::pf;
+		Channel* channel = getChannel(dlci);
+		switch (control)
+		{
+		case Codec::sabm:
+			if (dlci == 0)
+			{
+				m_is_open = true;
+			}
+			else if ((channel == nullptr) || !m_is_open)
+			{
+				sendResponse(dlci, Codec::dm | pf);
+				return;
+			}
+			else
+			{
+				channel->is_open = true;
+			}
+			sendResponse(dlci, Codec::ua | pf);
+			return;
+		case Codec::disc:
+			if (dlci == 0)
+			{
+				sendResponse(dlci, Codec::ua | pf);
+				close();
+				return;
+			}
+			if ((channel == nullptr) || !channel->is_open)
+			{
+				sendResponse(dlci, Codec::dm | pf);
+				return;
+			}
+			closeChannel(*channel);
+			sendResponse(dlci, Codec::ua | pf);
+			return;
+		case Codec::uih:
+		case Codec::ui:
+			if ((dlci == 0) && m_is_open)
+			{
+				handleControlMessages(frame.info);
+			}
+			else if ((channel != nullptr) && channel->is_open)
+			{
+				receive(*channel, frame.info);
+			}
+			else
+			{
+				sendResponse(dlci, Codec::dm | pf);
+			}
+			return;
+		default:
+			// UA and DM from the peer need no handling
+			return;
+		}
+	}
+
+	void handleControlMessages(std::span<const uint8_t> info)
+	{
+		std::size_t i = 0;
+		while (i + 2 <= info.size())
+		{
+			uint8_t type = info[i];
+			if ((type & Codec::ea) == 0)
+			{
+				// Multi-octet types are not defined
+				return;
+			}
+			std::size_t length = info[i + 1] >> 1;
+			std::size_t header_size = 2;
+			if ((info[i + 1] & Codec::ea) == 0)
+			{
+				if (i + 3 > info.size())
+				{
+					return;
+				}
+				length |= static_cast<std::size_t>(info[i + 2]) << 7;
+				header_size = 3;
+			}
+			if (i + header_size + length > info.size())
+			{
+				return;
+			}
+			std::span<const uint8_t> value = info.subspan(i + header_size, length);
+			i += header_size + length;
+			// Responses to the modem status commands sent by the multiplexer need no handling
+			if (type & Codec::cr)
+			{
+				handleControlCommand(type & ~(Codec::cr | Codec::ea), value);
+			}
+		}
+	}
+
+	void handleControlCommand(uint8_t type, std::span<const uint8_t> value)
+	{
+		switch (type)
+		{
+		case Codec::cld:
+			sendControlMessage(type, false, value);
+			close();
+			return;
+		case Codec::test:
+			sendControlMessage(type, false, value);
+			return;
+		case Codec::fcon:
+		case Codec::fcoff:
+			m_is_stopped = type == Codec::fcoff;
+			sendControlMessage(type, false, value);
+			return;
+		case Codec::msc:
+			if (value.size() >= 2)
+			{
+				if (Channel* channel = getChannel(value[0] >> 2))
+				{
+					channel->is_stopped = (value[1] & Codec::v24_fc) != 0;
+				}
+			}
+			sendControlMessage(type, false, value);
+			return;
+		case Codec::pn:
+			if (value.size() >= 8)
+			{
+				uint8_t reply[8];
+				std::memcpy(reply, value.data(), sizeof(reply));
+				uint16_t frame_size = static_cast<uint16_t>(value[4] | (value[5] << 8));
+				if ((frame_size == 0) || (frame_size > max_info_size))
+				{
+					frame_size = max_info_size;
+				}
+				if (Channel* channel = getChannel(value[0] & 0x3F))
+				{
+					channel->frame_size = frame_size;
+				}
+				reply[4] = static_cast<uint8_t>(frame_size);
+				reply[5] = static_cast<uint8_t>(frame_size >> 8);
+				sendControlMessage(type, false, reply);
+				return;
+			}
+			sendControlMessage(type, false, value);
+			return;
+		default:
+		{
+			const uint8_t command[] = {static_cast<uint8_t>(type | Codec::cr | Codec::ea)};
+			sendControlMessage(Codec::nsc, false, command);
+			return;
+		}
+		}
+	}
+
+	void receive(Channel& channel, std::span<const uint8_t> info)
+	{
+		if (channel.input_size == 0)
+		{
+			std::size_t consumed = channel.session.feed(reinterpret_cast<const char*>(info.data()), info.size(), true);
+			info = info.subspan(consumed);
+			if (info.empty())
+			{
+				return;
+			}
+		}
+		// Held back while a handler is offloaded
+		if (channel.input_offset + channel.input_size + info.size() > max_info_size)
+		{
+			std::memmove(channel.input, &channel.input[channel.input_offset], channel.input_size);
+			channel.input_offset = 0;
+		}
+		std::size_t size = info.size();
+		if (channel.input_size + size > max_info_size)
+		{
+			m_dropped += static_cast<uint32_t>(channel.input_size + size - max_info_size);
+			size = max_info_size - channel.input_size;
+		}
+		std::memcpy(&channel.input[channel.input_offset + channel.input_size], info.data(), size);
+		channel.input_size += static_cast<uint16_t>(size);
+		if (!channel.is_throttled)
+		{
+			channel.is_throttled = true;
+			sendModemStatus(channel);
+		}
+	}
+
+	void resume(Channel& channel)
+	{
+		std::size_t consumed = channel.session.feed(
+				reinterpret_cast<const char*>(&channel.input[channel.input_offset]), channel.input_size, true);
+		channel.input_offset += static_cast<uint16_t>(consumed);
+		channel.input_size -= static_cast<uint16_t>(consumed);
+		if (channel.input_size == 0)
+		{
+			channel.input_offset = 0;
+			channel.is_throttled = false;
+			sendModemStatus(channel);
+		}
+	}
+
+	void append(Channel& channel, const uint8_t* data, std::size_t size)
+	{
+		if (!channel.is_open)
+		{
+			m_dropped += static_cast<uint32_t>(size);
+			return;
+		}
+		while (size != 0)
+		{
+			if (channel.output_offset + channel.output_size == output_buffer_size)
+			{
+				if (channel.output_offset != 0)
+				{
+					std::memmove(channel.output, &channel.output[channel.output_offset], channel.output_size);
+					channel.output_offset = 0;
+				}
+				else
+				{
+					// The other channels get their turns as well
+					transmit();
+					if (channel.output_size == output_buffer_size)
+					{
+						m_dropped += static_cast<uint32_t>(size);
+						return;
+					}
+				}
+				continue;
+			}
+			std::size_t free = output_buffer_size - channel.output_offset - channel.output_size;
+			std::size_t chunk = size < free ? size : free;
+			std::memcpy(&channel.output[channel.output_offset + channel.output_size], data, chunk);
+			channel.output_size += static_cast<uint16_t>(chunk);
+			data += chunk;
+			size -= chunk;
+		}
+	}
+
+	// Round robin, a frame per channel with output in each round
+	void transmit()
+	{
+		if (m_is_stopped)
+		{
+			return;
+		}
+		bool is_sent = true;
+		while (is_sent)
+		{
+			is_sent = false;
+			for (std::size_t i = 0; i < channel_count; i++)
+			{
+				Channel& channel = m_channels[m_next_channel];
+				m_next_channel = m_next_channel + 1 == channel_count ? 0 : m_next_channel + 1;
+				if ((channel.output_size != 0) && !channel.is_stopped)
+				{
+					std::size_t size = channel.output_size < channel.frame_size ? channel.output_size : channel.frame_size;
+					send(Codec::makeAddress(channel.dlci, false), Codec::uih,
+							&channel.output[channel.output_offset], size);
+					channel.output_offset += static_cast<uint16_t>(size);
+					channel.output_size -= static_cast<uint16_t>(size);
+					if (channel.output_size == 0)
+					{
+						channel.output_offset = 0;
+					}
+					is_sent = true;
+				}
+			}
+		}
+	}
+
+	void closeChannel(Channel& channel)
+	{
+		channel.is_open = false;
+		channel.is_stopped = false;
+		channel.is_throttled = false;
+		channel.frame_size = max_info_size;
+		channel.input_offset = 0;
+		channel.input_size = 0;
+		channel.output_offset = 0;
+		channel.output_size = 0;
+	}
+
+	void close()
+	{
+		for (Channel& channel : m_channels)
+		{
+			closeChannel(channel);
+		}
+		m_is_open = false;
+		m_is_stopped = false;
+	}
+
+	void sendResponse(uint8_t dlci, uint8_t control)
+	{
+		send(Codec::makeAddress(dlci, true), control, nullptr, 0);
+	}
+
+	void sendModemStatus(const Channel& channel)
+	{
+		const uint8_t value[] = {
+			Codec::makeAddress(channel.dlci, true),
+			static_cast<uint8_t>(Codec::ea | Codec::v24_rtc | Codec::v24_rtr | (channel.is_throttled ? Codec::v24_fc : 0))
+		};
+		sendControlMessage(Codec::msc, true, value);
+	}
+
+	void sendControlMessage(uint8_t type, bool is_command, std::span<const uint8_t> value)
+	{
+		uint8_t message[max_info_size];
+		std::size_t size = value.size();
+		std::size_t header_size = size <= 0x7F ? 2 : 3;
+		if (header_size + size > max_info_size)
+		{
+			return;
+		}
+		message[0] = static_cast<uint8_t>(type | (is_command ? Codec::cr : 0) | Codec::ea);
+		if (header_size == 2)
+		{
+			message[1] = static_cast<uint8_t>((size << 1) | Codec::ea);
+		}
+		else
+		{
+			message[1] = static_cast<uint8_t>(size << 1);
+			message[2] = static_cast<uint8_t>(size >> 7);
+		}
+		std::memcpy(&message[header_size], value.data(), size);
+		send(Codec::makeAddress(0, false), Codec::uih, message, header_size + size);
+	}
+
+	void send(uint8_t address, uint8_t control, const uint8_t* info, std::size_t size)
+	{
+		std::size_t frame_size = Codec::encode(m_frame, address, control, info, size);
+		m_write_callback(m_frame, frame_size, m_context);
+	}
+
+	CmuxWriteCallback m_write_callback;
+	void* m_context;
+	detail::CmuxDecoder m_decoder;
+	bool m_is_open;
+	// FCOFF from the peer
+	bool m_is_stopped;
+	std::size_t m_next_channel;
+	uint32_t m_dropped;
+	uint8_t m_input[max_info_size];
+	uint8_t m_frame[max_info_size + Codec::max_overhead];
+	Channel m_channels[channel_count];
+};
+
+} /* namespace atcmd */
+
+#endif // ATCMD_CMUX_H
@@ -25,6 +25,8 @@
 #ifndef ATCMD_COMMON_H
 #define ATCMD_COMMON_H
 
+#include <cstddef>
+
 namespace atcmd {
 
 enum class RESULT_CODE
@@ -43,6 +45,15 @@ enum class RESULT_CODE
 
 typedef void (*PrintCharCallback)(char ch, void* context);
 
+// Optional bulk output, used instead of PrintCharCallback for whole buffers when set
+typedef void (*PrintTextCallback)(const char* text, std::size_t size, void* context);
+
+// Runs job(arg) on another thread, context is the one passed to setExecutor()
+typedef void (*ExecuteCallback)(void (*job)(void* arg), void* arg, void* context);
+
+// Called on another thread to wake the server thread up, context is the one passed with the callback
+typedef void (*WakeCallback)(void* context);
+
 } /* namespace atcmd */
 
 #endif // ATCMD_COMMON_H
@@ -35,6 +35,11 @@ struct BasicCmdDef : public CmdParamDef
 	const Ranges* numeric_ranges;
 	BasicCommandBase::ExecMethod exec_method;
 	char name;
+	bool offloadable;
+	bool coroutine;
+	bool concurrent;
+	bool timed;
+	uint32_t timeout;
 
 	template<class Parameter>
 	struct ParameterBuilderBase
@@ -58,9 +63,15 @@ struct BasicCmdDef : public CmdParamDef
 	template<class T>
 	struct ParameterBuilder;
 
+	// An empty list, ParameterBuilderBase takes a single parameter
 	template<class... T>
 	struct ParameterBuilder<atcmd::server::BasicCommand::ParameterList<T...>> :
-		public std::conditional_t<(sizeof...(T) > 0), ParameterBuilderBase<T...>, ParameterBuilderStub>
+		public ParameterBuilderStub
+	{};
+
+	template<class T>
+	struct ParameterBuilder<atcmd::server::BasicCommand::ParameterList<T>> :
+		public ParameterBuilderBase<T>
 	{};
 
 	template<class AtCmd>
@@ -75,8 +86,38 @@ struct BasicCmdDef : public CmdParamDef
 		{
 			r.numeric_ranges = nullptr;
 		}
-		r.exec_method = AtCmd::Definition::onExec;
+		if constexpr (atcmd::server::concepts::BasicTaskCommand<AtCmd>)
+		{
+			r.exec_method = &runTask<BasicCommandBase::BasicServerHandle, AtCmd::Definition::onExec>;
+		}
+		else if constexpr (atcmd::server::concepts::BasicStatefulCommand<AtCmd>)
+		{
+			r.exec_method = &runWithState<
+					BasicCommandBase::BasicServerHandle, typename AtCmd::Definition::AsyncState, AtCmd::Definition::onExec>;
+		}
+		else
+		{
+			r.exec_method = AtCmd::Definition::onExec;
+		}
 		r.name = AtCmd::Definition::name[0];
+		r.offloadable = atcmd::server::concepts::OffloadableCommand<AtCmd>;
+		r.coroutine = atcmd::server::concepts::BasicTaskCommand<AtCmd>;
+		r.concurrent = atcmd::server::concepts::ConcurrentCommand<AtCmd>;
+		static_assert(
+				!atcmd::server::concepts::ConcurrentCommand<AtCmd> || !atcmd::server::concepts::BasicTaskCommand<AtCmd>,
+				"Coroutine handlers can not run concurrently");
+		static_assert(
+				!atcmd::server::concepts::StatefulCommand<AtCmd> || !atcmd::server::concepts::BasicTaskCommand<AtCmd>,
+				"A coroutine keeps its state in its frame, it can not declare an AsyncState");
+		if constexpr (atcmd::server::concepts::TimedCommand<AtCmd>)
+		{
+			r.timeout = AtCmd::Definition::timeout;
+		}
+		else
+		{
+			r.timeout = 0;
+		}
+		r.timed = r.timeout != 0;
 
 		return r;
 	}
@@ -134,6 +134,43 @@ struct Characters
 		return alphabet[encoded];
 	}
 
+	// The longest number representation (binary)
+	static constexpr uint_fast8_t max_number_size = 32;
+
+	// Writes the number to dest, unless it is nullptr, and returns the number of digits
+	static constexpr uint_fast8_t formatNumber(uint32_t number, uint8_t base, char* dest)
+	{
+		assert(base <= std::size(digits));
+
+		uint_fast8_t digit_count = 0;
+		uint32_t n = number;
+		do
+		{
+			n /= base;
+			digit_count++;
+		} while (n != 0);
+
+		if (dest != nullptr)
+		{
+			for (uint_fast8_t i = digit_count; i != 0; i--)
+			{
+				dest[i - 1] = digits[number % base];
+				number /= base;
+			}
+		}
+		return digit_count;
+	}
+
+	// Writes 2 hex digits per byte to dest
+	static constexpr void formatHexadecimalString(const uint8_t* data, std::size_t size, char* dest)
+	{
+		for (std::size_t i = 0; i < size; i++)
+		{
+			*dest++ = digits[data[i] >> 4];
+			*dest++ = digits[data[i] & 0xF];
+		}
+	}
+
 	static void printNumber(uint32_t number, uint8_t base, PrintCharCallback callback, void* context);
 	static void printHexadecimalString(const uint8_t* data, uint16_t size, PrintCharCallback callback, void* context);
 
@@ -143,6 +180,8 @@ struct Characters
 	}
 
 private:
+	static inline constexpr char digits[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+
 	static inline constexpr char alphabet[] =
 	{
 		'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M',
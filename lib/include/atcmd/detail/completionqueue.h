@@ -0,0 +1,124 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_COMPLETIONQUEUE_H
+#define ATCMD_COMPLETIONQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <atcmd/server/command_base.h>
+
+namespace atcmd::server::detail {
+
+struct Completion
+{
+	uint16_t cmd_id;
+	CommandBase::ServerHandle::CALL_TYPE call_type;
+};
+
+// Bounded lock-free multi-producer single-consumer queue. Every cell carries a sequence number telling
+// whether it is free for the producer that claimed its position or ready for the consumer, so producers
+// never wait for each other and an interrupt can post while a thread is in the middle of a push
+template<std::size_t size>
+class CompletionQueue
+{
+	static_assert((size != 0) && ((size & (size - 1)) == 0), "Completion queue size must be a power of two");
+	static_assert(std::atomic<uint32_t>::is_always_lock_free, "Lock-free 32-bit atomics are required");
+
+public:
+	CompletionQueue() :
+		m_tail{0},
+		m_head{0}
+	{
+		for (uint32_t i = 0; i < size; i++)
+		{
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	// Can be called from any thread or interrupt. Returns false if the queue is full
+	bool push(Completion completion)
+	{
+		uint32_t pos = m_tail.load(std::memory_order_relaxed);
+		Cell* cell;
+		while (true)
+		{
+			cell = &m_cells[pos & mask];
+			uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+			int32_t diff = static_cast<int32_t>(sequence - pos);
+			if (diff == 0)
+			{
+				if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = m_tail.load(std::memory_order_relaxed);
+			}
+		}
+		cell->completion = completion;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Must only be called from the server thread
+	bool pop(Completion& completion)
+	{
+		Cell& cell = m_cells[m_head & mask];
+		uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+		if (static_cast<int32_t>(sequence - (m_head + 1)) < 0)
+		{
+			return false;
+		}
+		completion = cell.completion;
+		cell.sequence.store(m_head + size, std::memory_order_release);
+		m_head++;
+		return true;
+	}
+
+private:
+	static constexpr uint32_t mask = size - 1;
+
+	struct Cell
+	{
+		std::atomic<uint32_t> sequence;
+		Completion completion;
+	};
+
+	Cell m_cells[size];
+	std::atomic<uint32_t> m_tail;
+	uint32_t m_head;
+};
+
+} /* namespace atcmd::server::detail */
+
+#endif // ATCMD_COMPLETIONQUEUE_H
@@ -0,0 +1,80 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_COROUTINEFRAMES_H
+#define ATCMD_COROUTINEFRAMES_H
+
+#include <coroutine>
+#include <cstddef>
+
+namespace atcmd::server::detail {
+
+// The fixed-size block for the frame of a coroutine handler. Coroutine commands never run concurrently, so
+// a single frame per server is enough. The block starts with a pointer to its pool, so a frame can be
+// released without knowing the session it was allocated for
+class CoroutineFramePool
+{
+public:
+	// Returns nullptr if the frame does not fit into the block or the block is taken
+	void* allocate(std::size_t size);
+	static void deallocate(void* frame);
+
+	// The suspended handler of the command being executed
+	std::coroutine_handle<> getSuspended() const;
+	void setSuspended(std::coroutine_handle<> coroutine);
+
+	CoroutineFramePool(const CoroutineFramePool&) = delete;
+	CoroutineFramePool& operator=(const CoroutineFramePool&) = delete;
+
+	static constexpr std::size_t header_size = alignof(std::max_align_t);
+
+protected:
+	CoroutineFramePool(std::byte* storage, std::size_t block_size);
+	~CoroutineFramePool();
+
+private:
+	std::byte* m_storage;
+	std::size_t m_block_size;
+	bool m_is_used;
+	std::coroutine_handle<> m_suspended;
+};
+
+template<std::size_t frame_size>
+class CoroutineFrames : public CoroutineFramePool
+{
+	static constexpr std::size_t block_size =
+			(header_size + frame_size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+public:
+	CoroutineFrames() :
+		CoroutineFramePool(m_storage, block_size)
+	{}
+
+private:
+	alignas(std::max_align_t) std::byte m_storage[block_size];
+};
+
+} /* namespace atcmd::server::detail */
+
+#endif // ATCMD_COROUTINEFRAMES_H
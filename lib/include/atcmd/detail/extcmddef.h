@@ -28,6 +28,7 @@
 #include <array>
 
 #include <atcmd/detail/cmdparamdef.h>
+#include <atcmd/detail/triebuilder.h>
 #include <atcmd/server/extendedcommand.h>
 
 namespace atcmd::server::detail {
@@ -40,17 +41,75 @@ struct ExtCmdParamDef : public CmdParamDef
 		NUM_HEX,
 		NUM_BIN,
 		STR,
-		STR_HEX
+		STR_HEX,
+		ENUM
+	};
+
+	// Limits of a streamed string or hexadecimal string
+	struct Stream
+	{
+		uint32_t max_size;
+		uint16_t chunk_size;
+	};
+
+	template<class Parameter>
+	struct StreamBuilder
+	{
+		static consteval uint32_t getMaxSize()
+		{
+			if constexpr (atcmd::server::concepts::StringParameter<Parameter>)
+			{
+				return Parameter::max_length;
+			}
+			else
+			{
+				return Parameter::max_size;
+			}
+		}
+
+		static constexpr Stream stream =
+		{
+			.max_size = getMaxSize(),
+			.chunk_size = Parameter::chunk_size
+		};
+	};
+
+	// Keywords of an enumerated parameter and the trie matching them
+	struct Enum
+	{
+		const uint8_t* trie;
+		const char* const* values;
+		uint16_t count;
+	};
+
+	template<class Parameter>
+	struct EnumBuilder
+	{
+		static constexpr std::size_t trie_size =
+				atcmd::detail::TrieBuilder::getTrieSize(Parameter::values, std::size(Parameter::values));
+
+		static constexpr auto trie =
+				atcmd::detail::TrieBuilder::getTrie<trie_size>(Parameter::values, std::size(Parameter::values));
+
+		static constexpr Enum enumeration =
+		{
+			.trie = trie.data(),
+			.values = Parameter::values,
+			.count = std::size(Parameter::values)
+		};
 	};
 
 	TYPE param_type : 4;
 	bool is_optional : 1;
+	bool is_streamed : 1;
 
 	union
 	{
 		const Ranges* numeric_ranges;
 		uint16_t string_max_len;
 		uint16_t hexstring_max_size;
+		const Stream* stream;
+		const Enum* enumeration;
 	};
 
 	struct HexString
@@ -91,6 +150,14 @@ struct ExtCmdParamDef : public CmdParamDef
 		{
 			r.param_type = TYPE::NUM_BIN;
 		}
+		else if constexpr (atcmd::server::concepts::StreamedParameter<Parameter>)
+		{
+			static_assert(!Parameter::is_optional, "A streamed parameter can not be optional");
+			static_assert(Parameter::chunk_size > 0, "chunk_size can not be zero");
+
+			r.param_type = atcmd::server::concepts::StringParameter<Parameter> ? TYPE::STR : TYPE::STR_HEX;
+			r.stream = &StreamBuilder<Parameter>::stream;
+		}
 		else if constexpr (atcmd::server::concepts::StringParameter<Parameter>)
 		{
 			r.param_type = TYPE::STR;
@@ -101,17 +168,24 @@ struct ExtCmdParamDef : public CmdParamDef
 			r.param_type = TYPE::STR_HEX;
 			r.hexstring_max_size = Parameter::max_size;
 		}
+		else if constexpr (atcmd::server::concepts::EnumParameter<Parameter>)
+		{
+			r.param_type = TYPE::ENUM;
+			r.enumeration = &EnumBuilder<Parameter>::enumeration;
+		}
 		else
 		{
 			static_assert(false, "Unknown parameter type");
 		}
 		r.is_optional = Parameter::is_optional;
+		r.is_streamed = atcmd::server::concepts::StreamedParameter<Parameter>;
 		if constexpr (Parameter::is_optional)
 		{
 			if constexpr (
 						  atcmd::server::concepts::DecimalNumericParameter<Parameter> ||
 						  atcmd::server::concepts::HexadecimalNumericParameter<Parameter> ||
-						  atcmd::server::concepts::BinaryNumericParameter<Parameter>)
+						  atcmd::server::concepts::BinaryNumericParameter<Parameter> ||
+						  atcmd::server::concepts::EnumParameter<Parameter>)
 			{
 				r.default_number = Parameter::default_value;
 			}
@@ -135,6 +209,38 @@ struct ExtCmdParamDef : public CmdParamDef
 		}
 		return r;
 	}
+
+	// Bytes taken in the parameter block, a streamed parameter leaves its total size
+	constexpr uint16_t getSize() const
+	{
+		if (is_streamed)
+		{
+			return sizeof(uint32_t);
+		}
+		switch (param_type) {
+		case TYPE::STR:
+			return string_max_len;
+		case TYPE::STR_HEX:
+			return hexstring_max_size + sizeof(uint16_t);
+		case TYPE::ENUM:
+			return sizeof(uint8_t);
+		default:
+			return sizeof(uint32_t);
+		}
+	}
+
+	// Checks the value of a binary frame at block the way the parser checks the received text
+	bool validate(const uint8_t* block) const;
+
+	// Bytes needed while the parameter is parsed, a streamed parameter collects a chunk in place
+	constexpr uint16_t getParseSize() const
+	{
+		if (is_streamed && (stream->chunk_size > sizeof(uint32_t)))
+		{
+			return stream->chunk_size;
+		}
+		return getSize();
+	}
 };
 
 class ExtCmdDef
@@ -147,6 +253,11 @@ public:
 		bool custom_testable : 1;
 
 		bool single_method : 1;
+		bool offloadable : 1;
+		bool coroutine : 1;
+		bool concurrent : 1;
+		bool data_mode : 1;
+		bool streamed : 1;
 	};
 
 	struct Parameters
@@ -155,12 +266,40 @@ public:
 		const ExtCmdParamDef* parameters;
 	};
 
+	// Precomposed test command response: +<name>:(<ranges>),...
+	struct TestResponse
+	{
+		const char* name;
+		const char* text;
+		uint16_t size;
+
+		// Where the parameter ranges start in the text
+		uint16_t parameters_offset;
+	};
+
+	// Raw payload transfer of a write command returning CONNECT, or only the handler of streamed parameters
+	struct DataMode
+	{
+		ExtendedCommandBase::DataMethod data;
+
+		// Sequence ending the payload, nullptr when its size is given by a parameter
+		const char* escape;
+		// For each partial match of the escape, the length of its longest proper prefix that is also its suffix:
+		// what is still matched when the next byte breaks the partial match
+		const uint8_t* escape_fallback;
+		uint8_t escape_length;
+
+		// Where the size parameter is in the parameter block
+		uint16_t size_offset;
+	};
+
 private:
 	union Method
 	{
 		ExtendedCommandBase::WriteMethod write;
 		ExtendedCommandBase::ReadMethod read;
 		ExtendedCommandBase::TestMethod test;
+		const DataMode* data_mode;
 	};
 
 	union Methods
@@ -197,6 +336,312 @@ private:
 		public std::conditional_t<(sizeof...(T) > 0), ParameterBuilderBase<T...>, ParameterBuilderStub>
 	{};
 
+	static consteval std::size_t composeTestResponse(const char* name, const Parameters& parameters, char* dest)
+	{
+		// Only the length is calculated when dest is nullptr
+		std::size_t r = 0;
+		auto put = [&](char ch)
+		{
+			if (dest != nullptr)
+			{
+				dest[r] = ch;
+			}
+			r++;
+		};
+		auto putNumber = [&](uint32_t number, uint8_t base)
+		{
+			r += atcmd::detail::Characters::formatNumber(number, base, dest == nullptr ? nullptr : &dest[r]);
+		};
+
+		put('+');
+		for (const char* ch = name; *ch != '\0'; ch++)
+		{
+			put(*ch);
+		}
+		put(':');
+
+		for (std::size_t i = 0; i < parameters.count; i++)
+		{
+			if (i != 0)
+			{
+				put(',');
+			}
+			put('(');
+
+			const ExtCmdParamDef& parameter = parameters.parameters[i];
+			uint8_t base = 10;
+			switch (parameter.param_type) {
+			case ExtCmdParamDef::TYPE::NUM_HEX:
+				base = 16;
+				break;
+			case ExtCmdParamDef::TYPE::NUM_BIN:
+				base = 2;
+				break;
+			default:
+				break;
+			}
+
+			switch (parameter.param_type) {
+			case ExtCmdParamDef::TYPE::NUM_DEC:
+			case ExtCmdParamDef::TYPE::NUM_HEX:
+			case ExtCmdParamDef::TYPE::NUM_BIN:
+				for (std::size_t j = 0; j < parameter.numeric_ranges->count; j++)
+				{
+					if (j != 0)
+					{
+						put(',');
+					}
+					const auto& range = parameter.numeric_ranges->ranges[j];
+					putNumber(range.m_min, base);
+					if (range.m_min != range.m_max)
+					{
+						put('-');
+						putNumber(range.m_max, base);
+					}
+				}
+				break;
+			case ExtCmdParamDef::TYPE::STR:
+				put('s');
+				put(':');
+				putNumber(parameter.is_streamed ? parameter.stream->max_size : parameter.string_max_len - 1u, 10);
+				break;
+			case ExtCmdParamDef::TYPE::STR_HEX:
+				put('h');
+				put('s');
+				put(':');
+				putNumber(parameter.is_streamed ? parameter.stream->max_size : parameter.hexstring_max_size, 10);
+				break;
+			case ExtCmdParamDef::TYPE::ENUM:
+				for (std::size_t j = 0; j < parameter.enumeration->count; j++)
+				{
+					if (j != 0)
+					{
+						put(',');
+					}
+					put('"');
+					for (const char* ch = parameter.enumeration->values[j]; *ch != '\0'; ch++)
+					{
+						put(*ch);
+					}
+					put('"');
+				}
+				break;
+			default:
+				break;
+			}
+
+			put(')');
+		}
+		return r;
+	}
+
+	template<class AtCmd, const Parameters& parameters>
+	struct TestResponseBuilder
+	{
+		static consteval auto composeText()
+		{
+			std::array<char, composeTestResponse(AtCmd::Definition::name, parameters, nullptr)> r = {};
+			composeTestResponse(AtCmd::Definition::name, parameters, r.data());
+			return r;
+		}
+
+		static constexpr auto text = composeText();
+
+		static_assert(text.size() <= 0xFFFF, "Test command response is too long");
+
+		static constexpr TestResponse response =
+		{
+			.name = AtCmd::Definition::name,
+			.text = text.data(),
+			.size = text.size(),
+			.parameters_offset = sizeof(AtCmd::Definition::name) + 1 // '+' and ':' instead of '\0'
+		};
+	};
+
+	// Coroutine and stateful handlers are called through an adapter with the plain handler signature
+	template<class AtCmd>
+	static consteval ExtendedCommandBase::ReadMethod buildReadMethod()
+	{
+		if constexpr (atcmd::server::concepts::ExtendedReadTaskCommand<AtCmd>)
+		{
+			return &runTask<ExtendedCommandBase::ReadServerHandle, AtCmd::Definition::onRead>;
+		}
+		else if constexpr (atcmd::server::concepts::ExtendedReadStatefulCommand<AtCmd>)
+		{
+			return &runWithState<
+					ExtendedCommandBase::ReadServerHandle, typename AtCmd::Definition::AsyncState, AtCmd::Definition::onRead>;
+		}
+		else
+		{
+			return AtCmd::Definition::onRead;
+		}
+	}
+
+	template<class AtCmd>
+	static consteval ExtendedCommandBase::WriteMethod buildWriteMethod()
+	{
+		if constexpr (atcmd::server::concepts::ExtendedWriteTaskCommand<AtCmd>)
+		{
+			return &runTask<ExtendedCommandBase::WriteServerHandle, AtCmd::Definition::onWrite>;
+		}
+		else if constexpr (atcmd::server::concepts::ExtendedWriteStatefulCommand<AtCmd>)
+		{
+			return &runWithState<
+					ExtendedCommandBase::WriteServerHandle, typename AtCmd::Definition::AsyncState, AtCmd::Definition::onWrite>;
+		}
+		else
+		{
+			return AtCmd::Definition::onWrite;
+		}
+	}
+
+	template<class AtCmd>
+	static consteval ExtendedCommandBase::DataMethod buildDataMethod()
+	{
+		if constexpr (atcmd::server::concepts::StatefulCommand<AtCmd> &&
+				!requires { { static_cast<ExtendedCommandBase::DataMethod>(&AtCmd::Definition::onData) }; })
+		{
+			return &runDataWithState<
+					ExtendedCommandBase::WriteServerHandle, typename AtCmd::Definition::AsyncState, AtCmd::Definition::onData>;
+		}
+		else
+		{
+			return AtCmd::Definition::onData;
+		}
+	}
+
+	template<class P, class List>
+	struct ParameterIndex;
+
+	template<class P, class... T>
+	struct ParameterIndex<P, atcmd::server::ExtendedCommand::ParameterList<T...>>
+	{
+		static constexpr std::size_t index = []()
+		{
+			constexpr std::array<bool, sizeof...(T)> matches = {std::is_same_v<P, T>...};
+			std::size_t r = 0;
+			while ((r != matches.size()) && !matches[r])
+			{
+				r++;
+			}
+			return r;
+		}();
+	};
+
+	// Offset of a parameter in the block the parser fills in the command line
+	static consteval uint16_t getParameterOffset(const Parameters& parameters, std::size_t index)
+	{
+		uint16_t r = 0;
+		for (std::size_t i = 0; i < index; i++)
+		{
+			r += parameters.parameters[i].getSize();
+		}
+		return r;
+	}
+
+	template<class AtCmd>
+	struct EscapeFallbackBuilder
+	{
+		static constexpr std::size_t length = std::size(AtCmd::Definition::data_escape) - 1;
+
+		static consteval std::array<uint8_t, length> build()
+		{
+			const char* escape = AtCmd::Definition::data_escape;
+			std::array<uint8_t, length> r = {};
+			std::size_t k = 0;
+			for (std::size_t i = 1; i < length; i++)
+			{
+				while ((k != 0) && (escape[i] != escape[k]))
+				{
+					k = r[k - 1];
+				}
+				if (escape[i] == escape[k])
+				{
+					k++;
+				}
+				r[i] = static_cast<uint8_t>(k);
+			}
+			return r;
+		}
+
+		static constexpr std::array<uint8_t, length> fallback = build();
+	};
+
+	template<class AtCmd>
+	struct DataModeBuilder
+	{
+		static_assert(
+				!atcmd::server::concepts::SizedExtendedDataCommand<AtCmd> ||
+				!atcmd::server::concepts::EscapedExtendedDataCommand<AtCmd>,
+				"A data mode command needs either a DataSize parameter or a data_escape sequence");
+
+		static consteval DataMode build()
+		{
+			DataMode r = {};
+			r.data = buildDataMethod<AtCmd>();
+			if constexpr (atcmd::server::concepts::SizedExtendedDataCommand<AtCmd>)
+			{
+				using DataSize = typename AtCmd::Definition::DataSize;
+				using Parameters = typename AtCmd::Definition::Parameters;
+				static_assert(atcmd::server::concepts::NumericParameter<DataSize>, "DataSize must be a numeric parameter");
+
+				constexpr std::size_t index = ParameterIndex<DataSize, Parameters>::index;
+				static_assert(index < ParameterBuilder<Parameters>::parameters.count, "DataSize must be a parameter of the command");
+				static_assert(
+						[]()
+						{
+							for (const auto& range : DataSize::ranges)
+							{
+								if (range.m_min == 0)
+								{
+									return false;
+								}
+							}
+							return true;
+						}(),
+						"DataSize can not allow an empty payload");
+
+				r.escape = nullptr;
+				r.escape_fallback = nullptr;
+				r.escape_length = 0;
+				r.size_offset = getParameterOffset(ParameterBuilder<Parameters>::parameters, index);
+			}
+			else if constexpr (atcmd::server::concepts::EscapedExtendedDataCommand<AtCmd>)
+			{
+				constexpr std::size_t escape_length = std::size(AtCmd::Definition::data_escape) - 1;
+				static_assert((escape_length > 0) && (escape_length <= 0xFF), "data_escape must have 1 to 255 characters");
+
+				r.escape = AtCmd::Definition::data_escape;
+				r.escape_fallback = EscapeFallbackBuilder<AtCmd>::fallback.data();
+				r.escape_length = escape_length;
+				r.size_offset = 0;
+			}
+			else
+			{
+				// Streamed parameters only
+				r.escape = nullptr;
+				r.escape_fallback = nullptr;
+				r.escape_length = 0;
+				r.size_offset = 0;
+			}
+			return r;
+		}
+
+		static constexpr DataMode data_mode = build();
+	};
+
+	static consteval bool hasStreamedParameters(const Parameters& parameters)
+	{
+		for (std::size_t i = 0; i < parameters.count; i++)
+		{
+			if (parameters.parameters[i].is_streamed)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
 	template<class AtCmd, Flags flags, std::size_t N>
 	class MethodBuilder
 	{
@@ -206,16 +651,20 @@ private:
 			std::size_t i = 0;
 			if constexpr (flags.readable)
 			{
-				r[i++].read = AtCmd::Definition::onRead;
+				r[i++].read = buildReadMethod<AtCmd>();
 			}
 			if constexpr (flags.writable)
 			{
-				r[i++].write = AtCmd::Definition::onWrite;
+				r[i++].write = buildWriteMethod<AtCmd>();
 			}
 			if constexpr (flags.custom_testable)
 			{
 				r[i++].test = AtCmd::Definition::onTest;
 			}
+			if constexpr (flags.data_mode || flags.streamed)
+			{
+				r[i++].data_mode = &DataModeBuilder<AtCmd>::data_mode;
+			}
 			return r;
 		}
 
@@ -232,10 +681,37 @@ public:
 			.readable = atcmd::server::concepts::ExtendedReadCommand<AtCmd>,
 			.writable = atcmd::server::concepts::ExtendedWriteCommand<AtCmd>,
 			.custom_testable = atcmd::server::concepts::ExtendedTestCommand<AtCmd>,
-			.single_method = false
+			.single_method = false,
+			.offloadable = atcmd::server::concepts::OffloadableCommand<AtCmd>,
+			.coroutine =
+					atcmd::server::concepts::ExtendedReadTaskCommand<AtCmd> ||
+					atcmd::server::concepts::ExtendedWriteTaskCommand<AtCmd>,
+			.concurrent = atcmd::server::concepts::ConcurrentCommand<AtCmd>,
+			.data_mode =
+					atcmd::server::concepts::SizedExtendedDataCommand<AtCmd> ||
+					atcmd::server::concepts::EscapedExtendedDataCommand<AtCmd>,
+			.streamed = hasStreamedParameters(ParameterBuilder<typename AtCmd::Definition::Parameters>::parameters)
 		};
+		static_assert(!flags.concurrent || !flags.coroutine, "Coroutine handlers can not run concurrently");
+		static_assert(!flags.coroutine || !atcmd::server::concepts::StatefulCommand<AtCmd>,
+				"A coroutine keeps its state in its frame, it can not declare an AsyncState");
+		static_assert(!flags.concurrent || !flags.data_mode, "Data mode commands can not run concurrently");
+		static_assert(
+				!atcmd::server::concepts::ExtendedDataCommand<AtCmd> || flags.data_mode || flags.streamed,
+				"A data mode command needs either a DataSize parameter or a data_escape sequence");
+		static_assert(!flags.streamed || atcmd::server::concepts::ExtendedDataCommand<AtCmd>,
+				"A command with a streamed parameter needs onData");
+		static_assert(!flags.streamed ||
+				requires { { static_cast<ExtendedCommandBase::DataMethod>(&AtCmd::Definition::onData) }; },
+				"Streamed parameters are passed before the command runs, onData can not take an AsyncState");
+		static_assert(!flags.streamed || !flags.data_mode, "A command with a streamed parameter can not use data mode");
+		static_assert(!flags.streamed || !flags.concurrent, "A command with a streamed parameter can not run concurrently");
+		static_assert(!flags.concurrent || !atcmd::server::concepts::CachedExtendedReadCommand<AtCmd>,
+				"The request of a concurrent command can run ahead of its turn, it can not be cached");
+		static_assert(!flags.offloadable || !atcmd::server::concepts::CachedExtendedReadCommand<AtCmd>,
+				"Cached responses are replayed on the server thread, an offloadable read can not be cached");
 		static constexpr uint8_t method_count =
-				flags.readable + flags.writable + flags.custom_testable;
+				flags.readable + flags.writable + flags.custom_testable + (flags.data_mode || flags.streamed);
 
 		ExtCmdDef r = {};
 		r.m_flags = flags;
@@ -245,11 +721,11 @@ public:
 			r.m_flags.single_method = true;
 			if constexpr (flags.readable)
 			{
-				r.m_methods.method.read = AtCmd::Definition::onRead;
+				r.m_methods.method.read = buildReadMethod<AtCmd>();
 			}
 			if constexpr (flags.writable)
 			{
-				r.m_methods.method.write = AtCmd::Definition::onWrite;
+				r.m_methods.method.write = buildWriteMethod<AtCmd>();
 			}
 			if constexpr (flags.custom_testable)
 			{
@@ -271,6 +747,42 @@ public:
 			r.m_parameters = nullptr;
 		}
 
+		if constexpr (atcmd::server::concepts::CachedExtendedReadCommand<AtCmd>)
+		{
+			r.m_read_cache_size = AtCmd::Definition::read_cache_size;
+		}
+		else
+		{
+			r.m_read_cache_size = 0;
+		}
+
+		if constexpr (atcmd::server::concepts::CachedExtendedTestCommand<AtCmd>)
+		{
+			r.m_test_cache_size = AtCmd::Definition::test_cache_size;
+		}
+		else
+		{
+			r.m_test_cache_size = 0;
+		}
+
+		if constexpr (atcmd::server::concepts::TimedCommand<AtCmd>)
+		{
+			r.m_timeout = AtCmd::Definition::timeout;
+		}
+		else
+		{
+			r.m_timeout = 0;
+		}
+
+		if constexpr (flags.custom_testable && (ParamBuider::parameters.count > 0))
+		{
+			r.m_test_response = &TestResponseBuilder<AtCmd, ParamBuider::parameters>::response;
+		}
+		else
+		{
+			r.m_test_response = nullptr;
+		}
+
 		return r;
 	}
 
@@ -278,6 +790,12 @@ public:
 	ExtendedCommandBase::WriteMethod getWriteMethod() const;
 	ExtendedCommandBase::TestMethod getTestMethod() const;
 
+	// nullptr if the command has no data mode
+	const DataMode* getDataMode() const;
+
+	// The handler of the payload or of the streamed parameters, nullptr if the command has neither
+	ExtendedCommandBase::DataMethod getDataMethod() const;
+
 	constexpr const Parameters* getParameters() const
 	{
 		return m_parameters;
@@ -288,9 +806,65 @@ public:
 		return m_flags;
 	}
 
+	constexpr bool isOffloadable() const
+	{
+		return m_flags.offloadable;
+	}
+
+	constexpr bool isCoroutine() const
+	{
+		return m_flags.coroutine;
+	}
+
+	constexpr bool isConcurrent() const
+	{
+		return m_flags.concurrent;
+	}
+
+	constexpr bool isDataMode() const
+	{
+		return m_flags.data_mode;
+	}
+
+	constexpr bool isStreamed() const
+	{
+		return m_flags.streamed;
+	}
+
+	constexpr const TestResponse* getTestResponse() const
+	{
+		return m_test_response;
+	}
+
+	// Zero when the responses are not cached
+	consteval uint16_t getReadCacheSize() const
+	{
+		return m_read_cache_size;
+	}
+
+	consteval uint16_t getTestCacheSize() const
+	{
+		return m_test_cache_size;
+	}
+
+	// Timer wheel ticks an asynchronous read or write may take, zero for no limit
+	constexpr uint32_t getTimeout() const
+	{
+		return m_timeout;
+	}
+
+	constexpr bool isTimed() const
+	{
+		return m_timeout != 0;
+	}
+
 private:
 	Methods m_methods;
 	const Parameters* m_parameters;
+	const TestResponse* m_test_response;
+	uint32_t m_timeout;
+	uint16_t m_read_cache_size;
+	uint16_t m_test_cache_size;
 	Flags m_flags;
 };
 
@@ -0,0 +1,97 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_RESPONSECACHE_H
+#define ATCMD_RESPONSECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atcmd/common.h>
+
+namespace atcmd::server::detail {
+
+// Collects a copy of the server output while a cached command is executed, or the output itself while
+// an offloaded one runs on another thread
+struct OutputRecorder
+{
+	char* data;
+	uint16_t capacity;
+	uint16_t size;
+	bool overflow;
+
+	// The output is kept from the print callbacks
+	bool is_capturing;
+
+	void record(const char* text, std::size_t text_size)
+	{
+		if (text_size > static_cast<std::size_t>(capacity - size))
+		{
+			overflow = true;
+			return;
+		}
+		for (std::size_t i = 0; i < text_size; i++)
+		{
+			data[size++] = text[i];
+		}
+	}
+};
+
+struct ResponseCacheSlot
+{
+	// The server generation the response was recorded in
+	uint32_t generation;
+	uint16_t size;
+	RESULT_CODE result_code;
+	bool is_valid : 1;
+	bool is_last_command : 1;
+	bool verbose : 1;
+
+	// The framing the response was recorded with
+	char s3;
+	char s4;
+};
+
+// Where a cached command keeps its response
+struct ResponseCacheEntry
+{
+	uint16_t cmd_id;
+	uint16_t offset;
+	uint16_t capacity;
+};
+
+template<std::size_t slot_count, std::size_t data_size>
+struct ResponseCache
+{
+	ResponseCacheSlot m_slots[slot_count];
+	char m_data[data_size];
+};
+
+template<>
+struct ResponseCache<0, 0>
+{};
+
+} /* namespace atcmd::server::detail */
+
+#endif // ATCMD_RESPONSECACHE_H
@@ -0,0 +1,136 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_RESPONSEFORMAT_H
+#define ATCMD_RESPONSEFORMAT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace atcmd::detail {
+
+// A string literal usable as a template argument
+template<std::size_t N>
+struct FormatString
+{
+	consteval FormatString(const char (&s)[N])
+	{
+		for (std::size_t i = 0; i < N; i++)
+		{
+			text[i] = s[i];
+		}
+	}
+
+	static constexpr std::size_t size = N - 1;
+
+	char text[N];
+};
+
+// Splits a response template such as "+CMD:{},\"{}\"" into the literal segments around its placeholders
+template<FormatString format>
+struct ResponseFormat
+{
+	struct Segment
+	{
+		uint16_t offset;
+		uint16_t size;
+	};
+
+	static consteval bool validate()
+	{
+		for (std::size_t i = 0; i < format.size; i++)
+		{
+			if (format.text[i] == '{')
+			{
+				if ((i + 1 == format.size) || (format.text[i + 1] != '}'))
+				{
+					return false;
+				}
+				i++;
+			}
+			else if (format.text[i] == '}')
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static_assert(validate(), "Only {} placeholders are allowed in a response template");
+
+	static consteval std::size_t countPlaceholders()
+	{
+		std::size_t r = 0;
+		for (std::size_t i = 0; i < format.size; i++)
+		{
+			r += format.text[i] == '{';
+		}
+		return r;
+	}
+
+	static constexpr std::size_t placeholder_count = countPlaceholders();
+
+	static consteval std::array<Segment, placeholder_count + 1> split()
+	{
+		std::array<Segment, placeholder_count + 1> r = {};
+		std::size_t start = 0;
+		std::size_t j = 0;
+		for (std::size_t i = 0; i < format.size; i++)
+		{
+			if (format.text[i] == '{')
+			{
+				r[j++] = {static_cast<uint16_t>(start), static_cast<uint16_t>(i - start)};
+				start = i + 2;
+			}
+		}
+		r[j] = {static_cast<uint16_t>(start), static_cast<uint16_t>(format.size - start)};
+		return r;
+	}
+
+	static constexpr std::array<Segment, placeholder_count + 1> segments = split();
+
+	static constexpr std::size_t literal_size = format.size - 2 * placeholder_count;
+
+	// Placeholders of string parameters are enclosed in quotes
+	static consteval bool isQuoted(std::size_t placeholder)
+	{
+		const Segment& before = segments[placeholder];
+		const Segment& after = segments[placeholder + 1];
+		return
+				(before.size != 0) && (format.text[before.offset + before.size - 1] == '"') &&
+				(after.size != 0) && (format.text[after.offset] == '"');
+	}
+
+	template<std::size_t segment>
+	static constexpr std::string_view getSegment()
+	{
+		return std::string_view(&format.text[segments[segment].offset], segments[segment].size);
+	}
+};
+
+} /* namespace atcmd::detail */
+
+#endif // ATCMD_RESPONSEFORMAT_H
@@ -0,0 +1,160 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_RESPONSEFRAMING_H
+#define ATCMD_RESPONSEFRAMING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <atcmd/common.h>
+
+namespace atcmd::server::detail {
+
+struct ResultCodeTexts
+{
+	static constexpr std::string_view codes[] =
+	{
+		"OK",
+		"CONNECT",
+		"RING",
+		"NO CARRIER",
+		"ERROR",
+		"",
+		"NO DIALTONE",
+		"BUSY",
+		"NO ANSWER"
+	};
+
+	static constexpr std::size_t count = std::size(codes);
+
+	static consteval std::size_t calcComposedSize()
+	{
+		// Verbose codes take more space than numeric ones: S3 S4 <text> S3 S4
+		std::size_t r = 0;
+		for (const std::string_view& code : codes)
+		{
+			r += code.size() + 4;
+		}
+		return r;
+	}
+
+	static consteval std::size_t calcMaxComposedSize()
+	{
+		std::size_t r = 0;
+		for (const std::string_view& code : codes)
+		{
+			if (code.size() + 4 > r)
+			{
+				r = code.size() + 4;
+			}
+		}
+		return r;
+	}
+
+	static constexpr char default_s3 = '\r';
+	static constexpr char default_s4 = '\n';
+
+	// Writes a single framed result code to dest and returns its size
+	static constexpr std::size_t composeResultCode(std::size_t i, char s3, char s4, bool verbose, char* dest)
+	{
+		std::size_t pos = 0;
+		if (verbose)
+		{
+			dest[pos++] = s3;
+			dest[pos++] = s4;
+			for (char ch : codes[i])
+			{
+				dest[pos++] = ch;
+			}
+			dest[pos++] = s3;
+			dest[pos++] = s4;
+		}
+		else
+		{
+			dest[pos++] = '0' + i;
+			dest[pos++] = s3;
+		}
+		return pos;
+	}
+};
+
+struct DefaultResultCodes : public ResultCodeTexts
+{
+	struct ComposedResultCodes
+	{
+		char text[calcComposedSize()];
+		uint8_t offsets[count + 1];
+	};
+
+	static_assert(calcComposedSize() <= 0xFF, "Result code offsets do not fit a byte");
+
+	static consteval ComposedResultCodes composeDefaultResultCodes(bool verbose)
+	{
+		ComposedResultCodes r = {};
+		std::size_t pos = 0;
+		for (std::size_t i = 0; i < count; i++)
+		{
+			r.offsets[i] = pos;
+			pos += composeResultCode(i, default_s3, default_s4, verbose, &r.text[pos]);
+		}
+		r.offsets[count] = pos;
+		return r;
+	}
+};
+
+// Result codes and information text framing for the current S3, S4 and verbose settings, so that every one
+// of them can be printed with a single write. Result codes framed with the default S3 and S4 are composed
+// at compile time and shared by all the servers
+class ResponseFraming : private DefaultResultCodes
+{
+public:
+	// The longest header or trailer
+	static constexpr std::size_t max_framing_size = 2;
+
+	// The buffer size needed by getResultCode()
+	static constexpr std::size_t max_result_code_size = calcMaxComposedSize();
+
+	void compose(char s3, char s4, bool verbose);
+
+	// buf is only used when S3 or S4 differ from the defaults
+	std::string_view getResultCode(RESULT_CODE code, char* buf) const;
+	std::string_view getResultCodeHeader() const;
+	std::string_view getResultCodeTrailer() const;
+	std::string_view getInformationTextHeader() const;
+	std::string_view getInformationTextTrailer() const;
+
+private:
+	static constexpr ComposedResultCodes m_default_verbose = composeDefaultResultCodes(true);
+	static constexpr ComposedResultCodes m_default_numeric = composeDefaultResultCodes(false);
+
+	char m_line_break[2];
+	bool m_verbose;
+	bool m_is_default;
+};
+
+} /* namespace atcmd::server::detail */
+
+#endif // ATCMD_RESPONSEFRAMING_H
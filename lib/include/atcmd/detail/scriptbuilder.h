@@ -0,0 +1,678 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_SCRIPTBUILDER_H
+#define ATCMD_SCRIPTBUILDER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <atcmd/detail/characters.h>
+#include <atcmd/detail/responseformat.h>
+#include <atcmd/detail/server_cmdline.h>
+
+namespace atcmd::server::detail {
+
+// Not constexpr: a script error stops the compilation at a call naming it
+struct ScriptError
+{
+	static void missingAtPrefix();
+	static void unexpectedCharacter();
+	static void unknownCommand();
+	static void unsupportedSParameter();
+	static void notReadable();
+	static void notWritable();
+	static void tooManyParameters();
+	static void missingMandatoryParameter();
+	static void valueOutOfRange();
+	static void stringTooLong();
+	static void unevenHexString();
+	static void streamedParameter();
+	static void unknownKeyword();
+};
+
+// Parses a command line literal with the grammar of Server's state machine. The line ends at the end of the
+// literal or at a '\r' closing it
+template<class Settings>
+class ScriptBuilder
+{
+	using Cmdline = ServerCmdline<Settings>;
+	using CMD_TYPE = typename Cmdline::CMD_TYPE;
+
+public:
+	template<atcmd::detail::FormatString line>
+	static consteval auto build()
+	{
+		constexpr std::size_t size = ScriptBuilder(line.text, line.size, nullptr).encode();
+		static_assert(size <= Cmdline::calcCmdlineSize(), "The script does not fit the command line buffer");
+		std::array<uint8_t, size> r = {};
+		ScriptBuilder(line.text, line.size, r.data()).encode();
+		return r;
+	}
+
+private:
+	consteval ScriptBuilder(const char* text, std::size_t length, uint8_t* dest) :
+		m_text{text},
+		m_length{(length != 0) && (text[length - 1] == '\r') ? length - 1 : length},
+		m_dest{dest},
+		m_pos{0},
+		m_size{0}
+	{}
+
+	consteval std::size_t encode()
+	{
+		skipSpaces();
+		if (toUpper(get()) != 'A')
+		{
+			ScriptError::missingAtPrefix();
+		}
+		skipSpaces();
+		if (toUpper(get()) != 'T')
+		{
+			ScriptError::missingAtPrefix();
+		}
+		while (true)
+		{
+			skipSpaces();
+			if (isEnd())
+			{
+				return m_size;
+			}
+			char ch = toUpper(get());
+			if (ch == 'S')
+			{
+				encodeSParameter();
+			}
+			else if (atcmd::detail::Characters::isAlphabetic(ch))
+			{
+				encodeBasicCmd(ch);
+			}
+			else if (ch == '&')
+			{
+				skipSpaces();
+				encodeAmpersandCmd(toUpper(get()));
+			}
+			else if (ch == '+')
+			{
+				encodeExtendedCmd();
+			}
+			else
+			{
+				ScriptError::unexpectedCharacter();
+			}
+		}
+	}
+
+	consteval void encodeSParameter()
+	{
+		uint32_t index = getDecimal();
+		char ch = get();
+		if ((ch != '=') && (ch != '?'))
+		{
+			ScriptError::unexpectedCharacter();
+		}
+		if ((index < 3) || (index > 4))
+		{
+			ScriptError::unsupportedSParameter();
+		}
+		addCmdId(Cmdline::getBasicCmdOffset());
+		if (ch == '?')
+		{
+			addByte(static_cast<uint8_t>(index));
+			return;
+		}
+		uint32_t value = getDecimal();
+		if (value > 127)
+		{
+			ScriptError::valueOutOfRange();
+		}
+		addByte(static_cast<uint8_t>(index | 0x80));
+		addByte(static_cast<uint8_t>(value));
+	}
+
+	consteval void encodeBasicCmd(char name)
+	{
+		if constexpr (Settings::BasicCommands::size != 0)
+		{
+			for (std::size_t i = 0; i < Settings::BasicCommands::size; i++)
+			{
+				if (Settings::BasicCommands::m_cmd_defs[i].name == name)
+				{
+					addCmdId(Cmdline::getBasicCmdOffset() + 1 + i);
+					encodeBasicParameter(Settings::BasicCommands::m_cmd_defs[i]);
+					return;
+				}
+			}
+		}
+		ScriptError::unknownCommand();
+	}
+
+	consteval void encodeAmpersandCmd(char name)
+	{
+		if constexpr (Settings::AmpersandCommands::size != 0)
+		{
+			for (std::size_t i = 0; i < Settings::AmpersandCommands::size; i++)
+			{
+				if (Settings::AmpersandCommands::m_cmd_defs[i].name == name)
+				{
+					addCmdId(Cmdline::getAmpersandCmdOffset() + i);
+					encodeBasicParameter(Settings::AmpersandCommands::m_cmd_defs[i]);
+					return;
+				}
+			}
+		}
+		ScriptError::unknownCommand();
+	}
+
+	consteval void encodeBasicParameter(const BasicCmdDef& cmd_def)
+	{
+		if (cmd_def.numeric_ranges == nullptr)
+		{
+			return;
+		}
+		uint32_t value = getDecimal();
+		if (!BasicCmdDef::validateNumericRanges(*cmd_def.numeric_ranges, value))
+		{
+			ScriptError::valueOutOfRange();
+		}
+		addNumber(value);
+	}
+
+	consteval void encodeExtendedCmd()
+	{
+		skipSpaces();
+		std::size_t start = m_pos;
+		while (!isEnd() && (m_text[m_pos] != '=') && (m_text[m_pos] != '?') && (m_text[m_pos] != ';'))
+		{
+			m_pos++;
+		}
+		uint16_t cmd_index = findExtendedCmd(start, m_pos);
+		const ExtCmdDef& cmd_def = Settings::ExtendedCommands::m_ext_cmd_defs[cmd_index];
+		const ExtCmdDef::Parameters* parameters = cmd_def.getParameters();
+
+		if (isEnd() || (get() == ';'))
+		{
+			if (!cmd_def.getFlags().writable)
+			{
+				ScriptError::notWritable();
+			}
+			addCmdId(Cmdline::getExtCmdId(cmd_index, CMD_TYPE::WRITE));
+			addDefaultParameters(parameters, 0);
+			return;
+		}
+		if (m_text[m_pos - 1] == '?')
+		{
+			if (!cmd_def.getFlags().readable)
+			{
+				ScriptError::notReadable();
+			}
+			addCmdId(Cmdline::getExtCmdId(cmd_index, CMD_TYPE::READ));
+			skipCmdEnd();
+			return;
+		}
+		skipSpaces();
+		if (!isEnd() && (m_text[m_pos] == '?'))
+		{
+			m_pos++;
+			addCmdId(Cmdline::getExtCmdId(cmd_index, CMD_TYPE::TEST));
+			skipCmdEnd();
+			return;
+		}
+		if (!cmd_def.getFlags().writable)
+		{
+			ScriptError::notWritable();
+		}
+		if ((parameters == nullptr) || (parameters->count == 0))
+		{
+			ScriptError::tooManyParameters();
+		}
+		addCmdId(Cmdline::getExtCmdId(cmd_index, CMD_TYPE::WRITE));
+		encodeParameters(*parameters);
+	}
+
+	consteval uint16_t findExtendedCmd(std::size_t start, std::size_t end) const
+	{
+		if constexpr (Settings::ExtendedCommands::size != 0)
+		{
+			constexpr std::array<std::string_view, Settings::ExtendedCommands::size> names =
+					Settings::ExtendedCommands::getNames();
+			for (uint16_t i = 0; i < names.size(); i++)
+			{
+				std::size_t j = 0;
+				for (std::size_t k = start; k < end; k++)
+				{
+					if (m_text[k] == ' ')
+					{
+						continue;
+					}
+					if ((j == names[i].size()) || (toUpper(m_text[k]) != names[i][j]))
+					{
+						j = names[i].size() + 1;
+						break;
+					}
+					j++;
+				}
+				if (j == names[i].size())
+				{
+					return i;
+				}
+			}
+		}
+		ScriptError::unknownCommand();
+		return 0;
+	}
+
+	consteval void encodeParameters(const ExtCmdDef::Parameters& parameters)
+	{
+		uint8_t index = 0;
+		while (true)
+		{
+			skipSpaces();
+			if (index == parameters.count)
+			{
+				ScriptError::tooManyParameters();
+			}
+			const ExtCmdParamDef& param = parameters.parameters[index];
+			if (isEnd() || (m_text[m_pos] == ';'))
+			{
+				skipCmdEnd();
+				addDefaultParameters(&parameters, index);
+				return;
+			}
+			if (m_text[m_pos] == ',')
+			{
+				m_pos++;
+				if (index + 1 == parameters.count)
+				{
+					ScriptError::unexpectedCharacter();
+				}
+				addDefaultParameter(param);
+				index++;
+				continue;
+			}
+
+			if (param.is_streamed)
+			{
+				// The chunks are passed to the handler while a line is parsed, a script keeps no payload
+				ScriptError::streamedParameter();
+			}
+			switch (param.param_type) {
+			case ExtCmdParamDef::TYPE::NUM_DEC:
+			case ExtCmdParamDef::TYPE::NUM_HEX:
+			case ExtCmdParamDef::TYPE::NUM_BIN:
+			{
+				uint32_t value = getNumber(param.param_type);
+				if (!CmdParamDef::validateNumericRanges(*param.numeric_ranges, value))
+				{
+					ScriptError::valueOutOfRange();
+				}
+				addNumber(value);
+				break;
+			}
+			case ExtCmdParamDef::TYPE::STR:
+				addString(param);
+				break;
+			case ExtCmdParamDef::TYPE::STR_HEX:
+				addHexString(param);
+				break;
+			case ExtCmdParamDef::TYPE::ENUM:
+				addEnum(param);
+				break;
+			}
+			index++;
+
+			// No spaces before the separator
+			if (isEnd() || (m_text[m_pos] == ';'))
+			{
+				skipCmdEnd();
+				addDefaultParameters(&parameters, index);
+				return;
+			}
+			if (get() != ',')
+			{
+				ScriptError::unexpectedCharacter();
+			}
+			if (index == parameters.count)
+			{
+				ScriptError::tooManyParameters();
+			}
+		}
+	}
+
+	consteval uint32_t getNumber(ExtCmdParamDef::TYPE type)
+	{
+		uint32_t value = 0;
+		while (!isEnd() && (m_text[m_pos] != ',') && (m_text[m_pos] != ';'))
+		{
+			char ch = get();
+			switch (type) {
+			case ExtCmdParamDef::TYPE::NUM_DEC:
+				addDecimalDigit(value, ch);
+				break;
+			case ExtCmdParamDef::TYPE::NUM_HEX:
+			{
+				int_fast8_t hex = atcmd::detail::Characters::getHex(ch);
+				if (hex < 0)
+				{
+					ScriptError::unexpectedCharacter();
+				}
+				if (value & 0xF0000000)
+				{
+					ScriptError::valueOutOfRange();
+				}
+				value = (value << 4) | static_cast<uint32_t>(hex);
+				break;
+			}
+			default:
+				if ((ch != '0') && (ch != '1'))
+				{
+					ScriptError::unexpectedCharacter();
+				}
+				if (value & 0x80000000)
+				{
+					ScriptError::valueOutOfRange();
+				}
+				value = (value << 1) | (ch == '1');
+				break;
+			}
+		}
+		return value;
+	}
+
+	// Basic command and S-parameter values, spaces are skipped as by the parser
+	consteval uint32_t getDecimal()
+	{
+		uint32_t value = 0;
+		while (true)
+		{
+			skipSpaces();
+			if (isEnd() || !atcmd::detail::Characters::isNumeric(m_text[m_pos]))
+			{
+				return value;
+			}
+			addDecimalDigit(value, get());
+		}
+	}
+
+	static consteval void addDecimalDigit(uint32_t& value, char ch)
+	{
+		int_fast8_t dec = atcmd::detail::Characters::getNumeric(ch);
+		if (dec < 0)
+		{
+			ScriptError::unexpectedCharacter();
+		}
+		if ((value > 0x19999999) || ((value == 0x19999999) && (dec > 5)))
+		{
+			ScriptError::valueOutOfRange();
+		}
+		value = value * 10 + static_cast<uint32_t>(dec);
+	}
+
+	consteval void addString(const ExtCmdParamDef& param)
+	{
+		if (get() != '"')
+		{
+			ScriptError::unexpectedCharacter();
+		}
+		uint16_t size = 0;
+		// Taken as is, without case conversion
+		while (true)
+		{
+			if (isEnd())
+			{
+				ScriptError::unexpectedCharacter();
+			}
+			char ch = m_text[m_pos++];
+			if (ch == '"')
+			{
+				break;
+			}
+			if (size + 1 == param.string_max_len)
+			{
+				ScriptError::stringTooLong();
+			}
+			addByte(static_cast<uint8_t>(ch));
+			size++;
+		}
+		addPadding(param.string_max_len - size);
+	}
+
+	// Matched in upper case, as by the parser
+	consteval void addEnum(const ExtCmdParamDef& param)
+	{
+		if (get() != '"')
+		{
+			ScriptError::unexpectedCharacter();
+		}
+		std::size_t start = m_pos;
+		while (true)
+		{
+			if (isEnd())
+			{
+				ScriptError::unexpectedCharacter();
+			}
+			if (m_text[m_pos++] == '"')
+			{
+				break;
+			}
+		}
+		std::size_t length = m_pos - 1 - start;
+		for (uint16_t i = 0; i < param.enumeration->count; i++)
+		{
+			const char* value = param.enumeration->values[i];
+			std::size_t j = 0;
+			while ((j < length) && (value[j] == toUpper(m_text[start + j])))
+			{
+				j++;
+			}
+			if ((j == length) && (value[j] == '\0'))
+			{
+				addByte(static_cast<uint8_t>(i));
+				return;
+			}
+		}
+		ScriptError::unknownKeyword();
+	}
+
+	consteval void addHexString(const ExtCmdParamDef& param)
+	{
+		if (get() != '"')
+		{
+			ScriptError::unexpectedCharacter();
+		}
+		uint16_t size = 0;
+		bool second = false;
+		uint8_t byte = 0;
+		while (true)
+		{
+			char ch = get();
+			if ((ch == ' ') || (ch == '-'))
+			{
+				// Space and '-' may be used for formatting
+				continue;
+			}
+			if (ch == '"')
+			{
+				if (second)
+				{
+					ScriptError::unevenHexString();
+				}
+				break;
+			}
+			int_fast8_t hex = atcmd::detail::Characters::getHex(ch);
+			if (hex < 0)
+			{
+				ScriptError::unexpectedCharacter();
+			}
+			if (!second)
+			{
+				if (size == param.hexstring_max_size)
+				{
+					ScriptError::stringTooLong();
+				}
+				byte = static_cast<uint8_t>(hex << 4);
+			}
+			else
+			{
+				addByte(static_cast<uint8_t>(byte | hex));
+				size++;
+			}
+			second = !second;
+		}
+		addPadding(param.hexstring_max_size - size);
+		addByte(static_cast<uint8_t>(size));
+		addByte(static_cast<uint8_t>(size >> 8));
+	}
+
+	consteval void addDefaultParameters(const ExtCmdDef::Parameters* parameters, uint8_t index)
+	{
+		if (parameters == nullptr)
+		{
+			return;
+		}
+		for (; index < parameters->count; index++)
+		{
+			addDefaultParameter(parameters->parameters[index]);
+		}
+	}
+
+	consteval void addDefaultParameter(const ExtCmdParamDef& param)
+	{
+		if (!param.is_optional)
+		{
+			ScriptError::missingMandatoryParameter();
+		}
+		switch (param.param_type) {
+		case ExtCmdParamDef::TYPE::NUM_DEC:
+		case ExtCmdParamDef::TYPE::NUM_HEX:
+		case ExtCmdParamDef::TYPE::NUM_BIN:
+			addNumber(param.default_number);
+			break;
+		case ExtCmdParamDef::TYPE::STR:
+		{
+			uint16_t size = 0;
+			for (const char* c = param.default_string; *c != '\0'; c++)
+			{
+				addByte(static_cast<uint8_t>(*c));
+				size++;
+			}
+			addPadding(param.string_max_len - size);
+			break;
+		}
+		case ExtCmdParamDef::TYPE::STR_HEX:
+			for (uint16_t i = 0; i < param.default_hex_string->size; i++)
+			{
+				addByte(param.default_hex_string->data[i]);
+			}
+			addPadding(param.hexstring_max_size - param.default_hex_string->size);
+			addByte(static_cast<uint8_t>(param.default_hex_string->size));
+			addByte(static_cast<uint8_t>(param.default_hex_string->size >> 8));
+			break;
+		case ExtCmdParamDef::TYPE::ENUM:
+			addByte(static_cast<uint8_t>(param.default_number));
+			break;
+		}
+	}
+
+	// After a read or test command
+	consteval void skipCmdEnd()
+	{
+		skipSpaces();
+		if (!isEnd() && (get() != ';'))
+		{
+			ScriptError::unexpectedCharacter();
+		}
+	}
+
+	consteval void addCmdId(std::size_t cmd_id)
+	{
+		addByte(static_cast<uint8_t>(cmd_id));
+		addByte(static_cast<uint8_t>(cmd_id >> 8));
+	}
+
+	consteval void addNumber(uint32_t value)
+	{
+		for (std::size_t i = 0; i < sizeof(value); i++)
+		{
+			addByte(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	consteval void addPadding(std::size_t size)
+	{
+		for (std::size_t i = 0; i < size; i++)
+		{
+			addByte(0);
+		}
+	}
+
+	consteval void addByte(uint8_t byte)
+	{
+		if (m_dest != nullptr)
+		{
+			m_dest[m_size] = byte;
+		}
+		m_size++;
+	}
+
+	consteval void skipSpaces()
+	{
+		while (!isEnd() && (m_text[m_pos] == ' '))
+		{
+			m_pos++;
+		}
+	}
+
+	consteval char get()
+	{
+		if (isEnd())
+		{
+			ScriptError::unexpectedCharacter();
+		}
+		return m_text[m_pos++];
+	}
+
+	consteval bool isEnd() const
+	{
+		return m_pos == m_length;
+	}
+
+	static consteval char toUpper(char ch)
+	{
+		return atcmd::detail::Characters::isLowerAlphabetic(ch) ? static_cast<char>(ch - 'a' + 'A') : ch;
+	}
+
+	const char* m_text;
+	std::size_t m_length;
+	uint8_t* m_dest;
+	std::size_t m_pos;
+	std::size_t m_size;
+};
+
+} /* namespace atcmd::server::detail */
+
+#endif // ATCMD_SCRIPTBUILDER_H
@@ -29,6 +29,17 @@
 #include <atcmd/detail/trie.h>
 #include <atcmd/detail/basiccmddef.h>
 #include <atcmd/detail/extcmddef.h>
+#include <atcmd/detail/completionqueue.h>
+#include <atcmd/detail/coroutineframes.h>
+#include <atcmd/detail/urcqueue.h>
+#include <atcmd/server/timerwheel.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <span>
+#include <string_view>
 
 namespace atcmd::server {
 
@@ -55,9 +66,39 @@ struct CmdPosCalculator<Cmd, Cmd0, Cmds...>
 	static constexpr uint16_t pos = 1 + CmdPosCalculator<Cmd, Cmds...>::pos;
 };
 
+template<concepts::Command Cmd>
+consteval std::size_t getCmdAsyncStateSize()
+{
+	if constexpr (atcmd::server::concepts::StatefulCommand<Cmd>)
+	{
+		return sizeof(typename Cmd::Definition::AsyncState);
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+template<concepts::Command Cmd>
+consteval std::size_t getCmdAsyncStateAlignment()
+{
+	if constexpr (atcmd::server::concepts::StatefulCommand<Cmd>)
+	{
+		return alignof(typename Cmd::Definition::AsyncState);
+	}
+	else
+	{
+		return 1;
+	}
+}
+
 template<concepts::Command... Cmds>
 struct CommandList
 {
+	// The largest AsyncState of the commands, 0 if none of them has one
+	static constexpr inline std::size_t async_state_size = std::max({std::size_t{0}, getCmdAsyncStateSize<Cmds>()...});
+	static constexpr inline std::size_t async_state_alignment = std::max({std::size_t{1}, getCmdAsyncStateAlignment<Cmds>()...});
+
 	template<concepts::Command Cmd>
 	static consteval uint16_t getCommandPosition()
 	{
@@ -126,6 +167,11 @@ struct ExtendedCommandList<Cmds...> : public detail::CommandList<Cmds...>
 	static constexpr inline std::size_t size = sizeof...(Cmds);
 	static constexpr inline detail::ExtCmdDef m_ext_cmd_defs[] = {detail::ExtCmdDef::build<Cmds>()...};
 	using Trie = atcmd::detail::Trie<Cmds::Definition::name...>;
+
+	static consteval std::array<std::string_view, size> getNames()
+	{
+		return {std::string_view(Cmds::Definition::name)...};
+	}
 };
 
 namespace concepts {
@@ -141,384 +187,1794 @@ concept ServerSettings =
 	}
 	&& (T::max_commands_per_line > 0);
 
-} /* namespace concepts */
-
-namespace detail {
-
-template<atcmd::server::concepts::ServerSettings Settings>
-struct ServerCmdline : public detail::Server
-{
-protected:
-	ServerCmdline(PrintCharCallback print_char_callback, void* context = nullptr) :
-		detail::Server(print_char_callback, context)
-	{}
-
-	std::size_t getCmdlineBufSz()
+// Optional: completions can be posted from other threads and interrupts
+template<class T>
+concept CompletionQueueSettings =
+	ServerSettings<T> &&
+	requires
 	{
-		return sizeof(m_cmdline) - m_cmdline_parse_index;
+		{ T::completion_queue_size } -> std::convertible_to<std::size_t>;
 	}
+	&& (T::completion_queue_size > 0);
 
-	bool checkParameterBufferOvf(const detail::ExtCmdParamDef& param_def)
+// Optional: coroutine handlers, a frame of up to coroutine_frame_size bytes is reserved in every server
+template<class T>
+concept CoroutineSettings =
+	ServerSettings<T> &&
+	requires
 	{
-		std::size_t available = getCmdlineBufSz();
-		bool ovf;
-		switch (param_def.param_type) {
-		case detail::ExtCmdParamDef::TYPE::NUM_DEC:
-		case detail::ExtCmdParamDef::TYPE::NUM_HEX:
-		case detail::ExtCmdParamDef::TYPE::NUM_BIN:
-			ovf = available < sizeof(uint32_t);
-			break;
-		case detail::ExtCmdParamDef::TYPE::STR:
-			ovf = available < param_def.string_max_len;
-			break;
-		case detail::ExtCmdParamDef::TYPE::STR_HEX:
-			ovf = available < (param_def.hexstring_max_size + sizeof(uint16_t));
-			break;
-		}
-		return ovf;
+		{ T::coroutine_frame_size } -> std::convertible_to<std::size_t>;
 	}
+	&& (T::coroutine_frame_size > 0);
 
-	void resetCmdline()
+// Optional: a half-received command line is dropped when no character arrives within the given number
+// of timer wheel ticks
+template<class T>
+concept InterCharacterTimeoutSettings =
+	ServerSettings<T> &&
+	requires
 	{
-		m_cmdline_parse_ok_index = 0;
-		m_cmdline_parse_index = 0;
+		{ T::inter_character_timeout } -> std::convertible_to<uint32_t>;
 	}
+	&& (T::inter_character_timeout > 0);
 
-	bool addBasicCmd(uint8_t index)
+// Optional: a queue of up to urc_queue_size unsolicited result codes of up to urc_max_length characters
+template<class T>
+concept UrcSettings =
+	ServerSettings<T> &&
+	requires
 	{
-		return addCmd(getBasicCmdOffset() + index);
+		{ T::urc_queue_size } -> std::convertible_to<std::size_t>;
+		{ T::urc_max_length } -> std::convertible_to<std::size_t>;
 	}
+	&& (T::urc_queue_size > 0) && (T::urc_max_length > 0);
 
-	bool addExtCmd(uint16_t cmd_index, CMD_TYPE cmd_type)
+// Optional: macro_slot_count slots keeping encoded command lines of up to macro_max_size bytes for replay
+template<class T>
+concept MacroSettings =
+	ServerSettings<T> &&
+	requires
 	{
-		uint16_t cmd_id = (cmd_index << 2) | static_cast<uint16_t>(cmd_type);
-		return addCmd(cmd_id);
+		{ T::macro_slot_count } -> std::convertible_to<std::size_t>;
+		{ T::macro_max_size } -> std::convertible_to<std::size_t>;
 	}
+	&& (T::macro_slot_count > 0) && (T::macro_max_size > 0);
 
-	bool addByteParameter()
+} /* namespace concepts */
+
+namespace detail {
+
+// True if any command of the settings has the flag set
+template<class Settings>
+consteval bool hasCommands(bool BasicCmdDef::* basic_flag, bool (ExtCmdDef::* ext_flag)() const)
+{
+	bool r = false;
+	if constexpr (Settings::BasicCommands::size != 0)
 	{
-		if (getCmdlineBufSz() == 0)
+		for (const BasicCmdDef& def : Settings::BasicCommands::m_cmd_defs)
 		{
-			// Buffer overflow
-			return false;
+			r |= def.*basic_flag;
 		}
-		m_cmdline[m_cmdline_parse_index++] = m_param_value_num & 0xFF;
-		return true;
 	}
-
-	bool addNumericParameter(const detail::ExtCmdDef& cmd_def)
+	if constexpr (Settings::AmpersandCommands::size != 0)
 	{
-		const detail::ExtCmdParamDef& param = cmd_def.getParameters()->parameters[m_param_index];
-		return
-				detail::BasicCmdDef::validateNumericRanges(*param.numeric_ranges, m_param_value_num) &&
-				addNumericParameter_();
+		for (const BasicCmdDef& def : Settings::AmpersandCommands::m_cmd_defs)
+		{
+			r |= def.*basic_flag;
+		}
 	}
-
-	bool addNumericParameter(const detail::BasicCmdDef& cmd_def)
+	if constexpr (Settings::ExtendedCommands::size != 0)
 	{
-		return
-				detail::BasicCmdDef::validateNumericRanges(*cmd_def.numeric_ranges, m_param_value_num) &&
-				addNumericParameter_();
+		for (const ExtCmdDef& def : Settings::ExtendedCommands::m_ext_cmd_defs)
+		{
+			r |= (def.*ext_flag)();
+		}
 	}
+	return r;
+}
 
-	void addChar(char ch)
+template<class Settings>
+consteval bool usesTimer()
+{
+	return
+			atcmd::server::concepts::InterCharacterTimeoutSettings<Settings> ||
+			hasCommands<Settings>(&BasicCmdDef::timed, &ExtCmdDef::isTimed);
+}
+
+template<bool uses_timer>
+struct ServerTimerHolder
+{
+	TimerWheel::Timer m_timer;
+	TimerWheel* m_timer_wheel = nullptr;
+};
+
+template<>
+struct ServerTimerHolder<false>
+{};
+
+template<std::size_t frame_size>
+struct ServerCoroutineFramesHolder
+{
+	CoroutineFrames<frame_size> m_coroutine_frames;
+};
+
+template<>
+struct ServerCoroutineFramesHolder<0>
+{};
+
+template<class Settings>
+consteval std::size_t getCoroutineFrameSize()
+{
+	if constexpr (atcmd::server::concepts::CoroutineSettings<Settings>)
 	{
-		m_cmdline[m_cmdline_parse_index++] = ch;
+		return Settings::coroutine_frame_size;
 	}
-
-	void addByte(uint8_t byte)
+	else
 	{
-		m_cmdline[m_cmdline_parse_index++] = byte;
+		return 0;
 	}
+}
 
-	bool addDefaultNumericParameter(const detail::ExtCmdDef& cmd_def)
+// Commands of the line started ahead of their turn, in line order. What their requests print is kept
+// until they reach the head of the line
+template<std::size_t count, std::size_t output_buffer_size>
+struct ServerConcurrentCmdsHolder
+{
+	static_assert((output_buffer_size != 0) && (output_buffer_size <= 0xFFFF),
+			"Invalid output buffer size of started commands");
+
+	struct StartedCmd
 	{
-		const auto& p = cmd_def.getParameters()->parameters[m_param_index];
-		if (!p.is_optional)
-		{
-			return false;
-		}
-		addDefaultNumericParameter_(p);
-		return true;
-	}
+		uint16_t exec_index;
+		uint16_t next_exec_index;
+		// Size of the request output in m_started_output
+		uint16_t output_size;
+		RESULT_CODE result_code;
+		// Updates received before the command reached the head of the line
+		uint8_t updates;
+		// Slot of the AsyncState storage of the command
+		uint8_t async_state_slot;
+	};
 
-	bool addDefaultStringParameter(const detail::ExtCmdDef& cmd_def)
+	StartedCmd m_started_cmds[count];
+	uint8_t m_started_cmd_count = 0;
+	uint8_t m_head_updates = 0;
+	uint16_t m_started_output_size = 0;
+	char m_started_output[output_buffer_size];
+};
+
+template<>
+struct ServerConcurrentCmdsHolder<0, 0>
+{};
+
+template<class Settings>
+consteval std::size_t getConcurrentCmdSlotCount()
+{
+	return
+			hasCommands<Settings>(&BasicCmdDef::concurrent, &ExtCmdDef::isConcurrent) ?
+				Settings::max_commands_per_line - 1 :
+				0;
+}
+
+template<class Settings>
+consteval std::size_t getConcurrentOutputSize()
+{
+	if constexpr (getConcurrentCmdSlotCount<Settings>() == 0)
 	{
-		const auto& p = cmd_def.getParameters()->parameters[m_param_index];
-		if (!p.is_optional)
-		{
-			return false;
-		}
-		addDefaultStringParameter_(p);
-		return true;
+		return 0;
 	}
-
-	bool addDefaultHexStringParameter(const detail::ExtCmdDef& cmd_def)
+	else if constexpr (requires { { Settings::concurrent_output_size } -> std::convertible_to<std::size_t>; })
 	{
-		const auto& p = cmd_def.getParameters()->parameters[m_param_index];
-		if (!p.is_optional)
-		{
-			return false;
-		}
-		addDefaultHexStringParameter_(p);
-		return true;
+		return Settings::concurrent_output_size;
 	}
-
-	void finalizeString(uint16_t size_left)
+	else
 	{
-		m_cmdline[m_cmdline_parse_index++] = '\0';
-		m_cmdline_parse_index += size_left - 1;
-		m_param_index++;
+		return 64;
 	}
+}
 
-	void finalizeHexString(uint16_t size_left, uint16_t size_full)
+// AsyncState storage of each command that can be in progress at the same time
+template<std::size_t size, std::size_t alignment, std::size_t count>
+struct ServerAsyncStatesHolder
+{
+	static constexpr std::size_t async_state_stride = (size + alignment - 1) / alignment * alignment;
+
+	alignas(alignment) uint8_t m_async_states[async_state_stride * count];
+	// Slot of the command being executed
+	uint8_t m_async_state_slot = 0;
+};
+
+template<std::size_t alignment, std::size_t count>
+struct ServerAsyncStatesHolder<0, alignment, count>
+{};
+
+template<class List>
+consteval std::size_t getListAsyncStateSize()
+{
+	if constexpr (List::size != 0)
 	{
-		uint16_t size = size_full - size_left;
-		m_cmdline_parse_index += size_left;
-		m_cmdline[m_cmdline_parse_index++] = size & 0xFF;
-		m_cmdline[m_cmdline_parse_index++] = (size >> 8) & 0xFF;
-		m_param_index++;
+		return List::async_state_size;
 	}
-
-	void finalizeBasicCmd()
+	else
 	{
-		m_cmdline_parse_ok_index = m_cmdline_parse_index;
+		return 0;
 	}
+}
 
-	bool finalizeExtCmd(const detail::ExtCmdDef& cmd_def)
+template<class List>
+consteval std::size_t getListAsyncStateAlignment()
+{
+	if constexpr (List::size != 0)
 	{
-		while (m_param_index != cmd_def.getParameters()->count)
-		{
-			const auto& p = cmd_def.getParameters()->parameters[m_param_index];
-			if (!p.is_optional || checkParameterBufferOvf(p))
-			{
-				return false;
-			}
-			switch (p.param_type) {
-			case detail::ExtCmdParamDef::TYPE::NUM_DEC:
-			case detail::ExtCmdParamDef::TYPE::NUM_HEX:
-			case detail::ExtCmdParamDef::TYPE::NUM_BIN:
-				addDefaultNumericParameter_(p);
-				break;
-			case detail::ExtCmdParamDef::TYPE::STR:
-				addDefaultStringParameter_(p);
-				break;
-			case detail::ExtCmdParamDef::TYPE::STR_HEX:
-				addDefaultHexStringParameter_(p);
-				break;
-			default:
-				break;
-			}
-		}
-		m_cmdline_parse_ok_index = m_cmdline_parse_index;
-		return true;
+		return List::async_state_alignment;
 	}
-
-	void startCmdExec(bool error)
+	else
 	{
-		m_cmdline_exec_index = 0;
-		m_last_result_code = RESULT_CODE::OK;
-		m_error = error;
+		return 1;
 	}
+}
 
-	bool continueCmdExec()
+template<class Settings>
+consteval std::size_t getAsyncStateSize()
+{
+	return std::max({
+			getListAsyncStateSize<typename Settings::BasicCommands>(),
+			getListAsyncStateSize<typename Settings::AmpersandCommands>(),
+			getListAsyncStateSize<typename Settings::ExtendedCommands>()});
+}
+
+template<class Settings>
+consteval std::size_t getAsyncStateAlignment()
+{
+	return std::max({
+			getListAsyncStateAlignment<typename Settings::BasicCommands>(),
+			getListAsyncStateAlignment<typename Settings::AmpersandCommands>(),
+			getListAsyncStateAlignment<typename Settings::ExtendedCommands>()});
+}
+
+template<class Settings>
+consteval bool hasDataModeCommands()
+{
+	bool r = false;
+	if constexpr (Settings::ExtendedCommands::size != 0)
 	{
-		while (m_cmdline_exec_index != m_cmdline_parse_ok_index)
-		{
-			uint16_t cmd_id = getCurrentCmdId();
-			Command::ServerHandle::CALL_TYPE call_type =
-					m_last_result_code == RESULT_CODE::ASYNC ?
-						BasicCommandBase::BasicServerHandle::CALL_TYPE::RESPONSE :
-						BasicCommandBase::BasicServerHandle::CALL_TYPE::REQUEST;
-			if constexpr ((Settings::BasicCommands::size != 0) || (Settings::AmpersandCommands::size != 0))
-			{
-				if constexpr (Settings::ExtendedCommands::size != 0)
-				{
-					if (cmd_id >= getBasicCmdOffset())
-					{
-						uint16_t cmd_index = cmd_id - getBasicCmdOffset();
-						execBasicCmd(cmd_index, call_type);
-					}
-					else
-					{
-						uint16_t cmd_index = cmd_id >> 2;
-						CMD_TYPE cmd_type = static_cast<CMD_TYPE>(cmd_id & 0x03);
-						execExtendedCmd(cmd_index, cmd_type, call_type);
-					}
-				}
-				else
-				{
-					uint16_t cmd_index = cmd_id - getBasicCmdOffset();
-					execBasicCmd(cmd_index, call_type);
-				}
-			}
-			else
-			{
-				if constexpr (Settings::ExtendedCommands::size != 0)
-				{
-					uint16_t cmd_index = cmd_id >> 2;
-					CMD_TYPE cmd_type = static_cast<CMD_TYPE>(cmd_id & 0x03);
-					execExtendedCmd(cmd_index, cmd_type, call_type);
-				}
-			}
-
-			if (m_last_result_code == RESULT_CODE::ERROR)
-			{
-				m_error = true;
-				break;
-			}
-			if (m_last_result_code == RESULT_CODE::ASYNC)
-			{
-				return false;
-			}
-		}
-		if (m_error)
+		for (const ExtCmdDef& def : Settings::ExtendedCommands::m_ext_cmd_defs)
 		{
-			m_last_result_code = RESULT_CODE::ERROR;
+			r |= def.isDataMode();
 		}
-		printResultCode(m_last_result_code);
-		return true;
 	}
+	return r;
+}
 
-	bool continueCmdExec(uint16_t cmd_id)
+// Progress of the raw payload of the command in data mode
+template<bool has_data_mode_commands>
+struct ServerDataModeHolder
+{
+	// nullptr in command mode
+	const ExtCmdDef::DataMode* m_data_mode = nullptr;
+	uint32_t m_data_remaining = 0;
+	uint8_t m_data_escape_matched = 0;
+};
+
+template<>
+struct ServerDataModeHolder<false>
+{};
+
+template<class Settings>
+consteval bool hasStreamedCommands()
+{
+	bool r = false;
+	if constexpr (Settings::ExtendedCommands::size != 0)
 	{
-		if (cmd_id != getCurrentCmdId())
+		for (const ExtCmdDef& def : Settings::ExtendedCommands::m_ext_cmd_defs)
 		{
-			return false;
+			r |= def.isStreamed();
 		}
-		return continueCmdExec();
 	}
+	return r;
+}
 
-	bool abortCmdExec()
+// Progress of the streamed parameter being parsed, its current chunk is collected in the command line
+template<bool has_streamed_commands>
+struct ServerStreamHolder
+{
+	const ExtCmdParamDef* m_stream_param = nullptr;
+	uint32_t m_stream_size = 0;
+	uint16_t m_stream_fill = 0;
+
+	// The command being parsed has passed chunks to its handler
+	bool m_stream_started = false;
+};
+
+template<>
+struct ServerStreamHolder<false>
+{};
+
+template<std::size_t count, std::size_t max_length>
+struct ServerUrcQueueHolder
+{
+	UrcQueue<count, max_length> m_urcs;
+};
+
+template<>
+struct ServerUrcQueueHolder<0, 0>
+{};
+
+template<class Settings>
+consteval std::size_t getUrcQueueSize()
+{
+	if constexpr (atcmd::server::concepts::UrcSettings<Settings>)
+	{
+		return Settings::urc_queue_size;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+template<class Settings>
+consteval std::size_t getUrcMaxLength()
+{
+	if constexpr (atcmd::server::concepts::UrcSettings<Settings>)
+	{
+		return Settings::urc_max_length;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+// Encoded command lines, stored in the same layout as the command line buffer
+template<std::size_t count, std::size_t max_size>
+struct ServerMacroSlotsHolder
+{
+	struct MacroSlot
+	{
+		uint16_t size;
+		bool is_stored;
+		uint8_t data[max_size];
+	};
+
+	MacroSlot m_macros[count]{};
+};
+
+template<>
+struct ServerMacroSlotsHolder<0, 0>
+{};
+
+template<class Settings>
+consteval std::size_t getMacroSlotCount()
+{
+	if constexpr (atcmd::server::concepts::MacroSettings<Settings>)
+	{
+		return Settings::macro_slot_count;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+template<class Settings>
+consteval std::size_t getMacroMaxSize()
+{
+	if constexpr (atcmd::server::concepts::MacroSettings<Settings>)
+	{
+		return Settings::macro_max_size;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+template<class Settings>
+consteval std::size_t getOffloadOutputSize()
+{
+	if constexpr (!hasCommands<Settings>(&BasicCmdDef::offloadable, &ExtCmdDef::isOffloadable))
+	{
+		return 0;
+	}
+	else if constexpr (requires { { Settings::offload_output_size } -> std::convertible_to<std::size_t>; })
+	{
+		return Settings::offload_output_size;
+	}
+	else
+	{
+		return 256;
+	}
+}
+
+// The executor of offloadable handlers. Their output is captured on the executor thread and printed
+// on the server thread once they return
+template<std::size_t output_size>
+struct ServerOffloadHolder
+{
+	static_assert(output_size <= 0xFFFF, "The offloaded output buffer is too big");
+
+	ExecuteCallback m_execute_callback = nullptr;
+	void* m_executor_context = nullptr;
+	WakeCallback m_wake_callback = nullptr;
+	void* m_wake_context = nullptr;
+
+	OutputRecorder m_offload_output = {};
+	bool m_is_offloaded = false;
+	std::atomic<bool> m_offload_done = false;
+	char m_offload_output_data[output_size];
+};
+
+template<>
+struct ServerOffloadHolder<0>
+{};
+
+template<std::size_t size>
+struct ServerCompletionQueueHolder
+{
+	CompletionQueue<size> m_completions;
+};
+
+template<>
+struct ServerCompletionQueueHolder<0>
+{};
+
+template<class Settings>
+consteval std::size_t getCompletionQueueSize()
+{
+	if constexpr (atcmd::server::concepts::CompletionQueueSettings<Settings>)
+	{
+		return Settings::completion_queue_size;
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+template<class Settings>
+class ScriptBuilder;
+
+} /* namespace detail */
+
+template<class Settings>
+struct MacroCommand;
+
+template<atcmd::server::concepts::ServerSettings Settings>
+class FrameEncoder;
+
+namespace detail {
+
+template<atcmd::server::concepts::ServerSettings Settings>
+struct ServerCmdline :
+		public detail::Server,
+		protected ServerCompletionQueueHolder<getCompletionQueueSize<Settings>()>,
+		private ServerCoroutineFramesHolder<getCoroutineFrameSize<Settings>()>,
+		protected ServerTimerHolder<usesTimer<Settings>()>,
+		private ServerConcurrentCmdsHolder<getConcurrentCmdSlotCount<Settings>(), getConcurrentOutputSize<Settings>()>,
+		private ServerAsyncStatesHolder<
+				getAsyncStateSize<Settings>(),
+				getAsyncStateAlignment<Settings>(),
+				1 + getConcurrentCmdSlotCount<Settings>()>,
+		private ServerDataModeHolder<hasDataModeCommands<Settings>()>,
+		private ServerStreamHolder<hasStreamedCommands<Settings>()>,
+		protected ServerUrcQueueHolder<getUrcQueueSize<Settings>(), getUrcMaxLength<Settings>()>,
+		private ServerMacroSlotsHolder<getMacroSlotCount<Settings>(), getMacroMaxSize<Settings>()>,
+		private ServerOffloadHolder<getOffloadOutputSize<Settings>()>
+{
+	// Encodes command lines at compile time the same way
+	template<class>
+	friend class ScriptBuilder;
+
+	// Encodes binary frames on the host
+	template<atcmd::server::concepts::ServerSettings>
+	friend class atcmd::server::FrameEncoder;
+
+	// Stores and expands macros from a running line
+	template<class>
+	friend struct atcmd::server::MacroCommand;
+
+protected:
+	ServerCmdline(PrintCharCallback print_char_callback, void* context = nullptr) :
+		detail::Server(print_char_callback, context),
+		m_response_cache{}
+	{}
+
+	std::size_t getCmdlineBufSz()
+	{
+		return sizeof(m_cmdline) - m_cmdline_parse_index;
+	}
+
+	bool checkParameterBufferOvf(const detail::ExtCmdParamDef& param_def)
+	{
+		return getCmdlineBufSz() < param_def.getParseSize();
+	}
+
+	void resetCmdline()
+	{
+		m_cmdline_parse_ok_index = 0;
+		m_cmdline_parse_index = 0;
+	}
+
+	// A line encoded by ScriptBuilder, executed without parsing
+	void loadCmdline(const uint8_t* data, std::size_t size)
+	{
+		std::memcpy(m_cmdline, data, size);
+		m_cmdline_parse_index = static_cast<uint16_t>(size);
+		m_cmdline_parse_ok_index = m_cmdline_parse_index;
+	}
+
+	// The chunks of streamed parameters are passed while the line is parsed, such a line can not be replayed
+	bool hasStreamedCmds(std::size_t start) const
+	{
+		if constexpr (has_streamed_commands)
+		{
+			for (std::size_t i = start; i != m_cmdline_parse_ok_index; i = getNextExecIndex(i))
+			{
+				if (isStreamedCmd(i))
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// A binary frame of extended commands in the layout of the command line. The commands are checked and
+	// loaded up to the first invalid one, false if there is one
+	bool loadFrame(const uint8_t* data, std::size_t size)
+	{
+		resetCmdline();
+		std::size_t i = 0;
+		while (i != size)
+		{
+			std::size_t cmd_size = getFrameCmdSize(&data[i], size - i);
+			if ((cmd_size == 0) || (cmd_size > getCmdlineBufSz()))
+			{
+				return false;
+			}
+			std::memcpy(&m_cmdline[m_cmdline_parse_index], &data[i], cmd_size);
+			m_cmdline_parse_index += cmd_size;
+			m_cmdline_parse_ok_index = m_cmdline_parse_index;
+			i += cmd_size;
+		}
+		return true;
+	}
+
+	static constexpr std::size_t macro_slot_count = getMacroSlotCount<Settings>();
+	static constexpr std::size_t macro_max_size = getMacroMaxSize<Settings>();
+
+	bool storeMacro(std::size_t slot, const uint8_t* data, std::size_t size) requires (macro_slot_count != 0)
+	{
+		if ((slot >= macro_slot_count) || (size > macro_max_size))
+		{
+			return false;
+		}
+		auto& macro = this->m_macros[slot];
+		std::memcpy(macro.data, data, size);
+		macro.size = static_cast<uint16_t>(size);
+		macro.is_stored = true;
+		return true;
+	}
+
+	// The last received line, unless it failed to parse or streamed a parameter
+	bool storeReceivedLine(std::size_t slot) requires (macro_slot_count != 0)
+	{
+		if (m_error || hasStreamedCmds(0))
+		{
+			return false;
+		}
+		return storeMacro(slot, m_cmdline, m_cmdline_parse_ok_index);
+	}
+
+	bool loadMacro(std::size_t slot) requires (macro_slot_count != 0)
+	{
+		if ((slot >= macro_slot_count) || !this->m_macros[slot].is_stored)
+		{
+			return false;
+		}
+		loadCmdline(this->m_macros[slot].data, this->m_macros[slot].size);
+		return true;
+	}
+
+	void clearMacro(std::size_t slot) requires (macro_slot_count != 0)
+	{
+		if (slot < macro_slot_count)
+		{
+			this->m_macros[slot].is_stored = false;
+		}
+	}
+
+	bool isMacroStored(std::size_t slot) const requires (macro_slot_count != 0)
+	{
+		return (slot < macro_slot_count) && this->m_macros[slot].is_stored;
+	}
+
+	std::span<const uint8_t> getMacro(std::size_t slot) const requires (macro_slot_count != 0)
+	{
+		if (!isMacroStored(slot))
+		{
+			return {};
+		}
+		return std::span<const uint8_t>(this->m_macros[slot].data, this->m_macros[slot].size);
+	}
+
+	// Moves the rest of the executing line, after the current command, to a macro slot. The rest is not executed
+	bool storeLineTail(std::size_t slot) requires (macro_slot_count != 0)
+	{
+		uint16_t start = getNextExecIndex(m_cmdline_exec_index);
+		if (hasStreamedCmds(start) || !storeMacro(slot, &m_cmdline[start], m_cmdline_parse_ok_index - start))
+		{
+			return false;
+		}
+		m_cmdline_parse_ok_index = start;
+		m_cmdline_parse_index = start;
+		return true;
+	}
+
+	// Inserts a macro after the current command of the executing line, it runs before the rest of the line
+	bool expandMacro(std::size_t slot) requires (macro_slot_count != 0)
+	{
+		if (!isMacroStored(slot))
+		{
+			return false;
+		}
+		const auto& macro = this->m_macros[slot];
+		if (m_cmdline_parse_ok_index + macro.size > sizeof(m_cmdline))
+		{
+			// Buffer overflow
+			return false;
+		}
+		uint16_t start = getNextExecIndex(m_cmdline_exec_index);
+		std::memmove(&m_cmdline[start + macro.size], &m_cmdline[start], m_cmdline_parse_ok_index - start);
+		std::memcpy(&m_cmdline[start], macro.data, macro.size);
+		m_cmdline_parse_ok_index += macro.size;
+		m_cmdline_parse_index = m_cmdline_parse_ok_index;
+		return true;
+	}
+
+	bool addBasicCmd(uint8_t index)
+	{
+		return addCmd(getBasicCmdOffset() + index);
+	}
+
+	bool addExtCmd(uint16_t cmd_index, CMD_TYPE cmd_type)
+	{
+		uint16_t cmd_id = (cmd_index << 2) | static_cast<uint16_t>(cmd_type);
+		return addCmd(cmd_id);
+	}
+
+	bool addByteParameter()
+	{
+		if (getCmdlineBufSz() == 0)
+		{
+			// Buffer overflow
+			return false;
+		}
+		m_cmdline[m_cmdline_parse_index++] = m_param_value_num & 0xFF;
+		return true;
+	}
+
+	bool addNumericParameter(const detail::ExtCmdDef& cmd_def)
+	{
+		const detail::ExtCmdParamDef& param = cmd_def.getParameters()->parameters[m_param_index];
+		return
+				detail::BasicCmdDef::validateNumericRanges(*param.numeric_ranges, m_param_value_num) &&
+				addNumericParameter_();
+	}
+
+	bool addNumericParameter(const detail::BasicCmdDef& cmd_def)
+	{
+		return
+				detail::BasicCmdDef::validateNumericRanges(*cmd_def.numeric_ranges, m_param_value_num) &&
+				addNumericParameter_();
+	}
+
+	void addChar(char ch)
+	{
+		m_cmdline[m_cmdline_parse_index++] = ch;
+	}
+
+	void addByte(uint8_t byte)
+	{
+		m_cmdline[m_cmdline_parse_index++] = byte;
+	}
+
+	bool addDefaultNumericParameter(const detail::ExtCmdDef& cmd_def)
+	{
+		const auto& p = cmd_def.getParameters()->parameters[m_param_index];
+		if (!p.is_optional)
+		{
+			return false;
+		}
+		addDefaultNumericParameter_(p);
+		return true;
+	}
+
+	bool addDefaultStringParameter(const detail::ExtCmdDef& cmd_def)
+	{
+		const auto& p = cmd_def.getParameters()->parameters[m_param_index];
+		if (!p.is_optional)
+		{
+			return false;
+		}
+		addDefaultStringParameter_(p);
+		return true;
+	}
+
+	bool addDefaultHexStringParameter(const detail::ExtCmdDef& cmd_def)
+	{
+		const auto& p = cmd_def.getParameters()->parameters[m_param_index];
+		if (!p.is_optional)
+		{
+			return false;
+		}
+		addDefaultHexStringParameter_(p);
+		return true;
+	}
+
+	bool addDefaultEnumParameter(const detail::ExtCmdDef& cmd_def)
+	{
+		const auto& p = cmd_def.getParameters()->parameters[m_param_index];
+		if (!p.is_optional)
+		{
+			return false;
+		}
+		addDefaultEnumParameter_(p);
+		return true;
+	}
+
+	// m_param_value_num is the index of the matched keyword
+	void addEnumParameter()
+	{
+		m_cmdline[m_cmdline_parse_index++] = m_param_value_num & 0xFF;
+		m_param_index++;
+	}
+
+	void finalizeString(uint16_t size_left)
+	{
+		m_cmdline[m_cmdline_parse_index++] = '\0';
+		m_cmdline_parse_index += size_left - 1;
+		m_param_index++;
+	}
+
+	void finalizeHexString(uint16_t size_left, uint16_t size_full)
+	{
+		uint16_t size = size_full - size_left;
+		m_cmdline_parse_index += size_left;
+		m_cmdline[m_cmdline_parse_index++] = size & 0xFF;
+		m_cmdline[m_cmdline_parse_index++] = (size >> 8) & 0xFF;
+		m_param_index++;
+	}
+
+	static constexpr bool has_streamed_commands = hasStreamedCommands<Settings>();
+
+	void startStream(const detail::ExtCmdParamDef& param_def) requires has_streamed_commands
+	{
+		this->m_stream_param = &param_def;
+		this->m_stream_size = 0;
+		this->m_stream_fill = 0;
+	}
+
+	// The chunk is collected in place of the parameter and passed to the handler when it is full
+	bool addStreamByte(uint8_t byte) requires has_streamed_commands
+	{
+		const detail::ExtCmdParamDef::Stream& stream = *this->m_stream_param->stream;
+		if (this->m_stream_size == stream.max_size)
+		{
+			return false;
+		}
+		m_cmdline[m_cmdline_parse_index + this->m_stream_fill++] = byte;
+		this->m_stream_size++;
+		if (this->m_stream_fill == stream.chunk_size)
+		{
+			flushStream();
+		}
+		return true;
+	}
+
+	// The rest of the chunk is passed and the total size is left for the write handler
+	void finalizeStream() requires has_streamed_commands
+	{
+		flushStream();
+		uint32_t size = this->m_stream_size;
+		for (std::size_t i = 0; i < sizeof(uint32_t); i++)
+		{
+			m_cmdline[m_cmdline_parse_index++] = (size >> (8 * i)) & 0xFF;
+		}
+		m_param_index++;
+	}
+
+	// The line is dropped while being received: the command receiving chunks is told to discard them
+	void abortStream()
+	{
+		if constexpr (has_streamed_commands)
+		{
+			if (this->m_stream_started)
+			{
+				this->m_stream_started = false;
+				passStream(m_cmdline_parse_ok_index, Command::ServerHandle::CALL_TYPE::ABORT, nullptr, 0);
+			}
+		}
+	}
+
+	void finalizeBasicCmd()
+	{
+		m_cmdline_parse_ok_index = m_cmdline_parse_index;
+	}
+
+	bool finalizeExtCmd(const detail::ExtCmdDef& cmd_def)
+	{
+		while (m_param_index != cmd_def.getParameters()->count)
+		{
+			const auto& p = cmd_def.getParameters()->parameters[m_param_index];
+			if (!p.is_optional || checkParameterBufferOvf(p))
+			{
+				return false;
+			}
+			switch (p.param_type) {
+			case detail::ExtCmdParamDef::TYPE::NUM_DEC:
+			case detail::ExtCmdParamDef::TYPE::NUM_HEX:
+			case detail::ExtCmdParamDef::TYPE::NUM_BIN:
+				addDefaultNumericParameter_(p);
+				break;
+			case detail::ExtCmdParamDef::TYPE::STR:
+				addDefaultStringParameter_(p);
+				break;
+			case detail::ExtCmdParamDef::TYPE::STR_HEX:
+				addDefaultHexStringParameter_(p);
+				break;
+			case detail::ExtCmdParamDef::TYPE::ENUM:
+				addDefaultEnumParameter_(p);
+				break;
+			default:
+				break;
+			}
+		}
+		if constexpr (has_streamed_commands)
+		{
+			this->m_stream_started = false;
+		}
+		m_cmdline_parse_ok_index = m_cmdline_parse_index;
+		return true;
+	}
+
+	void startCmdExec(bool error)
+	{
+		if constexpr (uses_timer)
+		{
+			// The inter-character timeout
+			cancelTimer();
+		}
+		m_cmdline_exec_index = 0;
+		m_last_result_code = RESULT_CODE::OK;
+		m_error = error;
+		if constexpr (has_concurrent_commands)
+		{
+			this->m_started_cmd_count = 0;
+			this->m_head_updates = 0;
+			this->m_started_output_size = 0;
+		}
+	}
+
+	bool continueCmdExec()
+	{
+		while (m_cmdline_exec_index != m_cmdline_parse_ok_index)
+		{
+			uint16_t cmd_id = getCurrentCmdId();
+			Command::ServerHandle::CALL_TYPE call_type =
+					m_last_result_code == RESULT_CODE::ASYNC ?
+						BasicCommandBase::BasicServerHandle::CALL_TYPE::RESPONSE :
+						BasicCommandBase::BasicServerHandle::CALL_TYPE::REQUEST;
+
+			if constexpr (has_concurrent_commands)
+			{
+				if ((call_type == Command::ServerHandle::CALL_TYPE::REQUEST) &&
+					(this->m_started_cmd_count != 0) &&
+					(this->m_started_cmds[0].exec_index == m_cmdline_exec_index))
+				{
+					// Started while an earlier command was running, now its responses can be printed
+					auto started = popStartedCmd();
+					setAsyncStateSlot(started.async_state_slot);
+					m_last_result_code = started.result_code;
+					if (started.result_code != RESULT_CODE::ASYNC)
+					{
+						m_cmdline_exec_index = started.next_exec_index;
+						if (started.result_code == RESULT_CODE::ERROR)
+						{
+							m_error = true;
+							break;
+						}
+						continue;
+					}
+					if constexpr (uses_timer)
+					{
+						updateCmdTimer(cmd_id, Command::ServerHandle::CALL_TYPE::REQUEST);
+					}
+					if (started.updates == 0)
+					{
+						startConcurrentCmds();
+						return false;
+					}
+					this->m_head_updates = started.updates - 1;
+					call_type = Command::ServerHandle::CALL_TYPE::RESPONSE;
+				}
+			}
+
+			if constexpr (has_offloadable_commands)
+			{
+				if ((call_type == Command::ServerHandle::CALL_TYPE::REQUEST) && isOffloadable(cmd_id) && hasExecutor())
+				{
+					// The line is resumed by finishOffloadedCmdExec() on the server thread
+					this->m_offload_output =
+					{
+						.data = this->m_offload_output_data,
+						.capacity = static_cast<uint16_t>(sizeof(this->m_offload_output_data)),
+						.size = 0,
+						.overflow = false,
+						.is_capturing = true
+					};
+					setOutputRecorder(&this->m_offload_output);
+					this->m_is_offloaded = true;
+					this->m_execute_callback(&ServerCmdline::runOffloadedCmd, this, this->m_executor_context);
+					return false;
+				}
+			}
+
+			execCmd(cmd_id, call_type);
+
+			if constexpr (uses_timer)
+			{
+				updateCmdTimer(cmd_id, call_type);
+			}
+
+			if (m_last_result_code == RESULT_CODE::ERROR)
+			{
+				m_error = true;
+				break;
+			}
+			if (m_last_result_code == RESULT_CODE::ASYNC)
+			{
+				if constexpr (has_concurrent_commands)
+				{
+					if (this->m_head_updates != 0)
+					{
+						this->m_head_updates--;
+						continue;
+					}
+					startConcurrentCmds();
+				}
+				return false;
+			}
+		}
+		return endCmdExec();
+	}
+
+	// Runs the last line again for A/. A line that streamed a parameter fails without running a command as its
+	// payload is gone; it is kept, so the next A/ fails too
+	void startRepeatedCmdExec()
+	{
+		bool is_streamed = hasStreamedCmds(0);
+		startCmdExec(is_streamed);
+		if (is_streamed)
+		{
+			m_cmdline_exec_index = m_cmdline_parse_ok_index;
+		}
+	}
+
+	// Prints the final result code of the line
+	bool endCmdExec()
+	{
+		if (m_error)
+		{
+			if constexpr (has_concurrent_commands)
+			{
+				// The rest of the line is not executed
+				abortStartedCmds();
+			}
+			if constexpr (has_streamed_commands)
+			{
+				abortSkippedStreams();
+			}
+			m_last_result_code = RESULT_CODE::ERROR;
+		}
+		printResultCode(m_last_result_code);
+		return true;
+	}
+
+	bool continueCmdExec(uint16_t cmd_id)
+	{
+		if (isOffloaded() || isDataMode())
+		{
+			// Resumed when the handler returns or after the payload
+			return false;
+		}
+		if (cmd_id != getCurrentCmdId())
+		{
+			if constexpr (has_concurrent_commands)
+			{
+				deferStartedCmdUpdate(cmd_id);
+			}
+			return false;
+		}
+		return continueCmdExec();
+	}
+
+	bool abortCmdExec()
+	{
+		if (isOffloaded())
+		{
+			// A blocking handler can not be interrupted
+			return false;
+		}
+		if constexpr (has_data_mode_commands)
+		{
+			this->m_data_mode = nullptr;
+		}
+
+		if constexpr (has_concurrent_commands)
+		{
+			abortStartedCmds();
+		}
+		execCmd(getCurrentCmdId(), Command::ServerHandle::CALL_TYPE::ABORT);
+
+		if (m_last_result_code == RESULT_CODE::ASYNC)
+		{
+			return false;
+		}
+		if constexpr (uses_timer)
+		{
+			cancelTimer();
+		}
+		printResultCode(m_last_result_code);
+		return true;
+	}
+
+	static constexpr bool uses_timer = usesTimer<Settings>();
+
+	static constexpr bool has_offloadable_commands = hasCommands<Settings>(&BasicCmdDef::offloadable, &ExtCmdDef::isOffloadable);
+
+	// Prints the queued URCs, each with a single write
+	void printUrcs() requires (atcmd::server::concepts::UrcSettings<Settings>)
+	{
+		const ResponseFraming& framing = getCommunicationParameters().getResponseFraming();
+		char buf[2 * ResponseFraming::max_framing_size + Settings::urc_max_length];
+		while (!this->m_urcs.isEmpty())
+		{
+			std::size_t size = 0;
+			for (std::string_view part : {framing.getInformationTextHeader(), this->m_urcs.front(), framing.getInformationTextTrailer()})
+			{
+				std::memcpy(&buf[size], part.data(), part.size());
+				size += part.size();
+			}
+			printBuffer(buf, size);
+			this->m_urcs.pop();
+		}
+	}
+
+	static constexpr bool has_data_mode_commands = hasDataModeCommands<Settings>();
+
+	bool isDataMode() const
+	{
+		if constexpr (has_data_mode_commands)
+		{
+			return this->m_data_mode != nullptr;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	// Passes received bytes to the command in data mode and returns how many belong to the payload. Data mode
+	// is left after the last byte, the command then waits for its response call like an asynchronous one
+	std::size_t feedData(const char* data, std::size_t size) requires (has_data_mode_commands)
+	{
+		const detail::ExtCmdDef::DataMode* data_mode = this->m_data_mode;
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+		if (data_mode->escape == nullptr)
+		{
+			std::size_t n = std::min<std::size_t>(size, this->m_data_remaining);
+			passData(data_mode, bytes, n);
+			this->m_data_remaining -= n;
+			if (this->m_data_remaining == 0)
+			{
+				this->m_data_mode = nullptr;
+			}
+			return n;
+		}
+
+		// Bytes that may start the escape sequence are held back until it is matched or broken. A broken
+		// partial match falls back to the longest part of it that can still start the escape, as in "aaab"
+		// ending with the escape "aab", and the bytes before that part are payload
+		std::size_t start = 0;
+		uint8_t matched = this->m_data_escape_matched;
+		for (std::size_t i = 0; i < size; i++)
+		{
+			while ((matched != 0) && (data[i] != data_mode->escape[matched]))
+			{
+				uint8_t fallback = data_mode->escape_fallback[matched - 1];
+				passData(data_mode, reinterpret_cast<const uint8_t*>(data_mode->escape), matched - fallback);
+				matched = fallback;
+			}
+			if (data[i] == data_mode->escape[matched])
+			{
+				if (matched == 0)
+				{
+					passData(data_mode, &bytes[start], i - start);
+				}
+				start = i + 1;
+				if (++matched == data_mode->escape_length)
+				{
+					this->m_data_escape_matched = 0;
+					this->m_data_mode = nullptr;
+					return i + 1;
+				}
+			}
+		}
+		this->m_data_escape_matched = matched;
+		passData(data_mode, &bytes[start], size - start);
+		return size;
+	}
+
+
+	void armTimer(uint32_t ticks)
+	{
+		if (this->m_timer_wheel != nullptr)
+		{
+			this->m_timer_wheel->arm(this->m_timer, ticks);
+		}
+	}
+
+	void cancelTimer()
+	{
+		TimerWheel::cancel(this->m_timer);
+	}
+
+	// The command did not complete in time: it is aborted and the line fails whatever the handler returns
+	void timeoutCmdExec()
+	{
+		if constexpr (has_data_mode_commands)
+		{
+			this->m_data_mode = nullptr;
+		}
+		if constexpr (has_concurrent_commands)
+		{
+			abortStartedCmds();
+		}
+		execCmd(getCurrentCmdId(), Command::ServerHandle::CALL_TYPE::ABORT);
+		m_last_result_code = RESULT_CODE::ERROR;
+		m_error = true;
+		printResultCode(m_last_result_code);
+	}
+
+	// Requests of offloadable commands are run by the executor when it is set, otherwise inline
+	void setExecutor(ExecuteCallback execute_callback, void* executor_context = nullptr)
+	{
+		if constexpr (has_offloadable_commands)
+		{
+			this->m_execute_callback = execute_callback;
+			this->m_executor_context = executor_context;
+		}
+	}
+
+	// Called on the executor thread once an offloaded handler has returned, processCompletions() is then to
+	// be run on the server thread
+	void setWakeCallback(WakeCallback wake_callback, void* wake_context = nullptr)
+	{
+		if constexpr (has_offloadable_commands)
+		{
+			this->m_wake_callback = wake_callback;
+			this->m_wake_context = wake_context;
+		}
+	}
+
+	bool hasExecutor() const
+	{
+		if constexpr (has_offloadable_commands)
+		{
+			return this->m_execute_callback != nullptr;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	// True from the start of an offloaded request until the line is resumed, the command line belongs
+	// to the executor thread until isOffloadFinished()
+	bool isOffloaded() const
+	{
+		if constexpr (has_offloadable_commands)
+		{
+			return this->m_is_offloaded;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	// Must be called on the server thread. Prints the captured output and returns false if the line is
+	// still being executed
+	bool finishOffloadedCmdExec() requires has_offloadable_commands
+	{
+		this->m_is_offloaded = false;
+		this->m_offload_done.store(false, std::memory_order_relaxed);
+		setOutputRecorder(nullptr);
+		printBuffer(this->m_offload_output.data, this->m_offload_output.size);
+
+		if (this->m_offload_output.overflow)
+		{
+			// The rest of the response is lost, the line fails
+			if (m_last_result_code == RESULT_CODE::ASYNC)
+			{
+				execCmd(getCurrentCmdId(), Command::ServerHandle::CALL_TYPE::ABORT);
+			}
+			m_last_result_code = RESULT_CODE::ERROR;
+		}
+		if (m_last_result_code == RESULT_CODE::ERROR)
+		{
+			m_error = true;
+			return endCmdExec();
+		}
+		if (m_last_result_code == RESULT_CODE::ASYNC)
+		{
+			if constexpr (uses_timer)
+			{
+				updateCmdTimer(getCurrentCmdId(), Command::ServerHandle::CALL_TYPE::REQUEST);
+			}
+			return false;
+		}
+		return continueCmdExec();
+	}
+
+	bool isOffloadFinished() const requires has_offloadable_commands
+	{
+		return this->m_is_offloaded && this->m_offload_done.load(std::memory_order_acquire);
+	}
+
+	static consteval uint16_t getBasicCmdOffset()
+	{
+		return Settings::ExtendedCommands::size << 2;
+	}
+
+	static consteval uint16_t getAmpersandCmdOffset()
+	{
+		return getBasicCmdOffset() + 1 + Settings::BasicCommands::size;
+	}
+
+	static consteval uint16_t getExtCmdId(uint16_t cmd_index, CMD_TYPE cmd_type)
+	{
+		return (cmd_index << 2) | static_cast<uint16_t>(cmd_type);
+	}
+
+	void invalidateCmdResponseCache(uint16_t cmd_index)
+	{
+		if constexpr (response_cache_slot_count != 0)
+		{
+			for (uint_fast8_t t = 0; t < 3; t++)
+			{
+				int slot = findResponseCacheSlot((cmd_index << 2) | t);
+				if (slot >= 0)
+				{
+					m_response_cache.m_slots[slot].is_valid = false;
+				}
+			}
+		}
+	}
+
+	// Parameter parsing
+	union
+	{
+		uint8_t m_basic_cmd_index;
+		uint8_t m_param_index;
+	};
+
+	struct HexString
+	{
+		uint16_t size;
+		uint8_t byte;
+		bool second;
+	};
+
+	union
+	{
+		uint32_t m_param_value_num;
+		uint32_t m_param_string_size;
+		HexString m_param_hex_string;
+	};
+
+private:
+	bool addCmd(uint16_t cmd_id)
+	{
+		if (getCmdlineBufSz() < sizeof(uint16_t))
+		{
+			return false;
+		}
+		m_cmdline[m_cmdline_parse_index++] = cmd_id & 0xFF;
+		m_cmdline[m_cmdline_parse_index++] = cmd_id >> 8;
+		return true;
+	}
+
+	bool addNumericParameter_()
+	{
+		for (uint_fast8_t i = 0; i < sizeof(m_param_value_num); i++)
+		{
+			m_cmdline[m_cmdline_parse_index++] = m_param_value_num & 0xFF;
+			m_param_value_num >>= 8;
+		}
+		m_param_index++;
+		return true;
+	}
+
+	void addDefaultNumericParameter_(const detail::ExtCmdParamDef& param)
+	{
+		m_param_value_num = param.default_number;
+		addNumericParameter_();
+	}
+
+	void addDefaultEnumParameter_(const detail::ExtCmdParamDef& param)
+	{
+		m_param_value_num = param.default_number;
+		addEnumParameter();
+	}
+
+	void addDefaultStringParameter_(const detail::ExtCmdParamDef& param)
+	{
+		uint16_t i = param.string_max_len;
+		for (const char* c = param.default_string; *c != '\0'; c++)
+		{
+			m_cmdline[m_cmdline_parse_index++] = *c;
+			i--;
+		}
+		finalizeString(i);
+	}
+
+	void addDefaultHexStringParameter_(const detail::ExtCmdParamDef& param)
+	{
+		// The size follows the whole parameter buffer, where Parameters reads it
+		m_cmdline[m_cmdline_parse_index + param.hexstring_max_size]
+				= param.default_hex_string->size & 0xFF;
+		m_cmdline[m_cmdline_parse_index + param.hexstring_max_size + 1]
+				= (param.default_hex_string->size >> 8) & 0xFF;
+		for (std::size_t i = 0; i < param.default_hex_string->size; i++)
+		{
+			m_cmdline[m_cmdline_parse_index + i] = param.default_hex_string->data[i];
+		}
+		m_cmdline_parse_index += param.hexstring_max_size + sizeof(uint16_t);
+		m_param_index++;
+	}
+
+	void execCmd(uint16_t cmd_id, Command::ServerHandle::CALL_TYPE call_type)
 	{
-		uint16_t cmd_id = getCurrentCmdId();
 		if constexpr ((Settings::BasicCommands::size != 0) || (Settings::AmpersandCommands::size != 0))
 		{
 			if constexpr (Settings::ExtendedCommands::size != 0)
 			{
 				if (cmd_id >= getBasicCmdOffset())
 				{
-					uint16_t cmd_index = cmd_id - getBasicCmdOffset();
-					execBasicCmd(cmd_index, Command::ServerHandle::CALL_TYPE::ABORT);
+					execBasicCmd(cmd_id - getBasicCmdOffset(), call_type);
 				}
 				else
 				{
-					uint16_t cmd_index = cmd_id >> 2;
-					CMD_TYPE cmd_type = static_cast<CMD_TYPE>(cmd_id & 0x03);
-					execExtendedCmd(cmd_index, cmd_type, Command::ServerHandle::CALL_TYPE::ABORT);
+					execExtendedCmd(cmd_id >> 2, static_cast<CMD_TYPE>(cmd_id & 0x03), call_type);
+				}
+			}
+			else
+			{
+				execBasicCmd(cmd_id - getBasicCmdOffset(), call_type);
+			}
+		}
+		else
+		{
+			if constexpr (Settings::ExtendedCommands::size != 0)
+			{
+				execExtendedCmd(cmd_id >> 2, static_cast<CMD_TYPE>(cmd_id & 0x03), call_type);
+			}
+		}
+	}
+
+	static constexpr std::size_t concurrent_cmd_slot_count = getConcurrentCmdSlotCount<Settings>();
+	static constexpr bool has_concurrent_commands = concurrent_cmd_slot_count != 0;
+	static constexpr bool has_async_states = getAsyncStateSize<Settings>() != 0;
+
+	static_assert(!has_offloadable_commands || atcmd::server::concepts::CompletionQueueSettings<Settings>,
+			"Offloadable commands need Settings::completion_queue_size");
+
+	static_assert(
+			!hasCommands<Settings>(&BasicCmdDef::coroutine, &ExtCmdDef::isCoroutine) ||
+			atcmd::server::concepts::CoroutineSettings<Settings>,
+			"Coroutine handlers need Settings::coroutine_frame_size");
+
+	// nullptr for S-parameters
+	static const BasicCmdDef* getBasicCmdDef(uint16_t cmd_id)
+	{
+		uint16_t cmd_index = cmd_id - getBasicCmdOffset();
+		if (cmd_index == 0)
+		{
+			return nullptr;
+		}
+		cmd_index--;
+		if (cmd_index < Settings::BasicCommands::size)
+		{
+			if constexpr (Settings::BasicCommands::size != 0)
+			{
+				return &Settings::BasicCommands::m_cmd_defs[cmd_index];
+			}
+		}
+		else
+		{
+			if constexpr (Settings::AmpersandCommands::size != 0)
+			{
+				return &Settings::AmpersandCommands::m_cmd_defs[cmd_index - Settings::BasicCommands::size];
+			}
+		}
+		return nullptr;
+	}
+
+	bool isOffloadable(uint16_t cmd_id) const
+	{
+		if (cmd_id >= getBasicCmdOffset())
+		{
+			const BasicCmdDef* def = getBasicCmdDef(cmd_id);
+			return (def != nullptr) && def->offloadable;
+		}
+		if constexpr (Settings::ExtendedCommands::size != 0)
+		{
+			// Test commands never block
+			return
+					(static_cast<CMD_TYPE>(cmd_id & 0x03) != CMD_TYPE::TEST) &&
+					Settings::ExtendedCommands::m_ext_cmd_defs[cmd_id >> 2].isOffloadable();
+		}
+		return false;
+	}
+
+	bool isConcurrent(uint16_t cmd_id) const
+	{
+		if (cmd_id >= getBasicCmdOffset())
+		{
+			const BasicCmdDef* def = getBasicCmdDef(cmd_id);
+			return (def != nullptr) && def->concurrent;
+		}
+		if constexpr (Settings::ExtendedCommands::size != 0)
+		{
+			// Test commands print their response right away
+			return
+					(static_cast<CMD_TYPE>(cmd_id & 0x03) != CMD_TYPE::TEST) &&
+					Settings::ExtendedCommands::m_ext_cmd_defs[cmd_id >> 2].isConcurrent();
+		}
+		return false;
+	}
+
+	// The size of the command at the start of a frame, zero if it is not a valid extended command
+	static std::size_t getFrameCmdSize(const uint8_t* data, std::size_t size)
+	{
+		if constexpr (Settings::ExtendedCommands::size != 0)
+		{
+			if (size < sizeof(uint16_t))
+			{
+				return 0;
+			}
+			uint16_t cmd_id = data[0] | (data[1] << 8);
+			if ((cmd_id >= getBasicCmdOffset()) || ((cmd_id & 0x03) > static_cast<uint16_t>(CMD_TYPE::TEST)))
+			{
+				return 0;
+			}
+
+			const detail::ExtCmdDef& cmd_def = Settings::ExtendedCommands::m_ext_cmd_defs[cmd_id >> 2];
+			std::size_t r = sizeof(uint16_t);
+			switch (static_cast<CMD_TYPE>(cmd_id & 0x03)) {
+			case CMD_TYPE::READ:
+				return cmd_def.getReadMethod() != nullptr ? r : 0;
+			case CMD_TYPE::TEST:
+				return r;
+			default:
+				break;
+			}
+			if (cmd_def.getWriteMethod() == nullptr)
+			{
+				return 0;
+			}
+			if (cmd_def.getParameters() != nullptr)
+			{
+				// Every parameter is present, omitted ones carry their default values
+				for (std::size_t j = 0; j < cmd_def.getParameters()->count; j++)
+				{
+					const detail::ExtCmdParamDef& param = cmd_def.getParameters()->parameters[j];
+					if ((size - r < param.getSize()) || !param.validate(&data[r]))
+					{
+						return 0;
+					}
+					r += param.getSize();
+				}
+			}
+			return r;
+		}
+		else
+		{
+			(void)data;
+			(void)size;
+			return 0;
+		}
+	}
+
+	// Index of the command following the one at exec_index
+	std::size_t getNextExecIndex(std::size_t exec_index) const
+	{
+		uint16_t cmd_id = m_cmdline[exec_index] | (m_cmdline[exec_index + 1] << 8);
+		std::size_t r = exec_index + sizeof(uint16_t);
+		if (cmd_id >= getBasicCmdOffset())
+		{
+			const BasicCmdDef* def = getBasicCmdDef(cmd_id);
+			if (def != nullptr)
+			{
+				return r + (def->numeric_ranges != nullptr ? sizeof(uint32_t) : 0);
+			}
+			// S-parameter index, a write carries the value
+			return r + ((m_cmdline[r] & 0x80) ? 2 : 1);
+		}
+		if constexpr (Settings::ExtendedCommands::size != 0)
+		{
+			const detail::ExtCmdDef& cmd_def = Settings::ExtendedCommands::m_ext_cmd_defs[cmd_id >> 2];
+			if ((static_cast<CMD_TYPE>(cmd_id & 0x03) == CMD_TYPE::WRITE) && (cmd_def.getParameters() != nullptr))
+			{
+				for (std::size_t j = 0; j < cmd_def.getParameters()->count; j++)
+				{
+					r += cmd_def.getParameters()->parameters[j].getSize();
+				}
+			}
+		}
+		return r;
+	}
+
+	// While a concurrent command at the head of the line waits for its completion, the requests of the
+	// concurrent commands following it are started. Their results and updates are kept until they reach the head
+	void startConcurrentCmds()
+	{
+		uint16_t head_index = m_cmdline_exec_index;
+		uint8_t head_async_state_slot = getAsyncStateSlot();
+		if (!isConcurrent(getCurrentCmdId()))
+		{
+			return;
+		}
+
+		uint16_t exec_index;
+		if (this->m_started_cmd_count != 0)
+		{
+			const auto& last = this->m_started_cmds[this->m_started_cmd_count - 1];
+			if (last.result_code == RESULT_CODE::ERROR)
+			{
+				// The line stops there
+				return;
+			}
+			exec_index = last.next_exec_index;
+		}
+		else
+		{
+			exec_index = getNextExecIndex(head_index);
+		}
+
+		while ((this->m_started_cmd_count != concurrent_cmd_slot_count) && (exec_index != m_cmdline_parse_ok_index))
+		{
+			m_cmdline_exec_index = exec_index;
+			uint16_t cmd_id = getCurrentCmdId();
+			if (!isConcurrent(cmd_id) || (isOffloadable(cmd_id) && hasExecutor()))
+			{
+				break;
+			}
+			uint16_t next_exec_index = getNextExecIndex(exec_index);
+			uint8_t async_state_slot = allocateAsyncStateSlot(head_async_state_slot);
+			setAsyncStateSlot(async_state_slot);
+
+			// The output would come before the response of the head
+			OutputRecorder recorder =
+			{
+				.data = &this->m_started_output[this->m_started_output_size],
+				.capacity = static_cast<uint16_t>(sizeof(this->m_started_output) - this->m_started_output_size),
+				.size = 0,
+				.overflow = false,
+				.is_capturing = true
+			};
+			setOutputRecorder(&recorder);
+			execCmd(cmd_id, Command::ServerHandle::CALL_TYPE::REQUEST);
+			setOutputRecorder(nullptr);
+			if (recorder.overflow)
+			{
+				// The response can not be kept, the command fails
+				if (m_last_result_code == RESULT_CODE::ASYNC)
+				{
+					execCmd(cmd_id, Command::ServerHandle::CALL_TYPE::ABORT);
 				}
+				m_last_result_code = RESULT_CODE::ERROR;
+				recorder.size = 0;
 			}
-			else
+			this->m_started_output_size += recorder.size;
+
+			this->m_started_cmds[this->m_started_cmd_count++] =
 			{
-				uint16_t cmd_index = cmd_id - getBasicCmdOffset();
-				execBasicCmd(cmd_index, Command::ServerHandle::CALL_TYPE::ABORT);
-			}
-		}
-		else
-		{
-			if constexpr (Settings::ExtendedCommands::size != 0)
+				.exec_index = exec_index,
+				.next_exec_index = next_exec_index,
+				.output_size = recorder.size,
+				.result_code = m_last_result_code,
+				.updates = 0,
+				.async_state_slot = async_state_slot
+			};
+			if (m_last_result_code == RESULT_CODE::ERROR)
 			{
-				uint16_t cmd_index = cmd_id >> 2;
-				CMD_TYPE cmd_type = static_cast<CMD_TYPE>(cmd_id & 0x03);
-				execExtendedCmd(cmd_index, cmd_type, Command::ServerHandle::CALL_TYPE::ABORT);
+				break;
 			}
+			exec_index = next_exec_index;
 		}
 
-		if (m_last_result_code == RESULT_CODE::ASYNC)
-		{
-			return false;
-		}
-		printResultCode(m_last_result_code);
-		return true;
+		m_cmdline_exec_index = head_index;
+		m_last_result_code = RESULT_CODE::ASYNC;
+		setAsyncStateSlot(head_async_state_slot);
 	}
 
-	static consteval uint16_t getBasicCmdOffset()
+	// Prints the kept request output of the first started command
+	auto popStartedCmd()
 	{
-		return Settings::ExtendedCommands::size << 2;
+		auto r = this->m_started_cmds[0];
+		this->m_started_cmd_count--;
+		for (uint_fast8_t i = 0; i < this->m_started_cmd_count; i++)
+		{
+			this->m_started_cmds[i] = this->m_started_cmds[i + 1];
+		}
+		if (r.output_size != 0)
+		{
+			printBuffer(this->m_started_output, r.output_size);
+			this->m_started_output_size -= r.output_size;
+			std::memmove(this->m_started_output, &this->m_started_output[r.output_size], this->m_started_output_size);
+		}
+		return r;
 	}
 
-	static consteval uint16_t getAmpersandCmdOffset()
+	void deferStartedCmdUpdate(uint16_t cmd_id)
 	{
-		return getBasicCmdOffset() + 1 + Settings::BasicCommands::size;
+		for (uint_fast8_t i = 0; i < this->m_started_cmd_count; i++)
+		{
+			auto& started = this->m_started_cmds[i];
+			uint16_t id = m_cmdline[started.exec_index] | (m_cmdline[started.exec_index + 1] << 8);
+			if ((id == cmd_id) && (started.result_code == RESULT_CODE::ASYNC) && (started.updates != 0xFF))
+			{
+				started.updates++;
+				return;
+			}
+		}
 	}
 
-	static consteval uint16_t getExtCmdId(uint16_t cmd_index, CMD_TYPE cmd_type)
+	void abortStartedCmds()
 	{
-		return (cmd_index << 2) | static_cast<uint16_t>(cmd_type);
+		uint16_t head_index = m_cmdline_exec_index;
+		RESULT_CODE head_result_code = m_last_result_code;
+		uint8_t head_async_state_slot = getAsyncStateSlot();
+		for (uint_fast8_t i = 0; i < this->m_started_cmd_count; i++)
+		{
+			if (this->m_started_cmds[i].result_code == RESULT_CODE::ASYNC)
+			{
+				m_cmdline_exec_index = this->m_started_cmds[i].exec_index;
+				setAsyncStateSlot(this->m_started_cmds[i].async_state_slot);
+				execCmd(getCurrentCmdId(), Command::ServerHandle::CALL_TYPE::ABORT);
+			}
+		}
+		this->m_started_cmd_count = 0;
+		this->m_head_updates = 0;
+		this->m_started_output_size = 0;
+		m_cmdline_exec_index = head_index;
+		m_last_result_code = head_result_code;
+		setAsyncStateSlot(head_async_state_slot);
 	}
 
-	// Parameter parsing
-	union
-	{
-		uint8_t m_basic_cmd_index;
-		uint8_t m_param_index;
-	};
-
-	struct HexString
+	// AsyncState storage of the command being executed
+	// The handler of a coroutine command gets the frame pool instead of an AsyncState
+	void* getExecAsyncState(bool is_coroutine)
 	{
-		uint16_t size;
-		uint8_t byte;
-		bool second;
-	};
+		if constexpr (atcmd::server::concepts::CoroutineSettings<Settings>)
+		{
+			if (is_coroutine)
+			{
+				return static_cast<CoroutineFramePool*>(&this->m_coroutine_frames);
+			}
+		}
+		if constexpr (has_async_states)
+		{
+			return &this->m_async_states[this->m_async_state_slot * this->async_state_stride];
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
 
-	union
+	uint8_t getAsyncStateSlot() const
 	{
-		uint32_t m_param_value_num;
-		uint32_t m_param_string_size;
-		HexString m_param_hex_string;
-	};
+		if constexpr (has_async_states)
+		{
+			return this->m_async_state_slot;
+		}
+		else
+		{
+			return 0;
+		}
+	}
 
-private:
-	bool addCmd(uint16_t cmd_id)
+	void setAsyncStateSlot(uint8_t slot)
 	{
-		if (getCmdlineBufSz() < sizeof(uint16_t))
+		if constexpr (has_async_states)
 		{
-			return false;
+			this->m_async_state_slot = slot;
 		}
-		m_cmdline[m_cmdline_parse_index++] = cmd_id & 0xFF;
-		m_cmdline[m_cmdline_parse_index++] = cmd_id >> 8;
-		return true;
 	}
 
-	bool addNumericParameter_()
+	// A slot used neither by the command at the head of the line nor by a started one
+	uint8_t allocateAsyncStateSlot(uint8_t head_slot) const
 	{
-		for (uint_fast8_t i = 0; i < sizeof(m_param_value_num); i++)
+		if constexpr (has_async_states)
 		{
-			m_cmdline[m_cmdline_parse_index++] = m_param_value_num & 0xFF;
-			m_param_value_num >>= 8;
+			for (uint8_t slot = 0; ; slot++)
+			{
+				bool used = slot == head_slot;
+				for (uint_fast8_t i = 0; !used && (i < this->m_started_cmd_count); i++)
+				{
+					used = this->m_started_cmds[i].async_state_slot == slot;
+				}
+				if (!used)
+				{
+					return slot;
+				}
+			}
+		}
+		else
+		{
+			return 0;
 		}
-		m_param_index++;
-		return true;
 	}
 
-	void addDefaultNumericParameter_(const detail::ExtCmdParamDef& param)
+	uint32_t getCmdTimeout(uint16_t cmd_id) const
 	{
-		m_param_value_num = param.default_number;
-		addNumericParameter_();
+		if (cmd_id >= getBasicCmdOffset())
+		{
+			const BasicCmdDef* def = getBasicCmdDef(cmd_id);
+			return def != nullptr ? def->timeout : 0;
+		}
+		if constexpr (Settings::ExtendedCommands::size != 0)
+		{
+			return Settings::ExtendedCommands::m_ext_cmd_defs[cmd_id >> 2].getTimeout();
+		}
+		return 0;
 	}
 
-	void addDefaultStringParameter_(const detail::ExtCmdParamDef& param)
+	// The timeout runs from the request until the command completes
+	void updateCmdTimer(uint16_t cmd_id, Command::ServerHandle::CALL_TYPE call_type)
 	{
-		uint16_t i = param.string_max_len;
-		for (const char* c = param.default_string; *c != '\0'; c++)
+		if (m_last_result_code != RESULT_CODE::ASYNC)
 		{
-			m_cmdline[m_cmdline_parse_index++] = *c;
-			i--;
+			cancelTimer();
+		}
+		else if (call_type == Command::ServerHandle::CALL_TYPE::REQUEST)
+		{
+			uint32_t timeout = getCmdTimeout(cmd_id);
+			if (timeout != 0)
+			{
+				armTimer(timeout);
+			}
 		}
-		finalizeString(i);
 	}
 
-	void addDefaultHexStringParameter_(const detail::ExtCmdParamDef& param)
+	// Runs on the executor thread
+	static void runOffloadedCmd(void* arg)
 	{
-		m_cmdline[m_cmdline_parse_index + param.default_hex_string->size]
-				= param.default_hex_string->size & 0xFF;
-		m_cmdline[m_cmdline_parse_index + param.default_hex_string->size + 1]
-				= (param.default_hex_string->size >> 8) & 0xFF;
-		for (std::size_t i = 0; i < param.default_hex_string->size; i++)
+		ServerCmdline* self = static_cast<ServerCmdline*>(arg);
+		self->execCmd(self->getCurrentCmdId(), Command::ServerHandle::CALL_TYPE::REQUEST);
+		// The server may be gone once the server thread has seen the flag
+		WakeCallback wake_callback = self->m_wake_callback;
+		void* wake_context = self->m_wake_context;
+		self->m_offload_done.store(true, std::memory_order_release);
+		if (wake_callback != nullptr)
 		{
-			m_cmdline[m_cmdline_parse_index++] = param.default_hex_string->data[i];
+			wake_callback(wake_context);
 		}
-		m_cmdline_parse_index += sizeof(uint16_t);
 	}
 
 	void execBasicCmd(uint16_t cmd_index, Command::ServerHandle::CALL_TYPE call_type)
@@ -602,7 +2058,7 @@ private:
 		}
 		bool is_last = m_cmdline_parse_index == next_exec_index;
 
-		m_last_result_code = cmd_def->exec_method(getBasicHandle(param_start, is_last, call_type));
+		m_last_result_code = cmd_def->exec_method(getBasicHandle(param_start, is_last, call_type, getExecAsyncState(cmd_def->coroutine)));
 
 		if ((m_last_result_code != RESULT_CODE::ASYNC) && (call_type != Command::ServerHandle::CALL_TYPE::ABORT))
 		{
@@ -615,35 +2071,51 @@ private:
 	{
 		const detail::ExtCmdDef& cmd_def = Settings::ExtendedCommands::m_ext_cmd_defs[cmd_index];
 
-		std::size_t next_exec_index = m_cmdline_exec_index + sizeof(uint16_t);
-		if ((cmd_type == CMD_TYPE::WRITE) && (cmd_def.getParameters() != nullptr))
+		std::size_t next_exec_index = getNextExecIndex(m_cmdline_exec_index);
+		bool is_last = m_cmdline_parse_index == next_exec_index;
+
+		int cache_slot = -1;
+		OutputRecorder recorder;
+		uint32_t cache_generation;
+		if constexpr (response_cache_slot_count != 0)
 		{
-			for (std::size_t j = 0; j < cmd_def.getParameters()->count; j++)
+			if ((call_type == Command::ServerHandle::CALL_TYPE::REQUEST) && (cmd_type != CMD_TYPE::WRITE))
 			{
-				switch (cmd_def.getParameters()->parameters[j].param_type) {
-				case detail::ExtCmdParamDef::TYPE::NUM_DEC:
-				case detail::ExtCmdParamDef::TYPE::NUM_HEX:
-				case detail::ExtCmdParamDef::TYPE::NUM_BIN:
-					next_exec_index += sizeof(uint32_t);
-					break;
-				case detail::ExtCmdParamDef::TYPE::STR:
-					next_exec_index += cmd_def.getParameters()->parameters[j].string_max_len;
-					break;
-				case detail::ExtCmdParamDef::TYPE::STR_HEX:
-					next_exec_index += cmd_def.getParameters()->parameters[j].hexstring_max_size + sizeof(uint16_t);
-					break;
-				default:
-					break;
+				cache_slot = findResponseCacheSlot(getCurrentCmdId());
+			}
+			if (cache_slot >= 0)
+			{
+				if (replayCachedResponse(cache_slot, is_last))
+				{
+					m_cmdline_exec_index = next_exec_index;
+					return;
 				}
+				recorder =
+				{
+					.data = &m_response_cache.m_data[m_response_cache_layout[cache_slot].offset],
+					.capacity = m_response_cache_layout[cache_slot].capacity,
+					.size = 0,
+					.overflow = false,
+					.is_capturing = false
+				};
+				cache_generation = getResponseCacheGeneration();
+				setOutputRecorder(&recorder);
 			}
 		}
-		bool is_last = m_cmdline_parse_index == next_exec_index;
+
 		switch (cmd_type) {
 		case CMD_TYPE::READ:
-			m_last_result_code = cmd_def.getReadMethod()(getReadHandle(is_last, call_type));
+			m_last_result_code = cmd_def.getReadMethod()(getReadHandle(is_last, call_type, getExecAsyncState(cmd_def.isCoroutine())));
 			break;
 		case CMD_TYPE::WRITE:
-			m_last_result_code = cmd_def.getWriteMethod()(getWriteHandle(&m_cmdline[m_cmdline_exec_index + sizeof(uint16_t)], is_last, call_type));
+			m_last_result_code = cmd_def.getWriteMethod()(getWriteHandle(&m_cmdline[m_cmdline_exec_index + sizeof(uint16_t)], is_last, call_type, getExecAsyncState(cmd_def.isCoroutine())));
+			if constexpr (has_data_mode_commands)
+			{
+				if ((m_last_result_code == RESULT_CODE::CONNECT) && (call_type != Command::ServerHandle::CALL_TYPE::ABORT))
+				{
+					startDataMode(cmd_def);
+				}
+			}
 			break;
 		case CMD_TYPE::TEST:
 			for (detail::ExtendedCommandBase::TestMethod method = cmd_def.getTestMethod(); method != nullptr;)
@@ -663,6 +2135,15 @@ private:
 			break;
 		}
 
+		if constexpr (response_cache_slot_count != 0)
+		{
+			if (cache_slot >= 0)
+			{
+				setOutputRecorder(nullptr);
+				storeCachedResponse(cache_slot, recorder, cache_generation, is_last);
+			}
+		}
+
 		if ((m_last_result_code != RESULT_CODE::ASYNC) && (call_type != Command::ServerHandle::CALL_TYPE::ABORT))
 		{
 			// Go to the next command
@@ -670,84 +2151,167 @@ private:
 		}
 	}
 
-	void printCmdParameterRanges(const detail::ExtCmdDef& cmd_def, const char* name)
+	// The command at cmdline_index receives a chunk of its streamed parameter, the parameters before it are set
+	void passStream(std::size_t cmdline_index, Command::ServerHandle::CALL_TYPE call_type, const uint8_t* data, std::size_t size)
+		requires has_streamed_commands
+	{
+		uint16_t cmd_id = m_cmdline[cmdline_index] | (m_cmdline[cmdline_index + 1] << 8);
+		const detail::ExtCmdDef& cmd_def = Settings::ExtendedCommands::m_ext_cmd_defs[cmd_id >> 2];
+		cmd_def.getDataMethod()(
+				getWriteHandle(&m_cmdline[cmdline_index + sizeof(uint16_t)], false, call_type, nullptr),
+				std::span<const uint8_t>(data, size));
+	}
+
+	void flushStream() requires has_streamed_commands
 	{
-		if (cmd_def.getParameters() == nullptr)
+		if (this->m_stream_fill == 0)
 		{
 			return;
 		}
+		this->m_stream_started = true;
+		passStream(m_cmdline_parse_ok_index, Command::ServerHandle::CALL_TYPE::DATA,
+				&m_cmdline[m_cmdline_parse_index], this->m_stream_fill);
+		this->m_stream_fill = 0;
+	}
 
-		printInformationTextHeader();
-		printExtendedInformationTextHeader(name);
+	bool isStreamedCmd(std::size_t cmdline_index) const requires has_streamed_commands
+	{
+		uint16_t cmd_id = m_cmdline[cmdline_index] | (m_cmdline[cmdline_index + 1] << 8);
+		return (cmd_id < getBasicCmdOffset()) &&
+				(static_cast<CMD_TYPE>(cmd_id & 0x03) == CMD_TYPE::WRITE) &&
+				Settings::ExtendedCommands::m_ext_cmd_defs[cmd_id >> 2].isStreamed();
+	}
 
-		for (std::size_t i = 0;;)
+	// The commands left after a failed one never see the parameters streamed to them
+	void abortSkippedStreams() requires has_streamed_commands
+	{
+		for (std::size_t i = m_cmdline_exec_index; i != m_cmdline_parse_ok_index; i = getNextExecIndex(i))
 		{
-			printChar('(');
-
-			const auto& parameter = cmd_def.getParameters()->parameters[i];
-			uint_fast8_t base;
-			switch (parameter.param_type) {
-			case detail::ExtCmdParamDef::TYPE::NUM_DEC:
-				base = 10;
-				break;
-			case detail::ExtCmdParamDef::TYPE::NUM_HEX:
-				base = 16;
-				break;
-			case detail::ExtCmdParamDef::TYPE::NUM_BIN:
-				base = 2;
-				break;
-			default:
-				break;
+			if (isStreamedCmd(i))
+			{
+				passStream(i, Command::ServerHandle::CALL_TYPE::ABORT, nullptr, 0);
 			}
+		}
+	}
 
-			switch (parameter.param_type) {
-			case detail::ExtCmdParamDef::TYPE::NUM_DEC:
-			case detail::ExtCmdParamDef::TYPE::NUM_HEX:
-			case detail::ExtCmdParamDef::TYPE::NUM_BIN:
-				for (std::size_t j = 0;;)
-				{
-					const auto& range = parameter.numeric_ranges->ranges[j];
-					printNumber(range.m_min, base);
-					if (range.m_min != range.m_max)
-					{
-						printChar('-');
-						printNumber(range.m_max, base);
-					}
-					if (++j == parameter.numeric_ranges->count)
-					{
-						break;
-					}
-					else
-					{
-						printChar(',');
-					}
-				}
-				break;
-			case detail::ExtCmdParamDef::TYPE::STR:
-				printText("s:");
-				printNumber(parameter.string_max_len - 1, 10);
-				break;
-			case detail::ExtCmdParamDef::TYPE::STR_HEX:
-				printText("hs:");
-				printNumber(parameter.hexstring_max_size, 10);
-				break;
-			default:
-				break;
-			}
+	void startDataMode(const detail::ExtCmdDef& cmd_def)
+	{
+		const detail::ExtCmdDef::DataMode* data_mode = cmd_def.getDataMode();
+		if (data_mode == nullptr)
+		{
+			return;
+		}
+		printResultCode(RESULT_CODE::CONNECT);
+
+		this->m_data_mode = data_mode;
+		this->m_data_escape_matched = 0;
+		if (data_mode->escape == nullptr)
+		{
+			const uint8_t* size = &m_cmdline[m_cmdline_exec_index + sizeof(uint16_t) + data_mode->size_offset];
+			this->m_data_remaining = size[0] | (size[1] << 8) | (size[2] << 16) | (static_cast<uint32_t>(size[3]) << 24);
+		}
+		// The response call follows the payload
+		m_last_result_code = RESULT_CODE::ASYNC;
+	}
+
+	void passData(const detail::ExtCmdDef::DataMode* data_mode, const uint8_t* data, std::size_t size)
+	{
+		if (size == 0)
+		{
+			return;
+		}
+		bool is_last = m_cmdline_parse_index == getNextExecIndex(m_cmdline_exec_index);
+		data_mode->data(
+				getWriteHandle(
+						&m_cmdline[m_cmdline_exec_index + sizeof(uint16_t)],
+						is_last,
+						Command::ServerHandle::CALL_TYPE::DATA,
+						getExecAsyncState(false)),
+				std::span<const uint8_t>(data, size));
+	}
+
+	void printCmdParameterRanges(const detail::ExtCmdDef& cmd_def, const char* name)
+	{
+		const detail::ExtCmdDef::TestResponse* response = cmd_def.getTestResponse();
+		if (response == nullptr)
+		{
+			return;
+		}
 
-			printChar(')');
+		printInformationTextHeader();
+		if (name == response->name)
+		{
+			printBuffer(response->text, response->size);
+		}
+		else
+		{
+			printExtendedInformationTextHeader(name);
+			printBuffer(
+						response->text + response->parameters_offset,
+						response->size - response->parameters_offset);
+		}
+		printInformationTextTrailer();
+	}
 
-			if (++i == cmd_def.getParameters()->count)
+	int findResponseCacheSlot(uint16_t cmd_id) const
+	{
+		// The layout is sorted by the command id
+		std::size_t l = 0;
+		std::size_t r = response_cache_slot_count;
+		while (l != r)
+		{
+			std::size_t mid = (l + r) / 2;
+			uint16_t id = m_response_cache_layout[mid].cmd_id;
+			if (cmd_id == id)
 			{
-				break;
+				return mid;
+			}
+			else if (cmd_id < id)
+			{
+				r = mid;
 			}
 			else
 			{
-				printChar(',');
+				l = mid + 1;
 			}
 		}
+		return -1;
+	}
 
-		printInformationTextTrailer();
+	bool replayCachedResponse(int slot_index, bool is_last)
+	{
+		const ResponseCacheSlot& slot = m_response_cache.m_slots[slot_index];
+		const SParameters& s_parameters = getCommunicationParameters();
+		if (!slot.is_valid ||
+			(slot.generation != getResponseCacheGeneration()) ||
+			(slot.is_last_command != is_last) ||
+			(slot.verbose != s_parameters.isVerbose()) ||
+			(slot.s3 != s_parameters.getCmdLineTerminationChar()) ||
+			(slot.s4 != s_parameters.getResponseFormattingChar()))
+		{
+			return false;
+		}
+		printBuffer(&m_response_cache.m_data[m_response_cache_layout[slot_index].offset], slot.size);
+		m_last_result_code = slot.result_code;
+		return true;
+	}
+
+	void storeCachedResponse(int slot_index, const OutputRecorder& recorder, uint32_t generation, bool is_last)
+	{
+		ResponseCacheSlot& slot = m_response_cache.m_slots[slot_index];
+		const SParameters& s_parameters = getCommunicationParameters();
+		// Asynchronous and failed responses are never cached
+		slot.is_valid =
+				!recorder.overflow &&
+				(m_last_result_code != RESULT_CODE::ASYNC) &&
+				(m_last_result_code != RESULT_CODE::ERROR);
+		slot.generation = generation;
+		slot.size = recorder.size;
+		slot.result_code = m_last_result_code;
+		slot.is_last_command = is_last;
+		slot.verbose = s_parameters.isVerbose();
+		slot.s3 = s_parameters.getCmdLineTerminationChar();
+		slot.s4 = s_parameters.getResponseFormattingChar();
 	}
 
 	uint16_t getCurrentCmdId() const
@@ -773,29 +2337,21 @@ private:
 				const detail::ExtCmdDef::Parameters* parameters = def.getParameters();
 				if (parameters->count != 0)
 				{
+					// A streamed parameter needs its chunk only until it ends
 					std::size_t n = 2;
+					std::size_t peak = n;
 					for (uint_fast8_t i = 0; i < parameters->count; i++)
 					{
 						const ExtCmdParamDef* p = &parameters->parameters[i];
-						switch (p->param_type) {
-						case ExtCmdParamDef::TYPE::NUM_DEC:
-						case ExtCmdParamDef::TYPE::NUM_HEX:
-						case ExtCmdParamDef::TYPE::NUM_BIN:
-							n += sizeof(uint32_t);
-							break;
-						case ExtCmdParamDef::TYPE::STR:
-							n += p->string_max_len;
-							break;
-						case ExtCmdParamDef::TYPE::STR_HEX:
-							n += p->hexstring_max_size + sizeof(uint16_t);
-							break;
-						default:
-							break;
+						if (n + p->getParseSize() > peak)
+						{
+							peak = n + p->getParseSize();
 						}
+						n += p->getSize();
 					}
-					if (n > r)
+					if (peak > r)
 					{
-						r = n;
+						r = peak;
 					}
 				}
 			}
@@ -804,10 +2360,68 @@ private:
 		return r * Settings::max_commands_per_line;
 	}
 
+	static consteval std::size_t calcResponseCacheSlotCount()
+	{
+		std::size_t r = 0;
+		if constexpr (Settings::ExtendedCommands::size != 0)
+		{
+			for (const detail::ExtCmdDef& def : Settings::ExtendedCommands::m_ext_cmd_defs)
+			{
+				r += (def.getReadCacheSize() != 0) + (def.getTestCacheSize() != 0);
+			}
+		}
+		return r;
+	}
+
+	static constexpr std::size_t response_cache_slot_count = calcResponseCacheSlotCount();
+
+	static consteval std::array<ResponseCacheEntry, response_cache_slot_count> calcResponseCacheLayout()
+	{
+		std::array<ResponseCacheEntry, response_cache_slot_count> r = {};
+		if constexpr (response_cache_slot_count != 0)
+		{
+			std::size_t i = 0;
+			std::size_t offset = 0;
+			auto add = [&](uint16_t cmd_id, uint16_t capacity)
+			{
+				if (capacity != 0)
+				{
+					r[i++] = {.cmd_id = cmd_id, .offset = static_cast<uint16_t>(offset), .capacity = capacity};
+					offset += capacity;
+				}
+			};
+			for (uint16_t j = 0; j < Settings::ExtendedCommands::size; j++)
+			{
+				const detail::ExtCmdDef& def = Settings::ExtendedCommands::m_ext_cmd_defs[j];
+				add(getExtCmdId(j, CMD_TYPE::READ), def.getReadCacheSize());
+				add(getExtCmdId(j, CMD_TYPE::TEST), def.getTestCacheSize());
+			}
+		}
+		return r;
+	}
+
+	static constexpr std::array<ResponseCacheEntry, response_cache_slot_count> m_response_cache_layout =
+			calcResponseCacheLayout();
+
+	static consteval std::size_t calcResponseCacheDataSize()
+	{
+		std::size_t r = 0;
+		for (const ResponseCacheEntry& entry : m_response_cache_layout)
+		{
+			r += entry.capacity;
+		}
+		return r;
+	}
+
+	static_assert(calcResponseCacheDataSize() <= 0xFFFF, "Response cache is too big");
+
+	static_assert(calcCmdlineSize() <= 0xFFFF, "Command line buffer is too big");
+
 	uint8_t m_cmdline[calcCmdlineSize()];
-	std::size_t m_cmdline_parse_ok_index;
-	std::size_t m_cmdline_parse_index;
-	std::size_t m_cmdline_exec_index;
+	[[no_unique_address]] ResponseCache<response_cache_slot_count, calcResponseCacheDataSize()> m_response_cache;
+	uint16_t m_cmdline_parse_ok_index;
+	uint16_t m_cmdline_parse_index;
+	uint16_t m_cmdline_exec_index;
 	RESULT_CODE m_last_result_code;
 	bool m_error;
 };
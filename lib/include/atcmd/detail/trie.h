@@ -25,126 +25,150 @@
 #ifndef ATCMD_TRIE_H
 #define ATCMD_TRIE_H
 
+#include <type_traits>
+
 #include <atcmd/detail/triebuilder.h>
 #include <atcmd/detail/characters.h>
 
 namespace atcmd::detail {
 
-template<std::size_t N, std::array<const char*, N> names>
-struct TrieBase
+// Walks a trie packed by TrieBuilder. The position is kept by the caller, so a trie shared by all
+// servers or referenced from a parameter definition is walked the same way
+struct TrieWalker
 {
-	TrieBase() : m_pos{0}
-	{}
+	TrieWalker() = delete;
 
-	void reset()
-	{
-		m_pos = 0;
-	}
-
-	bool feed(char ch)
+	template<class Pos>
+	static bool feed(const uint8_t* trie, Pos& pos, char ch)
 	{
 		// Goto the first child
-		skipCommandIndex();
-		if (getSubtreeSize() == 0)
+		skipCommandIndex(trie, pos);
+		if (getSubtreeSize(trie, pos) == 0)
 		{
 			return false;
 		}
 
 		while (true)
 		{
-			if (currentChar() == ch)
+			if (currentChar(trie, pos) == ch)
 			{
 				return true;
 			}
-			if (isLast())
+			if (isLast(trie, pos))
 			{
-				m_pos = 0;
+				pos = 0;
 				return false;
 			}
 			// Go to the right sibling
-			skipCommandIndex();
-			uint32_t s = getSubtreeSize();
-			m_pos += s;
+			skipCommandIndex(trie, pos);
+			uint32_t s = getSubtreeSize(trie, pos);
+			pos += s;
 		}
 	}
 
-	bool isLeaf() const
+	static bool isLeaf(const uint8_t* trie, uint32_t pos)
 	{
-		return current() & TrieBuilder::MASKS::MASKS_LEAF;
+		return trie[pos] & TrieBuilder::MASKS::MASKS_LEAF;
 	}
 
-	uint16_t getCommandIndex() const
+	static uint16_t getCommandIndex(const uint8_t* trie, uint32_t pos)
 	{
-		assert(isLeaf());
+		assert(isLeaf(trie, pos));
 
-		uint8_t b = m_trie[m_pos + 1];
+		uint8_t b = trie[pos + 1];
 		uint32_t r = b & 0x7F;
 		if ((b & (1u << 7)) == 0)
 		{
 			return r;
 		}
-		r |= m_trie[m_pos + 2] << 7;
+		r |= trie[pos + 2] << 7;
 		return r;
 	}
 
 private:
-	uint8_t current() const
-	{
-		return m_trie[m_pos];
-	}
-
-	char currentChar() const
+	static char currentChar(const uint8_t* trie, uint32_t pos)
 	{
-		return Characters::decode(current() & TrieBuilder::MASKS::MASKS_CHAR);
+		return Characters::decode(trie[pos] & TrieBuilder::MASKS::MASKS_CHAR);
 	}
 
-	bool isLast() const
+	static bool isLast(const uint8_t* trie, uint32_t pos)
 	{
-		return current() & TrieBuilder::MASKS::MASKS_LAST;
+		return trie[pos] & TrieBuilder::MASKS::MASKS_LAST;
 	}
 
-	void skipCommandIndex()
+	template<class Pos>
+	static void skipCommandIndex(const uint8_t* trie, Pos& pos)
 	{
-		if (!isLeaf())
+		if (!isLeaf(trie, pos))
 		{
-			m_pos++;
+			pos++;
 			return;
 		}
 
-		m_pos++;
-		if ((current() & (1u << 7)))
+		pos++;
+		if ((trie[pos] & (1u << 7)))
 		{
-			m_pos++;
+			pos++;
 		}
-		m_pos++;
+		pos++;
 	}
 
-	uint32_t getSubtreeSize()
+	template<class Pos>
+	static uint32_t getSubtreeSize(const uint8_t* trie, Pos& pos)
 	{
 		uint32_t r = 0;
 
 		// First 2 bytes
 		for (uint_fast8_t i = 0; i < 2; i++)
 		{
-			r |= (current() & 0x7F) << (7 * i);
-			if ((current() & (1u << 7)) == 0)
+			r |= (trie[pos] & 0x7F) << (7 * i);
+			if ((trie[pos] & (1u << 7)) == 0)
 			{
-				m_pos++;
+				pos++;
 				return r;
 			}
-			m_pos++;
+			pos++;
 		}
 
 		// Third byte
-		r |= current() << 14;
-		m_pos++;
+		r |= trie[pos] << 14;
+		pos++;
 		return r;
 	}
+};
 
-	std::size_t m_pos;
+template<std::size_t N, std::array<const char*, N> names>
+struct TrieBase
+{
+	TrieBase() : m_pos{0}
+	{}
+
+	void reset()
+	{
+		m_pos = 0;
+	}
+
+	bool feed(char ch)
+	{
+		return TrieWalker::feed(m_trie.data(), m_pos, ch);
+	}
 
+	bool isLeaf() const
+	{
+		return TrieWalker::isLeaf(m_trie.data(), m_pos);
+	}
+
+	uint16_t getCommandIndex() const
+	{
+		return TrieWalker::getCommandIndex(m_trie.data(), m_pos);
+	}
+
+private:
 	static constexpr auto m_trie =
 			TrieBuilder::getTrie<TrieBuilder::getTrieSize(names.data(), names.size())>(names.data(), names.size());
+
+	// The trie itself is shared, only the position is kept per server
+	std::conditional_t<(m_trie.size() <= 0xFFFF), uint16_t, uint32_t> m_pos;
 };
 
 template<const char*... names>
@@ -0,0 +1,169 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_URCQUEUE_H
+#define ATCMD_URCQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace atcmd::server::detail {
+
+// Bounded queue of pre-formatted unsolicited result codes, ordered by priority and then by arrival. The texts
+// stay in fixed slots, only the one byte slot indices are moved. A coalescing URC replaces the queued one of
+// the same type, the type being the text up to and including the first ':'
+template<std::size_t count, std::size_t max_length>
+class UrcQueue
+{
+	static_assert((count != 0) && (count <= 0xFF), "URC queue size must be 1 to 255");
+	static_assert((max_length != 0) && (max_length <= 0xFFFF), "URC length must be 1 to 65535");
+
+public:
+	UrcQueue() :
+		m_count{0},
+		m_dropped{0}
+	{
+		for (uint8_t i = 0; i < count; i++)
+		{
+			m_order[i] = i;
+		}
+	}
+
+	// Returns false if the URC was dropped: it is too long, or the queue is full of URCs of the same or
+	// higher priority. Otherwise the last URC of the lowest priority makes room for it
+	bool push(std::string_view text, uint8_t priority, bool coalesce)
+	{
+		if (text.size() > max_length)
+		{
+			m_dropped++;
+			return false;
+		}
+		if (coalesce)
+		{
+			std::string_view type = getType(text);
+			for (uint8_t i = 0; i < m_count; i++)
+			{
+				if (getType(getText(m_order[i])) == type)
+				{
+					remove(i);
+					break;
+				}
+			}
+		}
+		if (m_count == count)
+		{
+			m_dropped++;
+			if (m_entries[m_order[count - 1]].priority >= priority)
+			{
+				return false;
+			}
+			remove(count - 1);
+		}
+
+		uint8_t pos = m_count;
+		while ((pos != 0) && (m_entries[m_order[pos - 1]].priority < priority))
+		{
+			pos--;
+		}
+		uint8_t slot = m_order[m_count];
+		for (uint8_t i = m_count; i != pos; i--)
+		{
+			m_order[i] = m_order[i - 1];
+		}
+		m_order[pos] = slot;
+		m_count++;
+
+		Entry& entry = m_entries[slot];
+		entry.priority = priority;
+		entry.size = text.size();
+		std::memcpy(entry.text, text.data(), text.size());
+		return true;
+	}
+
+	bool isEmpty() const
+	{
+		return m_count == 0;
+	}
+
+	// The URC to be printed next
+	std::string_view front() const
+	{
+		return getText(m_order[0]);
+	}
+
+	void pop()
+	{
+		remove(0);
+	}
+
+	// URCs lost because the queue was full or they were too long
+	uint32_t getDropped() const
+	{
+		return m_dropped;
+	}
+
+private:
+	struct Entry
+	{
+		uint16_t size;
+		uint8_t priority;
+		char text[max_length];
+	};
+
+	static std::string_view getType(std::string_view text)
+	{
+		std::size_t colon = text.find(':');
+		return colon == std::string_view::npos ? text : text.substr(0, colon + 1);
+	}
+
+	std::string_view getText(uint8_t slot) const
+	{
+		return std::string_view(m_entries[slot].text, m_entries[slot].size);
+	}
+
+	// The slot goes back to the free ones after the queued ones
+	void remove(uint8_t pos)
+	{
+		uint8_t slot = m_order[pos];
+		m_count--;
+		for (uint8_t i = pos; i < m_count; i++)
+		{
+			m_order[i] = m_order[i + 1];
+		}
+		m_order[m_count] = slot;
+	}
+
+	Entry m_entries[count];
+
+	// Slots of the queued URCs in printing order, then the free slots
+	uint8_t m_order[count];
+	uint8_t m_count;
+	uint32_t m_dropped;
+};
+
+} /* namespace atcmd::server::detail */
+
+#endif // ATCMD_URCQUEUE_H
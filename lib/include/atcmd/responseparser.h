@@ -0,0 +1,275 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_RESPONSEPARSER_H
+#define ATCMD_RESPONSEPARSER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include <atcmd/detail/characters.h>
+#include <atcmd/detail/extcmddef.h>
+#include <atcmd/server/extendedcommand.h>
+
+namespace atcmd {
+
+namespace detail {
+
+// A field of a parsed information text line, strings without the quotes
+struct ResponseField
+{
+	const char* data;
+	uint16_t size;
+	bool is_present;
+	uint32_t number;
+};
+
+// Splits received text into lines and the fields of "+NAME:" lines by the parameter definitions.
+// A line within a single chunk is tokenized in place, only a line split between chunks is copied to the buffer
+class ResponseTokenizer
+{
+public:
+	using ExtCmdParamDef = atcmd::server::detail::ExtCmdParamDef;
+
+	ResponseTokenizer(const char* name, const ExtCmdParamDef* params, uint8_t param_count, ResponseField* fields,
+			char* buffer, uint16_t capacity);
+
+	// Consumes data up to the end of the next non-empty line, returns the number of bytes consumed.
+	// hasLine() tells whether a line ended there. The line and its fields point into the data or into the
+	// buffer and stay valid until the next call
+	std::size_t feed(const char* data, std::size_t size);
+
+	bool hasLine() const
+	{
+		return m_state == State::LINE;
+	}
+
+	// Any line, e.g. a result code
+	std::string_view getLine() const
+	{
+		return {m_line, m_line_size};
+	}
+
+	// The line is a well-formed "+NAME:" line of the command
+	bool hasFields() const
+	{
+		return hasLine() && m_has_fields;
+	}
+
+	// Lines split between chunks that did not fit in the buffer
+	uint32_t getDiscarded() const
+	{
+		return m_discarded;
+	}
+
+protected:
+	const ResponseField& getField(std::size_t index) const
+	{
+		return m_fields[index];
+	}
+
+private:
+	enum class State : uint8_t
+	{
+		IDLE,
+		PARTIAL,
+		OVERFLOW,
+		LINE
+	};
+
+	void append(const char* data, std::size_t size);
+	void finishLine(const char* line, std::size_t size);
+	bool tokenize(const char* line, std::size_t size);
+
+	const char* m_name;
+	const ExtCmdParamDef* m_params;
+	uint8_t m_param_count;
+	ResponseField* m_fields;
+	char* m_buffer;
+	uint16_t m_capacity;
+	uint16_t m_size;
+	State m_state;
+	bool m_has_fields;
+	const char* m_line;
+	std::size_t m_line_size;
+	uint32_t m_discarded;
+};
+
+template<class T>
+struct ResponseParameters;
+
+template<class... Ts>
+struct ResponseParameters<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>
+{
+	static constexpr std::array<atcmd::server::detail::ExtCmdParamDef, sizeof...(Ts)> params =
+	{
+		atcmd::server::detail::ExtCmdParamDef::build<Ts>()...
+	};
+
+	template<class P>
+	static constexpr std::size_t index = []()
+	{
+		constexpr bool matches[] = {std::is_same_v<P, Ts>..., false};
+		std::size_t r = 0;
+		while ((r != sizeof...(Ts)) && !matches[r])
+		{
+			r++;
+		}
+		return r;
+	}();
+
+	// The longest line the server prints for the command: "+NAME: " and the fields
+	static consteval std::size_t getMaxLineSize(std::size_t name_size)
+	{
+		std::size_t r = name_size + 3;
+		for (const auto& param : params)
+		{
+			r += 1;
+			switch (param.param_type) {
+			case atcmd::server::detail::ExtCmdParamDef::TYPE::NUM_DEC:
+				r += 10;
+				break;
+			case atcmd::server::detail::ExtCmdParamDef::TYPE::NUM_HEX:
+				r += 8;
+				break;
+			case atcmd::server::detail::ExtCmdParamDef::TYPE::NUM_BIN:
+				r += 32;
+				break;
+			case atcmd::server::detail::ExtCmdParamDef::TYPE::STR:
+				// string_max_len counts the terminating zero. A streamed string is not bounded, only
+				// its quotes are counted
+				r += param.is_streamed ? 2 : param.string_max_len + 1;
+				break;
+			case atcmd::server::detail::ExtCmdParamDef::TYPE::STR_HEX:
+				r += param.is_streamed ? 2 : 2 * param.hexstring_max_size + 2;
+				break;
+			case atcmd::server::detail::ExtCmdParamDef::TYPE::ENUM:
+			{
+				std::size_t longest = 0;
+				for (uint16_t i = 0; i < param.enumeration->count; i++)
+				{
+					longest = std::max(longest, std::string_view(param.enumeration->values[i]).size());
+				}
+				r += longest + 2;
+				break;
+			}
+			}
+		}
+		return r;
+	}
+};
+
+} /* namespace detail */
+
+// Zero-copy incremental parser of the information text of a command, e.g. +CFG:5,"abc","01A2" for
+// ParameterList<Level, Label, Key>. Fields are decoded by the parameter definitions shared with the server.
+// Strings are returned as views into the received data, nothing is allocated. Lines split between chunks
+// are carried in a buffer sized for the longest line of the command
+template<atcmd::server::concepts::ExtendedCommand Cmd,
+		std::size_t capacity = detail::ResponseParameters<typename Cmd::Definition::Parameters>::getMaxLineSize(
+				sizeof(Cmd::Definition::name) - 1)>
+class ResponseParser : public detail::ResponseTokenizer
+{
+	using Parameters = detail::ResponseParameters<typename Cmd::Definition::Parameters>;
+
+	static_assert(capacity <= 0xFFFF, "The line buffer is too big");
+
+public:
+	ResponseParser() :
+		detail::ResponseTokenizer(Cmd::Definition::name, Parameters::params.data(), Parameters::params.size(),
+				m_fields.data(), m_buffer, capacity),
+		m_fields{}
+	{}
+
+	ResponseParser(const ResponseParser&) = delete;
+	ResponseParser& operator=(const ResponseParser&) = delete;
+
+	// Fields after the last printed one are not present
+	template<atcmd::server::concepts::Parameter P>
+	bool isPresent() const
+	{
+		return getField(index<P>()).is_present;
+	}
+
+	template<atcmd::server::concepts::NumericParameter P>
+	uint32_t getNumeric() const
+	{
+		return getField(index<P>()).number;
+	}
+
+	template<atcmd::server::concepts::StringParameter P>
+	std::string_view getString() const
+	{
+		const detail::ResponseField& field = getField(index<P>());
+		return {field.data, field.size};
+	}
+
+	// The hexadecimal digits
+	template<atcmd::server::concepts::HexadecimalStringParameter P>
+	std::string_view getHexString() const
+	{
+		const detail::ResponseField& field = getField(index<P>());
+		return {field.data, field.size};
+	}
+
+	// The index of the keyword in P::values
+	template<atcmd::server::concepts::EnumParameter P>
+	uint8_t getEnum() const
+	{
+		return static_cast<uint8_t>(getField(index<P>()).number);
+	}
+
+	// Decodes the bytes into out, returns their number
+	template<atcmd::server::concepts::HexadecimalStringParameter P>
+	std::size_t decodeHexString(uint8_t (&out)[P::max_size]) const
+	{
+		std::string_view digits = getHexString<P>();
+		for (std::size_t i = 0; i < digits.size() / 2; i++)
+		{
+			out[i] = static_cast<uint8_t>((atcmd::detail::Characters::getHex(digits[2 * i]) << 4) |
+					atcmd::detail::Characters::getHex(digits[2 * i + 1]));
+		}
+		return digits.size() / 2;
+	}
+
+private:
+	template<class P>
+	static consteval std::size_t index()
+	{
+		static_assert(Parameters::template index<P> < Parameters::params.size(), "Not a parameter of the command");
+		return Parameters::template index<P>;
+	}
+
+	std::array<detail::ResponseField, Parameters::params.size()> m_fields;
+	char m_buffer[capacity];
+};
+
+} /* namespace atcmd */
+
+#endif // ATCMD_RESPONSEPARSER_H
@@ -0,0 +1,160 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_RXRING_H
+#define ATCMD_RXRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace atcmd {
+
+// Single-producer single-consumer receive ring. The producer, usually a UART interrupt, writes received
+// characters in place and the consumer hands contiguous spans straight to Server::feed(). Each side only
+// stores its own index and loads the other, so no read-modify-write atomics are needed and the producer
+// never waits for the consumer
+template<std::size_t size>
+class RxRing
+{
+	static_assert((size != 0) && ((size & (size - 1)) == 0), "Receive ring size must be a power of two");
+	static_assert(size <= 0x80000000u, "Receive ring size must fit 32-bit indices");
+
+public:
+	RxRing() :
+		m_head{0},
+		m_tail{0},
+		m_dropped{0}
+	{
+	}
+
+	// Producer side. Free space up to the end of the storage, commit() publishes what was written into it
+	std::span<char> writeSpan()
+	{
+		uint32_t tail = m_tail.load(std::memory_order_relaxed);
+		uint32_t free = size - (tail - m_head.load(std::memory_order_acquire));
+		uint32_t offset = tail & mask;
+		return {m_data + offset, free < size - offset ? free : size - offset};
+	}
+
+	void commit(std::size_t count)
+	{
+		m_tail.store(m_tail.load(std::memory_order_relaxed) + static_cast<uint32_t>(count), std::memory_order_release);
+	}
+
+	// Producer side. Characters not fitting are dropped and counted
+	std::size_t write(const char* data, std::size_t count)
+	{
+		std::size_t written = 0;
+		while (written != count)
+		{
+			std::span<char> span = writeSpan();
+			if (span.empty())
+			{
+				m_dropped.store(m_dropped.load(std::memory_order_relaxed) + static_cast<uint32_t>(count - written),
+						std::memory_order_relaxed);
+				break;
+			}
+			std::size_t chunk = span.size() < count - written ? span.size() : count - written;
+			for (std::size_t i = 0; i < chunk; i++)
+			{
+				span[i] = data[written + i];
+			}
+			commit(chunk);
+			written += chunk;
+		}
+		return written;
+	}
+
+	bool push(char ch)
+	{
+		return write(&ch, 1) == 1;
+	}
+
+	// Consumer side. Received characters up to the end of the storage, consume() releases them
+	std::span<const char> readSpan() const
+	{
+		uint32_t head = m_head.load(std::memory_order_relaxed);
+		uint32_t used = m_tail.load(std::memory_order_acquire) - head;
+		uint32_t offset = head & mask;
+		return {m_data + offset, used < size - offset ? used : size - offset};
+	}
+
+	void consume(std::size_t count)
+	{
+		m_head.store(m_head.load(std::memory_order_relaxed) + static_cast<uint32_t>(count), std::memory_order_release);
+	}
+
+	// Consumer side. Hands the received spans to feed(data, size), which returns the number of characters it
+	// took, e.g. a lambda calling Server::feed(). Stops when feed takes less than offered, returns the total
+	template<class Feed>
+	std::size_t drain(Feed&& feed)
+	{
+		std::size_t total = 0;
+		while (true)
+		{
+			std::span<const char> span = readSpan();
+			if (span.empty())
+			{
+				return total;
+			}
+			std::size_t consumed = feed(span.data(), span.size());
+			consume(consumed);
+			total += consumed;
+			if (consumed != span.size())
+			{
+				return total;
+			}
+		}
+	}
+
+	bool isEmpty() const
+	{
+		return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_relaxed);
+	}
+
+	// Characters dropped by write() because the ring was full
+	uint32_t getDropped() const
+	{
+		return m_dropped.load(std::memory_order_relaxed);
+	}
+
+	static constexpr std::size_t capacity()
+	{
+		return size;
+	}
+
+private:
+	static constexpr uint32_t mask = size - 1;
+
+	char m_data[size];
+	std::atomic<uint32_t> m_head;
+	std::atomic<uint32_t> m_tail;
+	std::atomic<uint32_t> m_dropped;
+};
+
+} /* namespace atcmd */
+
+#endif // ATCMD_RXRING_H
@@ -28,6 +28,7 @@
 #include <atcmd/common.h>
 #include <atcmd/detail/characters.h>
 #include <atcmd/server/command_base.h>
+#include <atcmd/server/task.h>
 
 namespace atcmd::server {
 
@@ -42,7 +43,7 @@ struct BasicCommandBase : protected Command
 		friend class Server;
 
 	private:
-		BasicServerHandle(const uint8_t* param_start, Server& server, bool is_last_command, CALL_TYPE call_type);
+		BasicServerHandle(const uint8_t* param_start, Server& server, bool is_last_command, CALL_TYPE call_type, void* async_state);
 	};
 
 	struct BasicNumericParameter : public NumericParameter
@@ -75,10 +76,28 @@ protected:
 
 	using BasicServerHandle = detail::BasicCommandBase::BasicServerHandle;
 	using BasicNumericParameter = detail::BasicCommandBase::BasicNumericParameter;
+
+	using Task = atcmd::server::Task;
 };
 
 namespace concepts {
 
+// Coroutine handler returning a Task
+template<class T>
+concept BasicTaskCommand = requires
+{
+	{ static_cast<Task (*)(detail::BasicCommandBase::BasicServerHandle)>(&T::Definition::onExec) };
+};
+
+// Handler taking a reference to the AsyncState of the command
+template<class T>
+concept BasicStatefulCommand =
+	StatefulCommand<T> &&
+	requires
+	{
+		{ static_cast<atcmd::RESULT_CODE (*)(detail::BasicCommandBase::BasicServerHandle, typename T::Definition::AsyncState&)>(&T::Definition::onExec) };
+	};
+
 template<class T>
 concept AmpersandCommand =
 	detail::concepts::Command<T> &&
@@ -27,14 +27,24 @@
 
 #include <concepts>
 #include <cstdint>
+#include <new>
+#include <span>
+#include <type_traits>
 
+#include <atcmd/common.h>
 #include <atcmd/detail/cmdparamdef.h>
 
 namespace atcmd::server {
 
+class Task;
+
 namespace detail {
 
 class Server;
+class CoroutineFramePool;
+
+template<class Handle, Task (*handler)(Handle)>
+atcmd::RESULT_CODE runTask(Handle server_handle);
 
 struct CommandBase
 {
@@ -44,20 +54,34 @@ struct CommandBase
 		{
 			REQUEST,
 			ABORT,
-			RESPONSE
+			RESPONSE,
+			// A chunk of the raw payload of a command in data mode
+			DATA
 		};
 
 		Server& getServer();
 		CALL_TYPE getCallType() const;
 		void* getContext();
 
+		// Storage of the AsyncState of the called command, reserved by the server
+		void* getAsyncStateStorage();
+
 	protected:
+		// Coroutine handlers use it to allocate, keep and release their frame
+		friend class atcmd::server::Task;
+
+		template<class Handle, Task (*handler)(Handle)>
+		friend atcmd::RESULT_CODE runTask(Handle server_handle);
+
+		// Passed by the server instead of the AsyncState storage in the handlers of coroutine commands
+		CoroutineFramePool* getCoroutineFramePool();
+
 		struct InformationText
 		{
 			friend struct ServerHandle;
 
 		protected:
-			InformationText(Server& server, bool is_result_code);
+			InformationText(Server& server, bool is_result_code, bool is_suppressed = false);
 
 		public:
 			~InformationText();
@@ -68,9 +92,12 @@ struct CommandBase
 		protected:
 			Server& m_server;
 			bool m_is_result_code;
+
+			// Nothing is formatted or printed in suppressed mode
+			bool m_is_suppressed;
 		};
 
-		ServerHandle(Server& server, bool is_last_command, CALL_TYPE call_type);
+		ServerHandle(Server& server, bool is_last_command, CALL_TYPE call_type, void* async_state);
 
 		Server& m_server;
 		bool m_is_last_command;
@@ -80,6 +107,7 @@ struct CommandBase
 
 	private:
 		CALL_TYPE m_call_type;
+		void* m_async_state;
 	};
 
 	struct ParamServerHandle
@@ -131,6 +159,46 @@ template<class T>
 concept Parameter =
 	std::derived_from<T, detail::CommandBase::Parameter>;
 
+// The handler may block, so its requests are run by the executor when one is set
+template<class T>
+concept OffloadableCommand =
+	requires
+	{
+		{ T::Definition::offloadable } -> std::same_as<const bool&>;
+	} &&
+	T::Definition::offloadable;
+
+// The command has no ordering side effects: while an earlier concurrent command of the line waits for its
+// completion, its request is started too. The request must only start the operation and return ASYNC, the
+// information text is printed from the responses, which the server delivers in line order
+template<class T>
+concept ConcurrentCommand =
+	requires
+	{
+		{ T::Definition::concurrent } -> std::same_as<const bool&>;
+	} &&
+	T::Definition::concurrent;
+
+// An asynchronous command is aborted with ERROR when it does not complete within the given number
+// of timer wheel ticks
+template<class T>
+concept TimedCommand =
+	requires
+	{
+		{ T::Definition::timeout } -> std::same_as<const uint32_t&>;
+	} &&
+	(T::Definition::timeout > 0);
+
+// The handlers take a reference to a Definition::AsyncState, which the server value-initializes on the
+// request and keeps until the command completes. Storage for the largest state is reserved per server
+// and per command that can be in progress at the same time
+template<class T>
+concept StatefulCommand =
+	requires
+	{
+		typename T::Definition::AsyncState;
+	};
+
 template<class T>
 concept NumericParameter =
 	std::derived_from<T, detail::CommandBase::NumericParameter> &&
@@ -186,6 +254,26 @@ struct Command : public CommandBase
 	};
 };
 
+// Handlers taking an AsyncState are called through an adapter with the plain handler signature
+template<class Handle, class State, atcmd::RESULT_CODE (*handler)(Handle, State&)>
+atcmd::RESULT_CODE runWithState(Handle server_handle)
+{
+	static_assert(std::is_trivially_destructible_v<State>, "AsyncState is never destroyed, it must be trivially destructible");
+
+	void* storage = server_handle.getAsyncStateStorage();
+	if (server_handle.getCallType() == Handle::CALL_TYPE::REQUEST)
+	{
+		new (storage) State{};
+	}
+	return handler(server_handle, *std::launder(static_cast<State*>(storage)));
+}
+
+template<class Handle, class State, void (*handler)(Handle, std::span<const uint8_t>, State&)>
+void runDataWithState(Handle server_handle, std::span<const uint8_t> data)
+{
+	handler(server_handle, data, *std::launder(static_cast<State*>(server_handle.getAsyncStateStorage())));
+}
+
 } /* namespace detail */
 
 } /* namespace atcmd::server */
@@ -25,14 +25,23 @@
 #ifndef ATCMD_EXTENDEDCOMMAND_H
 #define ATCMD_EXTENDEDCOMMAND_H
 
+#include <algorithm>
 #include <concepts>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <string_view>
 #include <span>
+#include <utility>
+
+#include <assert.h>
 
 #include <atcmd/common.h>
 #include <atcmd/server/command_base.h>
+#include <atcmd/server/task.h>
 #include <atcmd/detail/characters.h>
+#include <atcmd/detail/responseformat.h>
+#include <atcmd/detail/responseframing.h>
 
 namespace atcmd::server {
 
@@ -54,8 +63,40 @@ struct ExtendedCommandBase1 : protected Command
 
 	struct HexadecimalStringParameter : public Parameter
 	{};
+
+	struct EnumParameter : public Parameter
+	{};
 };
 
+// Enumerated values are matched by a trie of the command name alphabet, so they must be non-empty,
+// unique and made of upper case letters, digits and "!%-./:_"
+consteval bool validateEnumValues(const char* const values[], std::size_t count)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		std::string_view value(values[i]);
+		if (value.empty())
+		{
+			return false;
+		}
+		for (char ch : value)
+		{
+			if (atcmd::detail::Characters::encode(ch) == 0xFF)
+			{
+				return false;
+			}
+		}
+		for (std::size_t j = 0; j < i; j++)
+		{
+			if (value == values[j])
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
 } /* namespace detail */
 
 namespace concepts {
@@ -102,11 +143,16 @@ template<class T>
 concept StringParameter =
 	ExtendedParameter<T> &&
 	std::derived_from<T, detail::ExtendedCommandBase1::StringParameter> &&
-	requires
+	((requires
 	{
 		{ T::max_length } -> std::same_as<const uint16_t&>;
 	} &&
-	(T::max_length <= 0xFFFE) &&
+	(T::max_length <= 0xFFFE)) ||
+	requires
+	{
+		{ T::max_length } -> std::same_as<const uint32_t&>;
+		{ T::chunk_size } -> std::same_as<const uint16_t&>;
+	}) &&
 	(!T::is_optional || (
 		requires
 		{
@@ -119,10 +165,15 @@ template<class T>
 concept HexadecimalStringParameter =
 	ExtendedParameter<T> &&
 	std::derived_from<T, detail::ExtendedCommandBase1::HexadecimalStringParameter> &&
-	requires
+	(requires
 	{
 		{ T::max_size } -> std::same_as<const uint16_t&>;
-	} &&
+	} ||
+	requires
+	{
+		{ T::max_size } -> std::same_as<const uint32_t&>;
+		{ T::chunk_size } -> std::same_as<const uint16_t&>;
+	}) &&
 	(!T::is_optional || (
 		requires
 		{
@@ -131,10 +182,50 @@ concept HexadecimalStringParameter =
 		(std::size(T::default_value) <= T::max_size)
 	));
 
+// A string parameter accepting only the keywords of T::values. The parser matches the value while it is
+// received and keeps the 1-byte index of the keyword, the default value is an index as well
+template<class T>
+concept EnumParameter =
+	ExtendedParameter<T> &&
+	std::derived_from<T, detail::ExtendedCommandBase1::EnumParameter> &&
+	requires
+	{
+		{ T::values } -> std::same_as<const char* const (&)[std::extent_v<decltype(T::values)>]>;
+	} &&
+	(std::size(T::values) <= 0x100) &&
+	detail::validateEnumValues(T::values, std::size(T::values)) &&
+	(!T::is_optional || (
+		requires
+		{
+			{T::default_value} -> std::same_as<const uint8_t&>;
+		} &&
+		(T::default_value < std::size(T::values))
+	));
+
+// A string or hexadecimal string with a chunk_size is not kept in the command line: the parser passes it
+// to onData in chunks of up to chunk_size bytes while the line is received, and only its total size is
+// left for the write handler. Its max_length or max_size may then be a uint32_t
+template<class T>
+concept StreamedParameter =
+	(StringParameter<T> || HexadecimalStringParameter<T>) &&
+	requires
+	{
+		{ T::chunk_size } -> std::same_as<const uint16_t&>;
+	};
+
 } /* namespace concepts */
 
 namespace detail {
 
+// The keyword of an enumerated parameter given by its index. An index past the keywords is a bug of the
+// handler, an empty keyword is printed if assertions are disabled
+template<atcmd::server::concepts::EnumParameter P>
+const char* getEnumValue(uint8_t index)
+{
+	assert((index < std::size(P::values)) && "Enumerated parameter index out of range");
+	return index < std::size(P::values) ? P::values[index] : "";
+}
+
 struct ExtendedCommandBase : public ExtendedCommandBase1
 {
 	template<atcmd::server::concepts::Parameter... Ts>
@@ -153,16 +244,32 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			static constexpr std::size_t offset = 0;
 		};
 
+		template<atcmd::server::concepts::Parameter P, atcmd::server::concepts::NumericParameter N, atcmd::server::concepts::Parameter... Ps>
+		struct OffsetCalc<P, N, Ps...>
+		{
+			static constexpr std::size_t offset = sizeof(uint32_t) + OffsetCalc<P, Ps...>::offset;
+		};
+
 		template<atcmd::server::concepts::Parameter P, atcmd::server::concepts::StringParameter S, atcmd::server::concepts::Parameter... Ps>
 		struct OffsetCalc<P, S, Ps...>
 		{
-			static constexpr std::size_t offset = S::max_length + 1 + OffsetCalc<P, Ps...>::offset;
+			static constexpr std::size_t offset =
+					(atcmd::server::concepts::StreamedParameter<S> ? sizeof(uint32_t) : S::max_length + 1) +
+					OffsetCalc<P, Ps...>::offset;
 		};
 
 		template<atcmd::server::concepts::Parameter P, atcmd::server::concepts::HexadecimalStringParameter H, atcmd::server::concepts::Parameter... Ps>
 		struct OffsetCalc<P, H, Ps...>
 		{
-			static constexpr std::size_t offset = H::max_size + sizeof(uint16_t) + OffsetCalc<P, Ps...>::offset;
+			static constexpr std::size_t offset =
+					(atcmd::server::concepts::StreamedParameter<H> ? sizeof(uint32_t) : H::max_size + sizeof(uint16_t)) +
+					OffsetCalc<P, Ps...>::offset;
+		};
+
+		template<atcmd::server::concepts::Parameter P, atcmd::server::concepts::EnumParameter E, atcmd::server::concepts::Parameter... Ps>
+		struct OffsetCalc<P, E, Ps...>
+		{
+			static constexpr std::size_t offset = sizeof(uint8_t) + OffsetCalc<P, Ps...>::offset;
 		};
 
 	public:
@@ -177,12 +284,14 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 		}
 
 		template<atcmd::server::concepts::StringParameter S>
+		requires (!atcmd::server::concepts::StreamedParameter<S>)
 		const char* getString() const
 		{
 			return reinterpret_cast<const char*>(&m_params[OffsetCalc<S, Ts...>::offset]);
 		}
 
 		template<atcmd::server::concepts::HexadecimalStringParameter H>
+		requires (!atcmd::server::concepts::StreamedParameter<H>)
 		std::span<const uint8_t> getHexString() const
 		{
 			static constexpr std::size_t offset = OffsetCalc<H, Ts...>::offset;
@@ -190,6 +299,20 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			uint16_t sz = m_params[sz_start] | (m_params[sz_start + 1] << 8);
 			return std::span<const uint8_t>(&m_params[offset], sz);
 		}
+
+		// The index of the received keyword in E::values
+		template<atcmd::server::concepts::EnumParameter E>
+		uint8_t getEnum() const
+		{
+			return m_params[OffsetCalc<E, Ts...>::offset];
+		}
+
+		// The number of characters or bytes passed to onData
+		template<atcmd::server::concepts::StreamedParameter S>
+		uint32_t getStreamedSize() const
+		{
+			return Base::getNumeric_(OffsetCalc<S, Ts...>::offset);
+		}
 	};
 
 	class TestServerHandle : public ServerHandle
@@ -200,16 +323,10 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 		struct ExtendedInformationText : public InformationText
 		{
 		protected:
-			ExtendedInformationText(Server& server, bool is_result_code, const char* name, bool is_silent);
-
-		public:
-			~ExtendedInformationText();
-
-		private:
-			PrintCharCallback m_print_char_callback;
+			ExtendedInformationText(Server& server, bool is_result_code, const char* name, bool is_suppressed);
 		};
 
-		TestServerHandle(Server& server, bool is_last_command, CALL_TYPE call_type);
+		TestServerHandle(Server& server, bool is_last_command, CALL_TYPE call_type, void* async_state);
 	};
 
 	struct WriteServerHandle :
@@ -220,7 +337,7 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 		friend struct ExtendedCommandBase;
 
 	private:
-		WriteServerHandle(const uint8_t* param_start, Server& server, bool is_last_command, CALL_TYPE call_type);
+		WriteServerHandle(const uint8_t* param_start, Server& server, bool is_last_command, CALL_TYPE call_type, void* async_state);
 	};
 
 	class ReadServerHandle : public TestServerHandle
@@ -237,7 +354,7 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			friend struct ParameterInformationTextSecond;
 
 		protected:
-			ParameterInformationText(Server& server, bool is_result_code, const char* name, bool is_silent);
+			ParameterInformationText(Server& server, bool is_result_code, const char* name, bool is_suppressed);
 
 		public:
 			ParameterInformationTextSecond printNumericParameter(uint32_t value, uint8_t base) &&;
@@ -264,8 +381,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			friend class ReadServerHandle;
 
 		protected:
-			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_silent) :
-				ParameterInformationText(server, is_result_code, name, is_silent)
+			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_suppressed) :
+				ParameterInformationText(server, is_result_code, name, is_suppressed)
 			{}
 
 		public:
@@ -275,7 +392,7 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			{
 				static_assert(std::same_as<P, T>, "Wrong order of parameters");
 				printNumericParameter_(value, base);
-				return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server);
+				return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server, m_is_suppressed);
 			}
 
 			template<atcmd::server::concepts::DecimalNumericParameter P>
@@ -289,8 +406,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			friend class ReadServerHandle;
 
 		protected:
-			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_silent) :
-				ParameterInformationText(server, is_result_code, name, is_silent)
+			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_suppressed) :
+				ParameterInformationText(server, is_result_code, name, is_suppressed)
 			{}
 
 		public:
@@ -301,8 +418,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 				static_assert(std::same_as<P, T>, "Wrong order of parameters");
 				printNumericParameter_(value, base);
 				// TODO probably a compiler bug
-				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server);
-				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server);
+				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server, m_is_suppressed);
+				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server, m_is_suppressed);
 			}
 
 			template<atcmd::server::concepts::HexadecimalNumericParameter P>
@@ -316,8 +433,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			friend class ReadServerHandle;
 
 		protected:
-			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_silent) :
-				ParameterInformationText(server, is_result_code, name, is_silent)
+			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_suppressed) :
+				ParameterInformationText(server, is_result_code, name, is_suppressed)
 			{}
 
 		public:
@@ -328,8 +445,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 				static_assert(std::same_as<P, T>, "Wrong order of parameters");
 				printNumericParameter_(value, base);
 				// TODO probably a compiler bug
-				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server);
-				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server);
+				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server, m_is_suppressed);
+				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server, m_is_suppressed);
 			}
 
 			template<atcmd::server::concepts::BinaryNumericParameter P>
@@ -343,8 +460,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			friend class ReadServerHandle;
 
 		protected:
-			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_silent) :
-				ParameterInformationText(server, is_result_code, name, is_silent)
+			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_suppressed) :
+				ParameterInformationText(server, is_result_code, name, is_suppressed)
 			{}
 
 		public:
@@ -355,8 +472,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 				static_assert(std::same_as<P, T>, "Wrong order of parameters");
 				printStringParameter_(s);
 				// TODO probably a compiler bug
-				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server);
-				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server);
+				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server, m_is_suppressed);
+				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server, m_is_suppressed);
 			}
 
 			template<atcmd::server::concepts::StringParameter P>
@@ -370,8 +487,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			friend class ReadServerHandle;
 
 		protected:
-			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_silent) :
-				ParameterInformationText(server, is_result_code, name, is_silent)
+			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_suppressed) :
+				ParameterInformationText(server, is_result_code, name, is_suppressed)
 			{}
 
 		public:
@@ -382,8 +499,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 				static_assert(std::same_as<P, T>, "Wrong order of parameters");
 				printHexadecimalStringParameter_(data, size);
 				// TODO probably a compiler bug
-				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server);
-				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server);
+				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server, m_is_suppressed);
+				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server, m_is_suppressed);
 			}
 
 			template<atcmd::server::concepts::HexadecimalStringParameter P>
@@ -391,12 +508,38 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			printHexadecimalStringParameter(const uint8_t* data, uint16_t size) & = delete;
 		};
 
+		template<atcmd::server::concepts::EnumParameter T, class... Ts>
+		struct ParameterInformationTextTmpl<ParameterList<T, Ts...>> : private ParameterInformationText
+		{
+			friend class ReadServerHandle;
+
+		protected:
+			ParameterInformationTextTmpl(Server& server, bool is_result_code, const char* name, bool is_suppressed) :
+				ParameterInformationText(server, is_result_code, name, is_suppressed)
+			{}
+
+		public:
+			// Prints the keyword T::values[index]
+			template<atcmd::server::concepts::EnumParameter P>
+			ParameterInformationTextSecondTmpl<ParameterList<Ts...>>
+			printEnumParameter(uint8_t index) &&
+			{
+				static_assert(std::same_as<P, T>, "Wrong order of parameters");
+				printStringParameter_(getEnumValue<T>(index));
+				return {m_server, m_is_suppressed};
+			}
+
+			template<atcmd::server::concepts::EnumParameter P>
+			ParameterInformationTextSecondTmpl<ParameterList<Ts...>>
+			printEnumParameter(uint8_t index) & = delete;
+		};
+
 		struct ParameterInformationTextSecond
 		{
 			friend struct ParameterInformationText;
 
 		protected:
-			explicit ParameterInformationTextSecond(Server& server);
+			ParameterInformationTextSecond(Server& server, bool is_suppressed);
 
 		public:
 			ParameterInformationTextSecond&& printNumericParameter(uint32_t value, uint8_t base) &&;
@@ -414,20 +557,21 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			void printHexadecimalStringParameter_(const uint8_t* data, uint16_t size);
 
 			detail::Server& m_server;
+			bool m_is_suppressed;
 		};
 
 		template<template<class...> class Pl>
 		struct ParameterInformationTextSecondTmpl<Pl<>>
 		{
 			// TODO move to protected, give friend access (does not work now for some reason)
-			explicit ParameterInformationTextSecondTmpl(Server&) {};
+			ParameterInformationTextSecondTmpl(Server&, bool) {};
 		};
 
 		template<atcmd::server::concepts::DecimalNumericParameter T, class... Ts>
 		struct ParameterInformationTextSecondTmpl<ParameterList<T, Ts...>> : private ParameterInformationTextSecond
 		{
-			explicit ParameterInformationTextSecondTmpl(Server& server) :
-				ParameterInformationTextSecond(server)
+			ParameterInformationTextSecondTmpl(Server& server, bool is_suppressed) :
+				ParameterInformationTextSecond(server, is_suppressed)
 			{}
 
 			template<atcmd::server::concepts::DecimalNumericParameter P>
@@ -436,7 +580,7 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			{
 				static_assert(std::same_as<P, T>, "Wrong order of parameters");
 				printNumericParameter_(value, base);
-				return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server);
+				return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server, m_is_suppressed);
 			}
 
 			template<atcmd::server::concepts::DecimalNumericParameter P>
@@ -447,8 +591,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 		template<atcmd::server::concepts::HexadecimalNumericParameter T, class... Ts>
 		struct ParameterInformationTextSecondTmpl<ParameterList<T, Ts...>> : private ParameterInformationTextSecond
 		{
-			explicit ParameterInformationTextSecondTmpl(Server& server) :
-				ParameterInformationTextSecond(server)
+			ParameterInformationTextSecondTmpl(Server& server, bool is_suppressed) :
+				ParameterInformationTextSecond(server, is_suppressed)
 			{}
 
 			template<atcmd::server::concepts::HexadecimalNumericParameter P>
@@ -458,8 +602,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 				static_assert(std::same_as<P, T>, "Wrong order of parameters");
 				printNumericParameter_(value, base);
 				// TODO probably a compiler bug
-				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server);
-				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server);
+				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server, m_is_suppressed);
+				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server, m_is_suppressed);
 			}
 
 			template<atcmd::server::concepts::HexadecimalNumericParameter P>
@@ -470,8 +614,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 		template<atcmd::server::concepts::BinaryNumericParameter T, class... Ts>
 		struct ParameterInformationTextSecondTmpl<ParameterList<T, Ts...>> : private ParameterInformationTextSecond
 		{
-			explicit ParameterInformationTextSecondTmpl(Server& server) :
-				ParameterInformationTextSecond(server)
+			ParameterInformationTextSecondTmpl(Server& server, bool is_suppressed) :
+				ParameterInformationTextSecond(server, is_suppressed)
 			{}
 
 			template<atcmd::server::concepts::BinaryNumericParameter P>
@@ -481,8 +625,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 				static_assert(std::same_as<P, T>, "Wrong order of parameters");
 				printNumericParameter_(value, base);
 				// TODO probably a compiler bug
-				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server);
-				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server);
+				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server, m_is_suppressed);
+				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server, m_is_suppressed);
 			}
 
 			template<atcmd::server::concepts::BinaryNumericParameter P>
@@ -493,8 +637,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 		template<atcmd::server::concepts::StringParameter T, class... Ts>
 		struct ParameterInformationTextSecondTmpl<ParameterList<T, Ts...>> : private ParameterInformationTextSecond
 		{
-			explicit ParameterInformationTextSecondTmpl(Server& server) :
-				ParameterInformationTextSecond(server)
+			ParameterInformationTextSecondTmpl(Server& server, bool is_suppressed) :
+				ParameterInformationTextSecond(server, is_suppressed)
 			{}
 
 			template<atcmd::server::concepts::StringParameter P>
@@ -504,8 +648,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 				static_assert(std::same_as<P, T>, "Wrong order of parameters");
 				printStringParameter_(s);
 				// TODO probably a compiler bug
-				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server);
-				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server);
+				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server, m_is_suppressed);
+				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server, m_is_suppressed);
 			}
 
 			template<atcmd::server::concepts::StringParameter P>
@@ -516,8 +660,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 		template<atcmd::server::concepts::HexadecimalStringParameter T, class... Ts>
 		struct ParameterInformationTextSecondTmpl<ParameterList<T, Ts...>> : private ParameterInformationTextSecond
 		{
-			explicit ParameterInformationTextSecondTmpl(Server& server) :
-				ParameterInformationTextSecond(server)
+			ParameterInformationTextSecondTmpl(Server& server, bool is_suppressed) :
+				ParameterInformationTextSecond(server, is_suppressed)
 			{}
 
 			template<atcmd::server::concepts::HexadecimalStringParameter P>
@@ -527,8 +671,8 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 				static_assert(std::same_as<P, T>, "Wrong order of parameters");
 				printHexadecimalStringParameter_(data, size);
 				// TODO probably a compiler bug
-				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server);
-				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server);
+				return atcmd::server::detail::ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecondTmpl<atcmd::server::detail::ExtendedCommandBase::ParameterList<Ts...>>(m_server, m_is_suppressed);
+				//return ParameterInformationTextSecondTmpl<ParameterList<Ts...>>(m_server, m_is_suppressed);
 			}
 
 			template<atcmd::server::concepts::HexadecimalStringParameter P>
@@ -536,9 +680,224 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 			printHexadecimalStringParameter(const uint8_t* data, uint16_t size) & = delete;
 		};
 
-		ReadServerHandle(detail::Server& server, bool is_last_command, CALL_TYPE call_type);
+		template<atcmd::server::concepts::EnumParameter T, class... Ts>
+		struct ParameterInformationTextSecondTmpl<ParameterList<T, Ts...>> : private ParameterInformationTextSecond
+		{
+			ParameterInformationTextSecondTmpl(Server& server, bool is_suppressed) :
+				ParameterInformationTextSecond(server, is_suppressed)
+			{}
+
+			template<atcmd::server::concepts::EnumParameter P>
+			ParameterInformationTextSecondTmpl<ParameterList<Ts...>>
+			printEnumParameter(uint8_t index) &&
+			{
+				static_assert(std::same_as<P, T>, "Wrong order of parameters");
+				printStringParameter_(getEnumValue<T>(index));
+				return {m_server, m_is_suppressed};
+			}
+
+			template<atcmd::server::concepts::EnumParameter P>
+			ParameterInformationTextSecondTmpl<ParameterList<Ts...>>
+			printEnumParameter(uint8_t index) & = delete;
+		};
+
+		// An enumerated parameter is given by the index of its keyword
+		template<class P>
+		using FormatArgument =
+				std::conditional_t<atcmd::server::concepts::StringParameter<P>, const char*,
+				std::conditional_t<atcmd::server::concepts::HexadecimalStringParameter<P>, std::span<const uint8_t>,
+				std::conditional_t<atcmd::server::concepts::EnumParameter<P>, uint8_t,
+				uint32_t>>>;
+
+		template<class Pl, atcmd::detail::FormatString format>
+		struct FormattedInformationText;
+
+		template<class... Ts, atcmd::detail::FormatString format>
+		struct FormattedInformationText<ParameterList<Ts...>, format>
+		{
+			using Format = atcmd::detail::ResponseFormat<format>;
+
+			static_assert(Format::placeholder_count == sizeof...(Ts), "Response template does not match the parameter list");
+
+			template<class P>
+			static consteval bool isQuoted()
+			{
+				return
+						atcmd::server::concepts::StringParameter<P> ||
+						atcmd::server::concepts::HexadecimalStringParameter<P> ||
+						atcmd::server::concepts::EnumParameter<P>;
+			}
+
+			template<std::size_t... I>
+			static consteval bool checkQuotes(std::index_sequence<I...>)
+			{
+				return ((Format::isQuoted(I) == isQuoted<Ts>()) && ...);
+			}
+
+			static_assert(checkQuotes(std::index_sequence_for<Ts...>{}),
+					"String placeholders must be quoted and numeric ones must not");
+
+			template<class P>
+			static consteval std::size_t getMaxSize()
+			{
+				if constexpr (atcmd::server::concepts::StringParameter<P>)
+				{
+					return P::max_length;
+				}
+				else if constexpr (atcmd::server::concepts::HexadecimalStringParameter<P>)
+				{
+					return P::max_size * 2;
+				}
+				else if constexpr (atcmd::server::concepts::EnumParameter<P>)
+				{
+					std::size_t r = 0;
+					for (const char* value : P::values)
+					{
+						r = std::max(r, std::string_view(value).size());
+					}
+					return r;
+				}
+				else
+				{
+					return atcmd::detail::Characters::formatNumber(0xFFFFFFFF, getBase<P>(), nullptr);
+				}
+			}
+
+			template<class P>
+			static consteval uint8_t getBase()
+			{
+				if constexpr (atcmd::server::concepts::HexadecimalNumericParameter<P>)
+				{
+					return 16;
+				}
+				else if constexpr (atcmd::server::concepts::BinaryNumericParameter<P>)
+				{
+					return 2;
+				}
+				else
+				{
+					return 10;
+				}
+			}
+
+			static constexpr std::size_t max_size =
+					2 * ResponseFraming::max_framing_size + Format::literal_size + (getMaxSize<Ts>() + ... + 0);
+
+			// The text is composed on the stack in parts of up to buffer_size characters, so a short text is
+			// printed with a single write and a long one does not need a buffer of its full size
+			static constexpr std::size_t buffer_size = std::min<std::size_t>(max_size, 64);
+
+			struct Writer
+			{
+				explicit Writer(ReadServerHandle& server_handle) :
+					handle{server_handle}
+				{}
+
+				ReadServerHandle& handle;
+				std::size_t size = 0;
+				char buf[buffer_size];
+
+				void append(std::string_view text)
+				{
+					while (!text.empty())
+					{
+						if (size == buffer_size)
+						{
+							flush();
+						}
+						std::size_t part = std::min(text.size(), buffer_size - size);
+						std::memcpy(&buf[size], text.data(), part);
+						size += part;
+						text.remove_prefix(part);
+					}
+				}
+
+				void flush()
+				{
+					handle.printBuffer(buf, size);
+					size = 0;
+				}
+			};
+
+			// Strings longer than max_length and hexadecimal strings longer than max_size are cut to the declared
+			// size, the longest value a client expects
+			template<class P>
+			static void appendParameter(Writer& writer, FormatArgument<P> value)
+			{
+				if constexpr (atcmd::server::concepts::StringParameter<P>)
+				{
+					std::size_t length = 0;
+					while ((length < P::max_length) && (value[length] != '\0'))
+					{
+						length++;
+					}
+					writer.append(std::string_view(value, length));
+				}
+				else if constexpr (atcmd::server::concepts::HexadecimalStringParameter<P>)
+				{
+					std::size_t size = value.size() < P::max_size ? value.size() : P::max_size;
+					char digits[32];
+					for (std::size_t i = 0; i < size; i += sizeof(digits) / 2)
+					{
+						std::size_t part = std::min(size - i, sizeof(digits) / 2);
+						atcmd::detail::Characters::formatHexadecimalString(&value[i], part, digits);
+						writer.append(std::string_view(digits, part * 2));
+					}
+				}
+				else if constexpr (atcmd::server::concepts::EnumParameter<P>)
+				{
+					writer.append(getEnumValue<P>(value));
+				}
+				else
+				{
+					char digits[atcmd::detail::Characters::max_number_size];
+					writer.append(std::string_view(digits, atcmd::detail::Characters::formatNumber(value, getBase<P>(), digits)));
+				}
+			}
+
+			static void print(ReadServerHandle& handle, bool is_result_code, FormatArgument<Ts>... args)
+			{
+				print_(handle, is_result_code, std::index_sequence_for<Ts...>{}, args...);
+			}
+
+			template<std::size_t... I>
+			static void print_(ReadServerHandle& handle, bool is_result_code, std::index_sequence<I...>, FormatArgument<Ts>... args)
+			{
+				if (is_result_code && !handle.m_is_last_command)
+				{
+					return;
+				}
+
+				const ResponseFraming& framing = handle.getResponseFraming();
+				Writer writer(handle);
+				writer.append(is_result_code ? framing.getResultCodeHeader() : framing.getInformationTextHeader());
+				writer.append(Format::template getSegment<0>());
+				((appendParameter<Ts>(writer, args), writer.append(Format::template getSegment<I + 1>())), ...);
+				writer.append(is_result_code ? framing.getResultCodeTrailer() : framing.getInformationTextTrailer());
+				writer.flush();
+			}
+		};
+
+		ReadServerHandle(detail::Server& server, bool is_last_command, CALL_TYPE call_type, void* async_state);
+
+		const ResponseFraming& getResponseFraming();
+		void printBuffer(const char* data, std::size_t size);
 
 	public:
+		// Prints the whole information text, composed on the stack and written in parts of up to 64 characters.
+		// The template, e.g. "+CMD:{},\"{}\"", is checked against the parameter list at compile time
+		template<class Pl, atcmd::detail::FormatString format, class... Args>
+		void printInformationText(Args&&... args)
+		{
+			FormattedInformationText<Pl, format>::print(*this, false, std::forward<Args>(args)...);
+		}
+
+		template<class Pl, atcmd::detail::FormatString format, class... Args>
+		void printResultCodeText(Args&&... args)
+		{
+			FormattedInformationText<Pl, format>::print(*this, true, std::forward<Args>(args)...);
+		}
+
 		ParameterInformationText makeParameterInformationText(const char* name, bool is_result_code = false);
 
 		template<class Pl>
@@ -551,6 +910,7 @@ struct ExtendedCommandBase : public ExtendedCommandBase1
 	using ReadMethod = atcmd::RESULT_CODE (*)(ReadServerHandle);
 	using WriteMethod = atcmd::RESULT_CODE (*)(WriteServerHandle);
 	using TestMethod = const char* (*)(TestServerHandle);
+	using DataMethod = void (*)(WriteServerHandle, std::span<const uint8_t>);
 };
 
 } /* namespace detail */
@@ -566,33 +926,125 @@ protected:
 	using ReadServerHandle = detail::ExtendedCommandBase::ReadServerHandle;
 	using WriteServerHandle = detail::ExtendedCommandBase::WriteServerHandle;
 
+	using Task = atcmd::server::Task;
+
 	using DecimalNumericParameter = detail::ExtendedCommandBase::DecimalNumericParameter;
 	using HexadecimalNumericParameter = detail::ExtendedCommandBase::HexadecimalNumericParameter;
 	using BinaryNumericParameter = detail::ExtendedCommandBase::BinaryNumericParameter;
 	using StringParameter = detail::ExtendedCommandBase::StringParameter;
 	using HexadecimalStringParameter = detail::ExtendedCommandBase::HexadecimalStringParameter;
+	using EnumParameter = detail::ExtendedCommandBase::EnumParameter;
 };
 
 namespace concepts {
 
+// Coroutine handlers returning a Task
 template<class T>
-concept ExtendedWriteCommand = requires
+concept ExtendedWriteTaskCommand = requires
 {
-	{ static_cast<detail::ExtendedCommandBase::WriteMethod>(&T::Definition::onWrite) };
+	{ static_cast<Task (*)(detail::ExtendedCommandBase::WriteServerHandle)>(&T::Definition::onWrite) };
 };
 
 template<class T>
-concept ExtendedReadCommand = requires
+concept ExtendedReadTaskCommand = requires
 {
-	{ static_cast<detail::ExtendedCommandBase::ReadMethod>(&T::Definition::onRead) };
+	{ static_cast<Task (*)(detail::ExtendedCommandBase::ReadServerHandle)>(&T::Definition::onRead) };
 };
 
+// Handlers taking a reference to the AsyncState of the command
+template<class T>
+concept ExtendedWriteStatefulCommand =
+	StatefulCommand<T> &&
+	requires
+	{
+		{ static_cast<atcmd::RESULT_CODE (*)(detail::ExtendedCommandBase::WriteServerHandle, typename T::Definition::AsyncState&)>(&T::Definition::onWrite) };
+	};
+
+template<class T>
+concept ExtendedReadStatefulCommand =
+	StatefulCommand<T> &&
+	requires
+	{
+		{ static_cast<atcmd::RESULT_CODE (*)(detail::ExtendedCommandBase::ReadServerHandle, typename T::Definition::AsyncState&)>(&T::Definition::onRead) };
+	};
+
+template<class T>
+concept ExtendedWriteCommand =
+	requires
+	{
+		{ static_cast<detail::ExtendedCommandBase::WriteMethod>(&T::Definition::onWrite) };
+	} ||
+	ExtendedWriteTaskCommand<T> ||
+	ExtendedWriteStatefulCommand<T>;
+
+template<class T>
+concept ExtendedReadCommand =
+	requires
+	{
+		{ static_cast<detail::ExtendedCommandBase::ReadMethod>(&T::Definition::onRead) };
+	} ||
+	ExtendedReadTaskCommand<T> ||
+	ExtendedReadStatefulCommand<T>;
+
+// A write handler returning CONNECT switches the channel to data mode. The raw payload is passed to onData
+// in chunks as it arrives, then the write handler is called with RESPONSE and the line goes on. The payload
+// is either the number of bytes given by the DataSize parameter or everything up to the data_escape sequence.
+// onData also receives the chunks of streamed parameters, see StreamedParameter
+template<class T>
+concept ExtendedDataCommand =
+	ExtendedWriteCommand<T> &&
+	(requires
+	{
+		{ static_cast<detail::ExtendedCommandBase::DataMethod>(&T::Definition::onData) };
+	} ||
+	(StatefulCommand<T> &&
+	requires
+	{
+		{ static_cast<void (*)(detail::ExtendedCommandBase::WriteServerHandle, std::span<const uint8_t>, typename T::Definition::AsyncState&)>(&T::Definition::onData) };
+	}));
+
+template<class T>
+concept SizedExtendedDataCommand =
+	ExtendedDataCommand<T> &&
+	requires
+	{
+		typename T::Definition::DataSize;
+	};
+
+template<class T>
+concept EscapedExtendedDataCommand =
+	ExtendedDataCommand<T> &&
+	requires
+	{
+		{ T::Definition::data_escape } -> std::convertible_to<const char*>;
+	};
+
 template<class T>
 concept ExtendedTestCommand = requires
 {
 	{ static_cast<detail::ExtendedCommandBase::TestMethod>(&T::Definition::onTest) };
 };
 
+// Opt-in response caching: the handler output is recorded into a buffer of the given size and replayed
+// until the cache is invalidated
+template<class T>
+concept CachedExtendedReadCommand =
+	ExtendedReadCommand<T> &&
+	requires
+	{
+		{ T::Definition::read_cache_size } -> std::same_as<const uint16_t&>;
+	} &&
+	(T::Definition::read_cache_size > 0);
+
+template<class T>
+concept CachedExtendedTestCommand =
+	ExtendedTestCommand<T> &&
+	requires
+	{
+		{ T::Definition::test_cache_size } -> std::same_as<const uint16_t&>;
+	} &&
+	(T::Definition::test_cache_size > 0);
+
 template<class T>
 concept ExtendedCommand =
 	detail::concepts::Command<T> &&
@@ -0,0 +1,253 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_FRAME_H
+#define ATCMD_FRAME_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include <atcmd/detail/server_cmdline.h>
+
+namespace atcmd::server {
+
+namespace detail {
+
+template<class T>
+struct FrameParameters;
+
+template<class... Ts>
+struct FrameParameters<ExtendedCommandBase::ParameterList<Ts...>>
+{
+	static constexpr std::size_t count = sizeof...(Ts);
+
+	template<std::size_t index>
+	using Type = std::tuple_element_t<index, std::tuple<Ts...>>;
+};
+
+} /* namespace detail */
+
+// Composes a binary frame for Server::execFrame() of a server with the same settings, e.g.
+// FrameEncoder<Settings>(buffer).write<Cfg>(5, "abc", std::nullopt).read<Mode>().getFrame().
+// Parameters left out or given as std::nullopt take their default values. Values are checked the way
+// the server checks them, a rejected value or a full buffer invalidates the frame
+template<concepts::ServerSettings Settings>
+class FrameEncoder
+{
+	using Cmdline = detail::ServerCmdline<Settings>;
+	using CMD_TYPE = typename Cmdline::CMD_TYPE;
+
+public:
+	explicit FrameEncoder(std::span<uint8_t> buffer) :
+		m_buffer{buffer},
+		m_size{0},
+		m_is_valid{true}
+	{}
+
+	template<concepts::ExtendedCommand Cmd>
+	FrameEncoder& read()
+	{
+		static_assert(concepts::ExtendedReadCommand<Cmd>, "The command is not readable");
+		addCmdId<Cmd, CMD_TYPE::READ>();
+		return *this;
+	}
+
+	template<concepts::ExtendedCommand Cmd>
+	FrameEncoder& test()
+	{
+		addCmdId<Cmd, CMD_TYPE::TEST>();
+		return *this;
+	}
+
+	template<concepts::ExtendedCommand Cmd, class... Args>
+	FrameEncoder& write(const Args&... args)
+	{
+		static_assert(concepts::ExtendedWriteCommand<Cmd>, "The command is not writable");
+		using Parameters = detail::FrameParameters<typename Cmd::Definition::Parameters>;
+		static_assert(sizeof...(Args) <= Parameters::count, "Too many parameters");
+
+		addCmdId<Cmd, CMD_TYPE::WRITE>();
+		[&]<std::size_t... Is>(std::index_sequence<Is...>)
+		{
+			(addParameter<typename Parameters::template Type<Is>>(args), ...);
+		}(std::index_sequence_for<Args...>());
+		[&]<std::size_t... Is>(std::index_sequence<Is...>)
+		{
+			(addParameter<typename Parameters::template Type<sizeof...(Args) + Is>>(std::nullopt), ...);
+		}(std::make_index_sequence<Parameters::count - sizeof...(Args)>());
+		return *this;
+	}
+
+	// False after a value the server would reject or when the buffer is full
+	bool isValid() const
+	{
+		return m_is_valid;
+	}
+
+	std::span<const uint8_t> getFrame() const
+	{
+		return m_buffer.first(m_size);
+	}
+
+private:
+	template<class Cmd, CMD_TYPE cmd_type>
+	void addCmdId()
+	{
+		static constexpr uint16_t cmd_id =
+				Cmdline::getExtCmdId(Settings::ExtendedCommands::template getCommandPosition<Cmd>(), cmd_type);
+		uint8_t* dest = reserve(sizeof(cmd_id));
+		if (dest != nullptr)
+		{
+			dest[0] = cmd_id & 0xFF;
+			dest[1] = cmd_id >> 8;
+		}
+	}
+
+	template<class P, class Arg>
+	void addParameter(const Arg& arg)
+	{
+		static_assert(!concepts::StreamedParameter<P>, "A streamed parameter can not be sent in a frame");
+
+		if constexpr (std::same_as<Arg, std::nullopt_t>)
+		{
+			static_assert(P::is_optional, "Only optional parameters can be left out");
+			if constexpr (concepts::NumericParameter<P>)
+			{
+				addNumber(P::default_value);
+			}
+			else if constexpr (concepts::StringParameter<P>)
+			{
+				addString(P::default_value, P::max_length);
+			}
+			else if constexpr (concepts::HexadecimalStringParameter<P>)
+			{
+				addHexString(P::default_value, P::max_size);
+			}
+			else
+			{
+				addByte(P::default_value);
+			}
+		}
+		else if constexpr (concepts::NumericParameter<P>)
+		{
+			static_assert(std::integral<Arg>, "A numeric parameter takes an integer");
+			static constexpr detail::CmdParamDef::Ranges ranges =
+			{
+				.count = std::size(P::ranges),
+				.ranges = P::ranges
+			};
+			m_is_valid &= std::in_range<uint32_t>(arg) &&
+					detail::CmdParamDef::validateNumericRanges(ranges, static_cast<uint32_t>(arg));
+			addNumber(static_cast<uint32_t>(arg));
+		}
+		else if constexpr (concepts::StringParameter<P>)
+		{
+			static_assert(std::convertible_to<const Arg&, std::string_view>, "A string parameter takes a string");
+			addString(arg, P::max_length);
+		}
+		else if constexpr (concepts::HexadecimalStringParameter<P>)
+		{
+			static_assert(std::convertible_to<const Arg&, std::span<const uint8_t>>, "A hexadecimal string parameter takes bytes");
+			addHexString(arg, P::max_size);
+		}
+		else
+		{
+			static_assert(std::integral<Arg>, "An enumerated parameter takes the index of its keyword");
+			m_is_valid &= std::in_range<uint8_t>(arg) && (static_cast<std::size_t>(arg) < std::size(P::values));
+			addByte(static_cast<uint8_t>(arg));
+		}
+	}
+
+	void addNumber(uint32_t value)
+	{
+		uint8_t* dest = reserve(sizeof(value));
+		for (std::size_t i = 0; (dest != nullptr) && (i < sizeof(value)); i++)
+		{
+			dest[i] = static_cast<uint8_t>(value >> (8 * i));
+		}
+	}
+
+	void addByte(uint8_t value)
+	{
+		uint8_t* dest = reserve(sizeof(value));
+		if (dest != nullptr)
+		{
+			*dest = value;
+		}
+	}
+
+	// Zero-terminated and padded to the maximum length, as the parser leaves it
+	void addString(std::string_view value, uint16_t max_length)
+	{
+		m_is_valid &= (value.size() <= max_length) && (value.find('\0') == std::string_view::npos);
+		uint8_t* dest = reserve(max_length + 1u);
+		if (dest != nullptr)
+		{
+			std::size_t size = value.size() < max_length ? value.size() : max_length;
+			std::fill_n(std::copy_n(value.data(), size, dest), max_length + 1u - size, 0);
+		}
+	}
+
+	// The bytes padded to the maximum size, then the size
+	void addHexString(std::span<const uint8_t> value, uint16_t max_size)
+	{
+		m_is_valid &= value.size() <= max_size;
+		uint8_t* dest = reserve(max_size + sizeof(uint16_t));
+		if (dest != nullptr)
+		{
+			uint16_t size = value.size() < max_size ? static_cast<uint16_t>(value.size()) : max_size;
+			std::fill_n(std::copy_n(value.data(), size, dest), max_size - size, 0);
+			dest[max_size] = size & 0xFF;
+			dest[max_size + 1] = size >> 8;
+		}
+	}
+
+	uint8_t* reserve(std::size_t size)
+	{
+		if (m_buffer.size() - m_size < size)
+		{
+			m_is_valid = false;
+			return nullptr;
+		}
+		uint8_t* r = &m_buffer[m_size];
+		m_size += size;
+		return r;
+	}
+
+	std::span<uint8_t> m_buffer;
+	std::size_t m_size;
+	bool m_is_valid;
+};
+
+} /* namespace atcmd::server */
+
+#endif // ATCMD_FRAME_H
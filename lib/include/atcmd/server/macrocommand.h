@@ -0,0 +1,109 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_MACROCOMMAND_H
+#define ATCMD_MACROCOMMAND_H
+
+#include <atcmd/server/extendedcommand.h>
+#include <atcmd/detail/server_cmdline.h>
+
+namespace atcmd::server {
+
+// Optional command for the macro slots of servers with macro_slot_count in the settings, added to their
+// ExtendedCommands as MacroCommand<Settings>:
+// AT+MACRO=<slot>;<commands> stores the following commands in the slot instead of executing them,
+// AT+MACRO=<slot>,1 runs the slot in place of the command, before the rest of the line,
+// AT+MACRO? lists the stored slots
+template<class Settings>
+struct MacroCommand : public ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "MACRO";
+
+		struct Slot : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			// The bound is given as the settings are incomplete in their ExtendedCommands, the initializer is
+			// only instantiated once they are complete
+			static constexpr Range ranges[1] = {{0, Settings::macro_slot_count - 1}};
+		};
+
+		struct Mode : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint32_t default_value = 0;
+			static constexpr Range ranges[] = {{0, 1}};
+		};
+
+		using Parameters = ParameterList<Slot, Mode>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			uint32_t slot = parameters.template getNumeric<Slot>();
+			bool r;
+			if (parameters.template getNumeric<Mode>() == 0)
+			{
+				r = getServer(server_handle).storeLineTail(slot);
+			}
+			else
+			{
+				r = getServer(server_handle).expandMacro(slot);
+			}
+			return r ? atcmd::RESULT_CODE::OK : atcmd::RESULT_CODE::ERROR;
+		}
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			for (std::size_t slot = 0; slot < Settings::macro_slot_count; slot++)
+			{
+				if (getServer(server_handle).isMacroStored(slot))
+				{
+					server_handle.makeParameterInformationText<Parameters>(name)
+							.template printNumericParameter<Slot>(slot);
+				}
+			}
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static const char* onTest(TestServerHandle /*server_handle*/)
+		{
+			return name;
+		}
+
+	private:
+		template<class Handle>
+		static detail::ServerCmdline<Settings>& getServer(Handle& server_handle)
+		{
+			// Only servers with these settings execute the command
+			return static_cast<detail::ServerCmdline<Settings>&>(server_handle.getServer());
+		}
+	};
+};
+
+} /* namespace atcmd::server */
+
+#endif // ATCMD_MACROCOMMAND_H
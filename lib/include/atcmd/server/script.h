@@ -0,0 +1,56 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_SCRIPT_H
+#define ATCMD_SCRIPT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <atcmd/detail/scriptbuilder.h>
+
+namespace atcmd::server {
+
+// A command line encoded at compile time the way the parser fills the command line buffer
+template<concepts::ServerSettings Settings, std::size_t size>
+struct Script
+{
+	std::array<uint8_t, size> data;
+};
+
+// Encodes a command line for Server::execScript(), e.g.
+// static constexpr auto boot = atcmd::server::makeScript<Settings, "ATE0V1+CFG=1,\"abc\";+MODE?">();
+// Syntax and range errors fail the compilation at a call to a detail::ScriptError function naming the error
+template<concepts::ServerSettings Settings, atcmd::detail::FormatString line>
+consteval auto makeScript()
+{
+	constexpr auto data = detail::ScriptBuilder<Settings>::template build<line>();
+	return Script<Settings, data.size()>{data};
+}
+
+} /* namespace atcmd::server */
+
+#endif // ATCMD_SCRIPT_H
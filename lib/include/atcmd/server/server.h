@@ -30,6 +30,7 @@
 #include <atcmd/detail/server_cmdline.h>
 #include <atcmd/detail/characters.h>
 #include <atcmd/server/sparameters.h>
+#include <atcmd/server/script.h>
 
 namespace atcmd::server {
 
@@ -58,6 +59,7 @@ class Server :
 {
 	using Base = detail::ServerCmdline<Settings>;
 	using T = detail::ServerTrieHolder<Settings::ExtendedCommands::size, typename Settings::ExtendedCommands>;
+	using CALL_TYPE = detail::Command::ServerHandle::CALL_TYPE;
 
 public:
 	using Base::getCommunicationParameters;
@@ -65,43 +67,91 @@ public:
 	Server(PrintCharCallback print_char_callback, void* context = nullptr) :
 		detail::ServerCmdline<Settings>(print_char_callback, context),
 		m_state{&Server::stateA}
-	{}
+	{
+		if constexpr (Base::uses_timer)
+		{
+			Base::m_timer.callback = &Server::onTimerExpired;
+			Base::m_timer.context = this;
+		}
+	}
 
-	void feed(char ch, bool abortable = false)
+	~Server()
 	{
-		if (getCommunicationParameters().isEchoEnabled())
+		if constexpr (Base::uses_timer)
 		{
-			Base::printChar(ch);
+			Base::cancelTimer();
 		}
+	}
 
-		if constexpr (Settings::ExtendedCommands::size != 0)
+	void feed(char ch, bool abortable = false)
+	{
+		if constexpr (concepts::CompletionQueueSettings<Settings>)
 		{
-			if (m_state != &Server::stateExtendedParamString)
+			processCompletions();
+			if (Base::isOffloaded())
 			{
-				ch = atcmd::detail::Characters::toUpper(ch);
+				// The server belongs to the executor thread, the character is dropped. An abortable one aborts
+				// the command once the handler has returned
+				if (abortable)
+				{
+					postAbort();
+				}
+				return;
 			}
 		}
-		else
+		feedChar(ch, abortable);
+	}
+
+	// Feeds a received block and returns the number of characters consumed. Completions are processed
+	// once per block. Feeding stops while a handler is offloaded, the rest of the block is to be fed again
+	// after processCompletions() instead of being dropped. The payload of a command in data mode is passed
+	// to its handler in place
+	std::size_t feed(const char* data, std::size_t size, bool abortable = false)
+	{
+		if constexpr (concepts::CompletionQueueSettings<Settings>)
 		{
-			ch = atcmd::detail::Characters::toUpper(ch);
+			processCompletions();
 		}
-		(this->*m_state)(ch, abortable);
+		for (std::size_t i = 0; i < size;)
+		{
+			if constexpr (concepts::CompletionQueueSettings<Settings>)
+			{
+				if (Base::isOffloaded())
+				{
+					return i;
+				}
+			}
+			if constexpr (Base::has_data_mode_commands)
+			{
+				if (Base::isDataMode())
+				{
+					i += feedData(&data[i], size - i);
+					continue;
+				}
+			}
+			feedChar(data[i++], abortable);
+		}
+		return size;
+	}
+
+	// Command and inter-character timeouts are counted by the wheel. It must be ticked on the thread
+	// that feeds the server, the timeouts are handled from TimerWheel::tick()
+	void setTimerWheel(TimerWheel& timer_wheel) requires (Base::uses_timer)
+	{
+		Base::cancelTimer();
+		Base::m_timer_wheel = &timer_wheel;
 	}
 
 	template<concepts::BasicCommand Cmd>
 	void onBasicCommandExecUpdate()
 	{
-		static constexpr uint16_t cmd_id =
-				Base::getBasicCmdOffset() + 1 + Settings::BasicCommands::template getCommandPosition<Cmd>();
-		continueCmdExec(cmd_id);
+		continueCmdExec(getBasicCmdId<Cmd>());
 	}
 
 	template<concepts::AmpersandCommand Cmd>
 	void onAmpersandCommandExecUpdate()
 	{
-		static constexpr uint16_t cmd_id =
-				Base::getAmpersandCmdOffset() + Settings::AmpersandCommands::template getCommandPosition<Cmd>();
-		continueCmdExec(cmd_id);
+		continueCmdExec(getAmpersandCmdId<Cmd>());
 	}
 
 	template<concepts::ExtendedCommand Cmd>
@@ -109,9 +159,7 @@ public:
 	{
 		if constexpr (Settings::ExtendedCommands::size != 0)
 		{
-			static constexpr uint16_t cmd_id =
-					Base::getExtCmdId(Settings::ExtendedCommands::template getCommandPosition<Cmd>(), CMD_TYPE::READ);
-			continueCmdExec(cmd_id);
+			continueCmdExec(getExtCmdId<Cmd>(CMD_TYPE::READ));
 		}
 	}
 
@@ -120,9 +168,173 @@ public:
 	{
 		if constexpr (Settings::ExtendedCommands::size != 0)
 		{
-			static constexpr uint16_t cmd_id =
-					Base::getExtCmdId(Settings::ExtendedCommands::template getCommandPosition<Cmd>(), CMD_TYPE::WRITE);
-			continueCmdExec(cmd_id);
+			continueCmdExec(getExtCmdId<Cmd>(CMD_TYPE::WRITE));
+		}
+	}
+
+	// The post*() methods can be called from any thread or interrupt when Settings::completion_queue_size
+	// is defined. The completions are handled on the server thread by processCompletions() or feed().
+	// They return false if the queue is full
+	template<concepts::BasicCommand Cmd>
+	bool postBasicCommandExecUpdate() requires concepts::CompletionQueueSettings<Settings>
+	{
+		return Base::m_completions.push({getBasicCmdId<Cmd>(), CALL_TYPE::RESPONSE});
+	}
+
+	template<concepts::AmpersandCommand Cmd>
+	bool postAmpersandCommandExecUpdate() requires concepts::CompletionQueueSettings<Settings>
+	{
+		return Base::m_completions.push({getAmpersandCmdId<Cmd>(), CALL_TYPE::RESPONSE});
+	}
+
+	template<concepts::ExtendedCommand Cmd>
+	bool postExtendedCommandReadUpdate() requires concepts::CompletionQueueSettings<Settings>
+	{
+		return Base::m_completions.push({getExtCmdId<Cmd>(CMD_TYPE::READ), CALL_TYPE::RESPONSE});
+	}
+
+	template<concepts::ExtendedCommand Cmd>
+	bool postExtendedCommandWriteUpdate() requires concepts::CompletionQueueSettings<Settings>
+	{
+		return Base::m_completions.push({getExtCmdId<Cmd>(CMD_TYPE::WRITE), CALL_TYPE::RESPONSE});
+	}
+
+	// Aborts the command being executed, as an abortable character would
+	bool postAbort() requires concepts::CompletionQueueSettings<Settings>
+	{
+		return Base::m_completions.push({0, CALL_TYPE::ABORT});
+	}
+
+	void processCompletions() requires concepts::CompletionQueueSettings<Settings>
+	{
+		if constexpr (Base::has_offloadable_commands)
+		{
+			if (Base::isOffloadFinished() && Base::finishOffloadedCmdExec())
+			{
+				m_state = &Server::stateA;
+			}
+		}
+
+		// Completions posted while a request is offloaded wait until it is finished
+		detail::Completion completion;
+		while (!Base::isOffloaded() && Base::m_completions.pop(completion))
+		{
+			if (completion.call_type == CALL_TYPE::ABORT)
+			{
+				if ((m_state == &Server::stateExecuting) && abortCmdExec())
+				{
+					m_state = &Server::stateA;
+				}
+			}
+			else
+			{
+				continueCmdExec(completion.cmd_id);
+			}
+		}
+		flushUrcs();
+	}
+
+	// Runs a command line encoded by makeScript() as if it was received, without parsing it. Returns false,
+	// doing nothing, while another line is being received or executed
+	template<std::size_t size>
+	bool execScript(const Script<Settings, size>& script)
+	{
+		if (m_state != &Server::stateA)
+		{
+			return false;
+		}
+		Base::loadCmdline(script.data.data(), size);
+		startCmdExec();
+		return true;
+	}
+
+	// Runs a binary frame composed by FrameEncoder: extended command ids, each followed by the parameter block
+	// of a write in the layout of the command line buffer. The character state machine is skipped, only the ids
+	// and the values are checked. The commands before an invalid one are run and the line ends with ERROR, as
+	// for a received line. Returns false, doing nothing, while another line is being received or executed
+	bool execFrame(std::span<const uint8_t> frame)
+	{
+		if (m_state != &Server::stateA)
+		{
+			return false;
+		}
+		startCmdExec(!Base::loadFrame(frame.data(), frame.size()));
+		return true;
+	}
+
+	// Macro slots keep encoded command lines for replay without parsing. The last received line, a script
+	// or a slot of another server with the same settings can be stored; storing fails unless the server is idle
+	bool storeMacro(std::size_t slot) requires concepts::MacroSettings<Settings>
+	{
+		return (m_state == &Server::stateA) && Base::storeReceivedLine(slot);
+	}
+
+	template<std::size_t size>
+	bool storeMacro(std::size_t slot, const Script<Settings, size>& script) requires concepts::MacroSettings<Settings>
+	{
+		static_assert(size <= Settings::macro_max_size, "The script does not fit in a macro slot");
+		return Base::storeMacro(slot, script.data.data(), size);
+	}
+
+	bool storeMacro(std::size_t slot, const Server& source, std::size_t source_slot) requires concepts::MacroSettings<Settings>
+	{
+		if (!source.isMacroStored(source_slot))
+		{
+			return false;
+		}
+		std::span<const uint8_t> macro = source.getMacro(source_slot);
+		return Base::storeMacro(slot, macro.data(), macro.size());
+	}
+
+	// Runs a stored macro like execScript()
+	bool execMacro(std::size_t slot) requires concepts::MacroSettings<Settings>
+	{
+		if ((m_state != &Server::stateA) || !Base::loadMacro(slot))
+		{
+			return false;
+		}
+		startCmdExec();
+		return true;
+	}
+
+	using Base::clearMacro;
+	using Base::isMacroStored;
+
+	// Queues a pre-formatted unsolicited result code. It is printed right away when the channel is idle,
+	// otherwise after the line or between the responses of an asynchronous command, never inside a response.
+	// Higher priorities are printed first; a coalescing URC replaces the queued one of the same type, e.g.
+	// only the latest "+CSQ:" is kept. Returns false if the URC was dropped. Must be called on the server thread
+	bool postUrc(std::string_view text, uint8_t priority = 0, bool coalesce = false) requires concepts::UrcSettings<Settings>
+	{
+		bool r = Base::m_urcs.push(text, priority, coalesce);
+		if (m_state == &Server::stateA)
+		{
+			Base::printUrcs();
+		}
+		return r;
+	}
+
+	// URCs lost because the queue was full or they were too long
+	uint32_t getDroppedUrcCount() const requires concepts::UrcSettings<Settings>
+	{
+		return Base::m_urcs.getDropped();
+	}
+
+	using Base::setExecutor;
+	using Base::setWakeCallback;
+
+	// True while an offloadable handler runs on the executor, processCompletions() resumes the line
+	using Base::isOffloaded;
+
+	using Base::invalidateResponseCache;
+
+	// Drops the cached responses of a single command
+	template<concepts::ExtendedCommand Cmd>
+	void invalidateResponseCache()
+	{
+		if constexpr (Settings::ExtendedCommands::size != 0)
+		{
+			Base::invalidateCmdResponseCache(Settings::ExtendedCommands::template getCommandPosition<Cmd>());
 		}
 	}
 
@@ -147,6 +359,24 @@ private:
 	using Base::m_basic_cmd_index;
 	using Base::m_param_index;
 
+	template<concepts::BasicCommand Cmd>
+	static consteval uint16_t getBasicCmdId()
+	{
+		return Base::getBasicCmdOffset() + 1 + Settings::BasicCommands::template getCommandPosition<Cmd>();
+	}
+
+	template<concepts::AmpersandCommand Cmd>
+	static consteval uint16_t getAmpersandCmdId()
+	{
+		return Base::getAmpersandCmdOffset() + Settings::AmpersandCommands::template getCommandPosition<Cmd>();
+	}
+
+	template<concepts::ExtendedCommand Cmd>
+	static consteval uint16_t getExtCmdId(CMD_TYPE cmd_type)
+	{
+		return Base::getExtCmdId(Settings::ExtendedCommands::template getCommandPosition<Cmd>(), cmd_type);
+	}
+
 	// State machine states
 	using State = void (Server::*)(char, bool);
 
@@ -178,7 +408,9 @@ private:
 			m_state = &Server::stateBody;
 			break;
 		case '/':
-			startCmdExec();
+			m_state = &Server::stateExecuting;
+			Base::startRepeatedCmdExec();
+			continueCmdExec();
 			break;
 		default:
 			m_state = &Server::stateA;
@@ -376,6 +608,7 @@ private:
 			if (cmd.numeric_ranges == nullptr)
 			{
 				// This command does not support numeric parameters
+				finalizeBasicCmd();
 				m_state = &Server::stateBody;
 			}
 			else
@@ -424,7 +657,6 @@ private:
 			{
 				finalizeBasicCmd();
 				m_state = &Server::stateBody;
-				stateBody(ch);
 			}
 			else
 			{
@@ -791,6 +1023,15 @@ private:
 		{
 			const detail::ExtCmdDef& cmd_def = getCmdDef();
 			const detail::ExtCmdParamDef& param_def = cmd_def.getParameters()->parameters[m_param_index];
+			if constexpr (Base::has_streamed_commands)
+			{
+				if (param_def.is_streamed)
+				{
+					Base::startStream(param_def);
+					m_state = &Server::stateExtendedParamStreamedString;
+					return;
+				}
+			}
 			m_param_string_size = param_def.string_max_len;
 			m_state = &Server::stateExtendedParamString;
 		}
@@ -812,12 +1053,68 @@ private:
 		{
 			const detail::ExtCmdDef& cmd_def = getCmdDef();
 			const detail::ExtCmdParamDef& param_def = cmd_def.getParameters()->parameters[m_param_index];
-			m_param_hex_string.size = param_def.hexstring_max_size;
 			m_param_hex_string.second = false;
+			if constexpr (Base::has_streamed_commands)
+			{
+				if (param_def.is_streamed)
+				{
+					Base::startStream(param_def);
+					m_state = &Server::stateExtendedParamStreamedHexString;
+					return;
+				}
+			}
+			m_param_hex_string.size = param_def.hexstring_max_size;
 			m_state = &Server::stateExtendedParamHexString;
 		}
 	}
 
+	void stateExtendedParamEnumStart(char ch, bool /*abortable*/)
+	{
+		if (processDefaultParameter(ch, &Server::addDefaultEnumParameter))
+		{
+			return;
+		}
+
+		if (ch != '"')
+		{
+			// Unknown symbol
+			m_state = &Server::stateError;
+		}
+		else
+		{
+			// The position in the trie of the keywords
+			m_param_value_num = 0;
+			m_state = &Server::stateExtendedParamEnum;
+		}
+	}
+
+	// The keyword is matched as it is received, the characters are already in upper case
+	void stateExtendedParamEnum(char ch, bool /*abortable*/)
+	{
+		const detail::ExtCmdDef& cmd_def = getCmdDef();
+		const uint8_t* trie = cmd_def.getParameters()->parameters[m_param_index].enumeration->trie;
+		if (ch == '"')
+		{
+			// The end of string
+			if (!atcmd::detail::TrieWalker::isLeaf(trie, m_param_value_num))
+			{
+				// Empty or only a part of a keyword
+				m_state = &Server::stateError;
+			}
+			else
+			{
+				m_param_value_num = atcmd::detail::TrieWalker::getCommandIndex(trie, m_param_value_num);
+				Base::addEnumParameter();
+				m_state = &Server::stateExtendedParamStringEnd;
+			}
+		}
+		else if (!atcmd::detail::TrieWalker::feed(trie, m_param_value_num, ch))
+		{
+			// Not a keyword
+			m_state = &Server::stateError;
+		}
+	}
+
 	void stateExtendedParamString(char ch, bool /*abortable*/)
 	{
 		if (ch == '"')
@@ -891,6 +1188,73 @@ private:
 		m_param_hex_string.second = !m_param_hex_string.second;
 	}
 
+	// A streamed string is passed to the handler in chunks instead of being kept in the command line
+	void stateExtendedParamStreamedString(char ch, bool /*abortable*/)
+	{
+		if constexpr (Base::has_streamed_commands)
+		{
+			if (ch == '"')
+			{
+				// The end of string
+				Base::finalizeStream();
+				m_state = &Server::stateExtendedParamStringEnd;
+			}
+			else if (!Base::addStreamByte(static_cast<uint8_t>(ch)))
+			{
+				// String size exceeded
+				m_state = &Server::stateError;
+			}
+		}
+	}
+
+	void stateExtendedParamStreamedHexString(char ch, bool /*abortable*/)
+	{
+		if constexpr (Base::has_streamed_commands)
+		{
+			if ((ch == ' ') || (ch == '-'))
+			{
+				// Space and '-' may be used for formatting
+				return;
+			}
+			if (ch == '"')
+			{
+				// The end of string
+				if (m_param_hex_string.second)
+				{
+					// Uneven number of bytes
+					m_state = &Server::stateError;
+				}
+				else
+				{
+					Base::finalizeStream();
+					m_state = &Server::stateExtendedParamStringEnd;
+				}
+				return;
+			}
+
+			int_fast8_t hex = atcmd::detail::Characters::getHex(ch);
+			if (hex < 0)
+			{
+				// Invalid character
+				m_state = &Server::stateError;
+				stateError(ch);
+				return;
+			}
+
+			if (!m_param_hex_string.second)
+			{
+				m_param_hex_string.byte = static_cast<uint8_t>(hex) << 4;
+			}
+			else if (!Base::addStreamByte(m_param_hex_string.byte | static_cast<uint8_t>(hex)))
+			{
+				// Size exceeded
+				m_state = &Server::stateError;
+				return;
+			}
+			m_param_hex_string.second = !m_param_hex_string.second;
+		}
+	}
+
 	void stateExtendedParamStringEnd(char ch, bool /*abortable*/)
 	{
 		const detail::ExtCmdDef& cmd_def = getCmdDef();
@@ -942,6 +1306,7 @@ private:
 		(void)abortable;
 		if (ch == getCommunicationParameters().getCmdLineTerminationChar())
 		{
+			Base::abortStream();
 			startCmdExec(true);
 		}
 	}
@@ -991,6 +1356,9 @@ private:
 			case detail::ExtCmdParamDef::TYPE::STR_HEX:
 				m_state = &Server::stateExtendedParamHexStringStart;
 				break;
+			case detail::ExtCmdParamDef::TYPE::ENUM:
+				m_state = &Server::stateExtendedParamEnumStart;
+				break;
 			default:
 				break;
 			}
@@ -1078,6 +1446,66 @@ private:
 		return true;
 	}
 
+	void feedChar(char ch, bool abortable)
+	{
+		if constexpr (Base::has_data_mode_commands)
+		{
+			if (Base::isDataMode())
+			{
+				// The payload is neither echoed nor parsed
+				feedData(&ch, 1);
+				return;
+			}
+		}
+
+		if (getCommunicationParameters().isEchoEnabled())
+		{
+			Base::printChar(ch);
+		}
+
+		if constexpr (Settings::ExtendedCommands::size != 0)
+		{
+			if ((m_state != &Server::stateExtendedParamString) && (m_state != &Server::stateExtendedParamStreamedString))
+			{
+				ch = atcmd::detail::Characters::toUpper(ch);
+			}
+		}
+		else
+		{
+			ch = atcmd::detail::Characters::toUpper(ch);
+		}
+		(this->*m_state)(ch, abortable);
+
+		if constexpr (concepts::InterCharacterTimeoutSettings<Settings>)
+		{
+			if (m_state == &Server::stateA)
+			{
+				Base::cancelTimer();
+			}
+			else if (m_state != &Server::stateExecuting)
+			{
+				Base::armTimer(Settings::inter_character_timeout);
+			}
+		}
+		flushUrcs();
+	}
+
+	static void onTimerExpired(void* context)
+	{
+		Server* self = static_cast<Server*>(context);
+		if (self->m_state == &Server::stateExecuting)
+		{
+			self->timeoutCmdExec();
+		}
+		else
+		{
+			self->abortStream();
+		}
+		// A half-received line is dropped
+		self->m_state = &Server::stateA;
+		self->flushUrcs();
+	}
+
 	void startCmdExec(bool error = false)
 	{
 		m_state = &Server::stateExecuting;
@@ -1091,6 +1519,18 @@ private:
 		{
 			m_state = &Server::stateA;
 		}
+		flushUrcs();
+	}
+
+	std::size_t feedData(const char* data, std::size_t size)
+	{
+		std::size_t r = Base::feedData(data, size);
+		if (!Base::isDataMode())
+		{
+			// End of the payload
+			continueCmdExec();
+		}
+		return r;
 	}
 
 	void continueCmdExec(uint16_t cmd_id)
@@ -1103,11 +1543,31 @@ private:
 		{
 			m_state = &Server::stateA;
 		}
+		flushUrcs();
+	}
+
+	// Between lines, or while an asynchronous command waits for its next response
+	void flushUrcs()
+	{
+		if constexpr (concepts::UrcSettings<Settings>)
+		{
+			if ((m_state == &Server::stateA) ||
+				((m_state == &Server::stateExecuting) && !Base::isOffloaded() && !Base::isDataMode()))
+			{
+				Base::printUrcs();
+			}
+		}
 	}
 
 	State m_state;
 };
 
+// A server object keeps only the state of a single channel: the parser position, the command line buffer,
+// the S-parameters and the asynchronous execution bookkeeping. The command tables, the trie and the dispatch
+// code are static and shared by all the sessions built from the same Settings
+template<concepts::ServerSettings Settings>
+using Session = Server<Settings>;
+
 } /* namespace atcmdlib::server */
 
 #endif // ATCMD_SERVER_H
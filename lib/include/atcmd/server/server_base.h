@@ -25,7 +25,10 @@
 #ifndef ATCMD_SERVER_BASE_H
 #define ATCMD_SERVER_BASE_H
 
+#include <string_view>
+
 #include <atcmd/common.h>
+#include <atcmd/detail/responsecache.h>
 #include <atcmd/server/basiccommand.h>
 #include <atcmd/server/extendedcommand.h>
 #include <atcmd/server/sparameters.h>
@@ -46,6 +49,7 @@ public:
 	SParameters& getCommunicationParameters();
 
 	void printChar(char ch);
+	void printBuffer(const char* data, std::size_t size);
 	void printText(const char* text);
 	void printNumber(uint32_t number, uint8_t base);
 	void printString(const char* string);
@@ -63,30 +67,51 @@ public:
 	PrintCharCallback getPrintCharCallback();
 	void setPrintCharCallback(PrintCharCallback print_char_callback);
 
+	PrintTextCallback getPrintTextCallback();
+	void setPrintTextCallback(PrintTextCallback print_text_callback);
+
 	void setContext(void* context);
 	void* getContext();
 
+	// Drops all the cached responses of this server, e.g. when a handler changes the session data they were built from
+	void invalidateResponseCache();
+
+	// Drops the cached responses of every server, for data shared by the sessions
+	static void invalidateAllResponseCaches();
+
 protected:
 	Server(PrintCharCallback print_char_callback, void* context);
 
+	void setOutputRecorder(OutputRecorder* recorder);
+	uint32_t getResponseCacheGeneration() const;
+
 	BasicCommandBase::BasicServerHandle getBasicHandle(
 			const uint8_t* param_start,
 			bool is_last_command,
-			CommandBase::ServerHandle::CALL_TYPE call_type);
+			CommandBase::ServerHandle::CALL_TYPE call_type,
+			void* async_state);
 
 	ExtendedCommandBase::ReadServerHandle getReadHandle(
 			bool is_last_command,
-			ExtendedCommandBase::ReadServerHandle::CALL_TYPE call_type);
+			ExtendedCommandBase::ReadServerHandle::CALL_TYPE call_type,
+			void* async_state);
 	ExtendedCommandBase::WriteServerHandle getWriteHandle(
 			const uint8_t* param_start,
 			bool is_last_command,
-			CommandBase::ServerHandle::CALL_TYPE call_type);
+			CommandBase::ServerHandle::CALL_TYPE call_type,
+			void* async_state);
 	ExtendedCommandBase::TestServerHandle getTestHandle(bool is_last_command);
 
 private:
+	void printBuffer(std::string_view text);
+
 	PrintCharCallback m_print_char_callback;
+	PrintTextCallback m_print_text_callback;
 	void* m_context;
 
+	OutputRecorder* m_recorder;
+	uint32_t m_response_cache_generation;
+
 	SParameters m_s_parameters;
 };
 
@@ -25,6 +25,8 @@
 #ifndef ATCMD_SPARAMETERS_H
 #define ATCMD_SPARAMETERS_H
 
+#include <atcmd/detail/responseframing.h>
+
 namespace atcmd::server {
 
 struct SParameters
@@ -43,13 +45,21 @@ struct SParameters
 	bool isEchoEnabled() const;
 	void setEchoEnabled(bool enabled);
 
+	const detail::ResponseFraming& getResponseFraming() const;
+
 private:
+	void composeResponseFraming();
+
 	char m_s3;
 	char m_s4;
 
 	bool m_verbose;
 
 	bool m_echo_enabled;
+
+	// Line break and verbose mode, updated when S3, S4 or V change. The result codes for the default S3 and S4
+	// are shared constant data, the others are composed on every print
+	detail::ResponseFraming m_response_framing;
 };
 
 }
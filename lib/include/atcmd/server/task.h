@@ -0,0 +1,213 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_TASK_H
+#define ATCMD_TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include <atcmd/common.h>
+#include <atcmd/detail/coroutineframes.h>
+#include <atcmd/server/command_base.h>
+
+namespace atcmd::server {
+
+class Task;
+
+namespace detail {
+
+template<class Handle, Task (*handler)(Handle)>
+atcmd::RESULT_CODE runTask(Handle server_handle);
+
+} /* namespace detail */
+
+// Return type of coroutine command handlers. The handler runs until it awaits nextResponse(), the server
+// then keeps it suspended and resumes it on every response call, like an ASYNC state machine would be called.
+// The frame is taken from the server (Settings::coroutine_frame_size), never from the heap
+class Task
+{
+public:
+	struct promise_type
+	{
+		// Not a template, GCC does not pair a templated allocation function with the deallocation functions
+		static void* operator new(std::size_t size, detail::CommandBase::ServerHandle& server_handle) noexcept
+		{
+			return server_handle.getCoroutineFramePool()->allocate(size);
+		}
+
+		static void operator delete(void* frame) noexcept
+		{
+			detail::CoroutineFramePool::deallocate(frame);
+		}
+
+		// Matches the allocation function
+		static void operator delete(void* frame, detail::CommandBase::ServerHandle& /*server_handle*/) noexcept
+		{
+			detail::CoroutineFramePool::deallocate(frame);
+		}
+
+		// The command fails with ERROR
+		static Task get_return_object_on_allocation_failure() noexcept
+		{
+			return Task(nullptr);
+		}
+
+		Task get_return_object() noexcept
+		{
+			return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		std::suspend_never initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		std::suspend_always final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void return_value(atcmd::RESULT_CODE result_code) noexcept
+		{
+			m_result_code = result_code;
+		}
+
+		void unhandled_exception() noexcept
+		{
+			std::terminate();
+		}
+
+		atcmd::RESULT_CODE m_result_code = atcmd::RESULT_CODE::ERROR;
+		bool m_is_cancelled = false;
+	};
+
+	// Resumes with true on the next response call and with false when the command is aborted
+	struct Response
+	{
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept
+		{
+			m_promise = &coroutine.promise();
+		}
+
+		bool await_resume() const noexcept
+		{
+			return !m_promise->m_is_cancelled;
+		}
+
+		promise_type* m_promise = nullptr;
+	};
+
+	static Response nextResponse()
+	{
+		return {};
+	}
+
+	Task(Task&& other) noexcept :
+		m_coroutine{std::exchange(other.m_coroutine, nullptr)}
+	{}
+
+	Task& operator=(Task&&) = delete;
+
+	~Task()
+	{
+		if (m_coroutine)
+		{
+			m_coroutine.destroy();
+		}
+	}
+
+private:
+	template<class Handle, Task (*handler)(Handle)>
+	friend atcmd::RESULT_CODE detail::runTask(Handle server_handle);
+
+	explicit Task(std::coroutine_handle<promise_type> coroutine) :
+		m_coroutine{coroutine}
+	{}
+
+	std::coroutine_handle<promise_type> m_coroutine;
+};
+
+namespace detail {
+
+// Adapts a coroutine handler to the plain handler signature: starts it on the request, resumes it on
+// responses and cancels it on abort. The suspended coroutine is kept by the frame pool of the server
+template<class Handle, Task (*handler)(Handle)>
+atcmd::RESULT_CODE runTask(Handle server_handle)
+{
+	using CALL_TYPE = typename Handle::CALL_TYPE;
+	using Coroutine = std::coroutine_handle<Task::promise_type>;
+
+	CoroutineFramePool* frames = server_handle.getCoroutineFramePool();
+	Coroutine coroutine;
+	if (server_handle.getCallType() == CALL_TYPE::REQUEST)
+	{
+		if (frames->getSuspended())
+		{
+			// Left suspended by a command that timed out and ignored the cancellation
+			frames->getSuspended().destroy();
+			frames->setSuspended(nullptr);
+		}
+		Task task = handler(server_handle);
+		coroutine = std::exchange(task.m_coroutine, nullptr);
+		if (!coroutine)
+		{
+			// The frame does not fit
+			return atcmd::RESULT_CODE::ERROR;
+		}
+	}
+	else
+	{
+		if (!frames->getSuspended())
+		{
+			return atcmd::RESULT_CODE::ERROR;
+		}
+		coroutine = Coroutine::from_address(frames->getSuspended().address());
+		frames->setSuspended(nullptr);
+		coroutine.promise().m_is_cancelled = server_handle.getCallType() == CALL_TYPE::ABORT;
+		coroutine.resume();
+	}
+
+	if (!coroutine.done())
+	{
+		frames->setSuspended(coroutine);
+		return atcmd::RESULT_CODE::ASYNC;
+	}
+
+	atcmd::RESULT_CODE result_code = coroutine.promise().m_result_code;
+	coroutine.destroy();
+	return result_code;
+}
+
+} /* namespace detail */
+
+} /* namespace atcmd::server */
+
+#endif // ATCMD_TASK_H
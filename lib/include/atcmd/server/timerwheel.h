@@ -0,0 +1,81 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_TIMERWHEEL_H
+#define ATCMD_TIMERWHEEL_H
+
+#include <cstdint>
+
+namespace atcmd::server {
+
+// Hierarchical timer wheel driving the command and inter-character timeouts of any number of servers.
+// Timers are embedded in the servers, arming and cancelling is O(1) and nothing is allocated.
+// The application calls tick() from its clock on the thread that feeds the servers
+class TimerWheel
+{
+public:
+	struct Timer
+	{
+		Timer* next = nullptr;
+		Timer** pprev = nullptr;
+		uint32_t expiry = 0;
+		void (*callback)(void* context) = nullptr;
+		void* context = nullptr;
+
+		bool isArmed() const
+		{
+			return pprev != nullptr;
+		}
+	};
+
+	TimerWheel();
+
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel& operator=(const TimerWheel&) = delete;
+
+	// Expires after the given number of ticks, at least one. Longer delays are limited to max_ticks
+	void arm(Timer& timer, uint32_t ticks);
+	static void cancel(Timer& timer);
+
+	// Advances the time, the callbacks of the expired timers are called from here
+	void tick(uint32_t ticks = 1);
+
+	uint32_t getTime() const;
+
+	static constexpr uint8_t level_bits = 6;
+	static constexpr uint8_t level_count = 4;
+	static constexpr uint32_t slot_count = 1u << level_bits;
+	static constexpr uint32_t max_ticks = (1u << (level_bits * level_count)) - 1;
+
+private:
+	void insert(Timer& timer);
+	void cascade(uint8_t level);
+
+	Timer* m_slots[level_count][slot_count];
+	uint32_t m_time;
+};
+
+} /* namespace atcmd::server */
+
+#endif // ATCMD_TIMERWHEEL_H
@@ -26,8 +26,6 @@
 
 namespace atcmd::detail {
 
-static constexpr char numbers[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
-
 char Characters::toUpper(char ch)
 {
 	if ((ch >= 'a') && (ch <= 'z'))
@@ -39,23 +37,12 @@ char Characters::toUpper(char ch)
 
 void Characters::printNumber(uint32_t number, uint8_t base, PrintCharCallback callback, void* context)
 {
-	assert(base <= (sizeof(numbers)));
-
-	uint_fast8_t digit_count = 0;
-	uint64_t number_reversed = 0;
-	do
+	char buf[max_number_size];
+	uint_fast8_t size = formatNumber(number, base, buf);
+	for (uint_fast8_t i = 0; i < size; i++)
 	{
-		number_reversed *= base;
-		number_reversed += number % base;
-		number /= base;
-		digit_count++;
-	} while (number != 0);
-
-	do
-	{
-		callback(numbers[number_reversed % base], context);
-		number_reversed /= base;
-	} while (--digit_count != 0);
+		callback(buf[i], context);
+	}
 }
 
 void Characters::printHexadecimalString(const uint8_t* data, uint16_t size, PrintCharCallback callback, void* context)
@@ -63,8 +50,8 @@ void Characters::printHexadecimalString(const uint8_t* data, uint16_t size, Prin
 	for (uint_fast16_t i = 0; i < size; i++)
 	{
 		uint8_t v = data[i];
-		callback(numbers[v >> 4], context);
-		callback(numbers[v & 0xF], context);
+		callback(digits[v >> 4], context);
+		callback(digits[v & 0xF], context);
 	}
 }
 
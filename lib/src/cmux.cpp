@@ -0,0 +1,224 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <array>
+
+#include <atcmd/cmux.h>
+
+namespace atcmd::detail {
+
+namespace {
+
+consteval std::array<uint8_t, 256> makeCrcTable()
+{
+	std::array<uint8_t, 256> table = {};
+	for (unsigned i = 0; i < 256; i++)
+	{
+		uint8_t crc = static_cast<uint8_t>(i);
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 1) ? static_cast<uint8_t>((crc >> 1) ^ 0xE0) : static_cast<uint8_t>(crc >> 1);
+		}
+		table[i] = crc;
+	}
+	return table;
+}
+
+constexpr std::array<uint8_t, 256> crc_table = makeCrcTable();
+
+} /* namespace */
+
+uint8_t CmuxCodec::updateCrc(uint8_t crc, const uint8_t* data, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; i++)
+	{
+		crc = crc_table[crc ^ data[i]];
+	}
+	return crc;
+}
+
+std::size_t CmuxCodec::encode(uint8_t* dest, uint8_t address, uint8_t control, const uint8_t* info, std::size_t size)
+{
+	uint8_t* p = dest;
+	*p++ = flag;
+	*p++ = address;
+	*p++ = control;
+	if (size <= 0x7F)
+	{
+		*p++ = static_cast<uint8_t>((size << 1) | ea);
+	}
+	else
+	{
+		*p++ = static_cast<uint8_t>(size << 1);
+		*p++ = static_cast<uint8_t>(size >> 7);
+	}
+	uint8_t crc = updateCrc(0xFF, dest + 1, static_cast<std::size_t>(p - dest - 1));
+	if (size != 0)
+	{
+		std::memcpy(p, info, size);
+	}
+	// The FCS of UIH frames leaves the information field out
+	if ((control & ~pf) == ui)
+	{
+		crc = updateCrc(crc, p, size);
+	}
+	p += size;
+	*p++ = static_cast<uint8_t>(0xFF - crc);
+	*p++ = flag;
+	return static_cast<std::size_t>(p - dest);
+}
+
+CmuxDecoder::CmuxDecoder(uint8_t* buffer, uint16_t capacity) :
+	m_buffer{buffer},
+	m_capacity{capacity},
+	m_length{0},
+	m_received{0},
+	m_header{},
+	m_header_size{0},
+	m_state{State::HUNT},
+	m_discarded{0}
+{
+}
+
+std::size_t CmuxDecoder::feed(const uint8_t* data, std::size_t size)
+{
+	if (m_state == State::FRAME)
+	{
+		// The closing flag may also open the next frame
+		m_state = State::ADDRESS;
+	}
+	std::size_t i = 0;
+	while (i < size)
+	{
+		if (m_state == State::INFO)
+		{
+			std::size_t chunk = m_length - m_received;
+			if (chunk > size - i)
+			{
+				chunk = size - i;
+			}
+			std::memcpy(&m_buffer[m_received], &data[i], chunk);
+			m_received += static_cast<uint16_t>(chunk);
+			i += chunk;
+			if (m_received == m_length)
+			{
+				m_state = State::FCS;
+			}
+			continue;
+		}
+
+		uint8_t byte = data[i++];
+		switch (m_state)
+		{
+		case State::HUNT:
+			if (byte == CmuxCodec::flag)
+			{
+				m_state = State::ADDRESS;
+			}
+			break;
+		case State::ADDRESS:
+			if (byte == CmuxCodec::flag)
+			{
+				break;
+			}
+			if ((byte & CmuxCodec::ea) == 0)
+			{
+				discard();
+				break;
+			}
+			m_header[0] = byte;
+			m_header_size = 1;
+			m_state = State::CONTROL;
+			break;
+		case State::CONTROL:
+			m_header[m_header_size++] = byte;
+			m_state = State::LENGTH;
+			break;
+		case State::LENGTH:
+			m_header[m_header_size++] = byte;
+			m_length = byte >> 1;
+			if ((byte & CmuxCodec::ea) == 0)
+			{
+				m_state = State::LENGTH_HIGH;
+				break;
+			}
+			startInfo();
+			break;
+		case State::LENGTH_HIGH:
+			m_header[m_header_size++] = byte;
+			m_length |= static_cast<uint16_t>(byte << 7);
+			startInfo();
+			break;
+		case State::FCS:
+		{
+			uint8_t crc = CmuxCodec::updateCrc(0xFF, m_header, m_header_size);
+			if ((m_header[1] & ~CmuxCodec::pf) == CmuxCodec::ui)
+			{
+				crc = CmuxCodec::updateCrc(crc, m_buffer, m_length);
+			}
+			crc = CmuxCodec::updateCrc(crc, &byte, 1);
+			if (crc == CmuxCodec::good_crc)
+			{
+				m_state = State::CLOSING_FLAG;
+			}
+			else
+			{
+				discard();
+			}
+			break;
+		}
+		case State::CLOSING_FLAG:
+			if (byte == CmuxCodec::flag)
+			{
+				m_state = State::FRAME;
+				return i;
+			}
+			discard();
+			break;
+		default:
+			break;
+		}
+	}
+	return i;
+}
+
+void CmuxDecoder::startInfo()
+{
+	if (m_length > m_capacity)
+	{
+		discard();
+		return;
+	}
+	m_received = 0;
+	m_state = m_length == 0 ? State::FCS : State::INFO;
+}
+
+void CmuxDecoder::discard()
+{
+	m_discarded++;
+	m_state = State::HUNT;
+}
+
+} /* namespace atcmd::detail */
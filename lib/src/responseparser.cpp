@@ -0,0 +1,271 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <atcmd/responseparser.h>
+
+#include <cstring>
+
+#include <atcmd/detail/trie.h>
+
+namespace atcmd::detail {
+
+namespace {
+
+bool isLineBreak(char ch)
+{
+	return (ch == '\r') || (ch == '\n');
+}
+
+} /* anonymous namespace */
+
+ResponseTokenizer::ResponseTokenizer(const char* name, const ExtCmdParamDef* params, uint8_t param_count,
+		ResponseField* fields, char* buffer, uint16_t capacity) :
+	m_name{name},
+	m_params{params},
+	m_param_count{param_count},
+	m_fields{fields},
+	m_buffer{buffer},
+	m_capacity{capacity},
+	m_size{0},
+	m_state{State::IDLE},
+	m_has_fields{false},
+	m_line{nullptr},
+	m_line_size{0},
+	m_discarded{0}
+{}
+
+std::size_t ResponseTokenizer::feed(const char* data, std::size_t size)
+{
+	std::size_t i = 0;
+	if (m_state == State::LINE)
+	{
+		m_state = State::IDLE;
+	}
+	if (m_state == State::IDLE)
+	{
+		// Line breaks between the lines
+		while ((i != size) && isLineBreak(data[i]))
+		{
+			i++;
+		}
+		if (i == size)
+		{
+			return size;
+		}
+		std::size_t start = i;
+		while ((i != size) && !isLineBreak(data[i]))
+		{
+			i++;
+		}
+		if (i != size)
+		{
+			// The whole line is in the chunk
+			finishLine(&data[start], i - start);
+			return i + 1;
+		}
+		m_size = 0;
+		m_state = State::PARTIAL;
+		append(&data[start], size - start);
+		return size;
+	}
+
+	while ((i != size) && !isLineBreak(data[i]))
+	{
+		i++;
+	}
+	append(data, i);
+	if (i == size)
+	{
+		return size;
+	}
+	if (m_state == State::OVERFLOW)
+	{
+		m_discarded++;
+		m_state = State::IDLE;
+	}
+	else
+	{
+		finishLine(m_buffer, m_size);
+	}
+	return i + 1;
+}
+
+void ResponseTokenizer::append(const char* data, std::size_t size)
+{
+	if (m_state != State::PARTIAL)
+	{
+		return;
+	}
+	if (size > static_cast<std::size_t>(m_capacity - m_size))
+	{
+		m_state = State::OVERFLOW;
+		return;
+	}
+	std::memcpy(&m_buffer[m_size], data, size);
+	m_size += static_cast<uint16_t>(size);
+}
+
+void ResponseTokenizer::finishLine(const char* line, std::size_t size)
+{
+	m_line = line;
+	m_line_size = size;
+	m_state = State::LINE;
+	m_has_fields = tokenize(line, size);
+}
+
+bool ResponseTokenizer::tokenize(const char* line, std::size_t size)
+{
+	for (uint_fast8_t p = 0; p < m_param_count; p++)
+	{
+		m_fields[p] = {nullptr, 0, false, 0};
+	}
+
+	std::size_t name_size = std::strlen(m_name);
+	if ((size < name_size + 2) || (line[0] != '+') || (std::memcmp(&line[1], m_name, name_size) != 0) ||
+		(line[name_size + 1] != ':'))
+	{
+		return false;
+	}
+	std::size_t i = name_size + 2;
+	if ((i != size) && (line[i] == ' '))
+	{
+		i++;
+	}
+
+	for (uint_fast8_t p = 0; p < m_param_count; p++)
+	{
+		if (p != 0)
+		{
+			if (i == size)
+			{
+				// The rest is not printed
+				break;
+			}
+			if (line[i] != ',')
+			{
+				return false;
+			}
+			i++;
+		}
+
+		ResponseField& field = m_fields[p];
+		const ExtCmdParamDef& param = m_params[p];
+		std::size_t start = i;
+		switch (param.param_type) {
+		case ExtCmdParamDef::TYPE::NUM_DEC:
+		case ExtCmdParamDef::TYPE::NUM_HEX:
+		case ExtCmdParamDef::TYPE::NUM_BIN:
+		{
+			uint32_t base = param.param_type == ExtCmdParamDef::TYPE::NUM_DEC ? 10 :
+					(param.param_type == ExtCmdParamDef::TYPE::NUM_HEX ? 16 : 2);
+			uint32_t value = 0;
+			for (; (i != size) && (line[i] != ','); i++)
+			{
+				int_fast8_t digit = atcmd::detail::Characters::getHex(line[i]);
+				if ((digit < 0) || (static_cast<uint32_t>(digit) >= base) || (value > (UINT32_MAX - digit) / base))
+				{
+					return false;
+				}
+				value = value * base + digit;
+			}
+			field.number = value;
+			break;
+		}
+		case ExtCmdParamDef::TYPE::STR:
+		case ExtCmdParamDef::TYPE::STR_HEX:
+		case ExtCmdParamDef::TYPE::ENUM:
+		{
+			if ((i == size) || (line[i] == ','))
+			{
+				// Empty field
+				break;
+			}
+			if (line[i] != '"')
+			{
+				return false;
+			}
+			const char* end = static_cast<const char*>(std::memchr(&line[i + 1], '"', size - i - 1));
+			if (end == nullptr)
+			{
+				return false;
+			}
+			start = i + 1;
+			i = end - line;
+			// The length of a streamed string is not bounded
+			if (param.param_type == ExtCmdParamDef::TYPE::STR)
+			{
+				if (!param.is_streamed && (i - start >= param.string_max_len))
+				{
+					return false;
+				}
+			}
+			else if (param.param_type == ExtCmdParamDef::TYPE::ENUM)
+			{
+				// The keyword is decoded into its index
+				const uint8_t* trie = param.enumeration->trie;
+				uint32_t pos = 0;
+				for (std::size_t j = start; j != i; j++)
+				{
+					if (!atcmd::detail::TrieWalker::feed(trie, pos, line[j]))
+					{
+						return false;
+					}
+				}
+				if (!atcmd::detail::TrieWalker::isLeaf(trie, pos))
+				{
+					return false;
+				}
+				field.number = atcmd::detail::TrieWalker::getCommandIndex(trie, pos);
+			}
+			else
+			{
+				if (((i - start) % 2 != 0) || (!param.is_streamed && (i - start > 2u * param.hexstring_max_size)))
+				{
+					return false;
+				}
+				for (std::size_t j = start; j != i; j++)
+				{
+					if (atcmd::detail::Characters::getHex(line[j]) < 0)
+					{
+						return false;
+					}
+				}
+			}
+			field.data = &line[start];
+			field.size = static_cast<uint16_t>(i - start);
+			field.is_present = true;
+			// The closing quote
+			i++;
+			continue;
+		}
+		}
+		field.data = &line[start];
+		field.size = static_cast<uint16_t>(i - start);
+		field.is_present = field.size != 0;
+	}
+	return i == size;
+}
+
+} /* namespace atcmd::detail */
@@ -42,10 +42,21 @@ void* CommandBase::ServerHandle::getContext()
 	return m_server.getContext();
 }
 
-Command::ServerHandle::ServerHandle(Server& server, bool is_last_command, CALL_TYPE call_type) :
+CoroutineFramePool* CommandBase::ServerHandle::getCoroutineFramePool()
+{
+	return static_cast<CoroutineFramePool*>(m_async_state);
+}
+
+void* CommandBase::ServerHandle::getAsyncStateStorage()
+{
+	return m_async_state;
+}
+
+Command::ServerHandle::ServerHandle(Server& server, bool is_last_command, CALL_TYPE call_type, void* async_state) :
 	m_server{server},
 	m_is_last_command{is_last_command},
-	m_call_type{call_type}
+	m_call_type{call_type},
+	m_async_state{async_state}
 {}
 
 CommandBase::ServerHandle::InformationText CommandBase::ServerHandle::makeInformationText()
@@ -53,10 +64,15 @@ CommandBase::ServerHandle::InformationText CommandBase::ServerHandle::makeInform
 	return InformationText(m_server, false);
 }
 
-Command::ServerHandle::InformationText::InformationText(Server& server, bool is_result_code) :
+Command::ServerHandle::InformationText::InformationText(Server& server, bool is_result_code, bool is_suppressed) :
 	m_server{server},
-	m_is_result_code{is_result_code}
+	m_is_result_code{is_result_code},
+	m_is_suppressed{is_suppressed}
 {
+	if (m_is_suppressed)
+	{
+		return;
+	}
 	if (m_is_result_code)
 	{
 		m_server.printResultCodeHeader();
@@ -69,6 +85,10 @@ Command::ServerHandle::InformationText::InformationText(Server& server, bool is_
 
 Command::ServerHandle::InformationText::~InformationText()
 {
+	if (m_is_suppressed)
+	{
+		return;
+	}
 	if (m_is_result_code)
 	{
 		m_server.printResultCodeTrailer();
@@ -81,6 +101,10 @@ Command::ServerHandle::InformationText::~InformationText()
 
 void Command::ServerHandle::InformationText::printText(const char* text) &&
 {
+	if (m_is_suppressed)
+	{
+		return;
+	}
 	m_server.printText(text);
 }
 
@@ -0,0 +1,71 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <atcmd/detail/coroutineframes.h>
+
+namespace atcmd::server::detail {
+
+CoroutineFramePool::CoroutineFramePool(std::byte* storage, std::size_t block_size) :
+	m_storage{storage},
+	m_block_size{block_size},
+	m_is_used{false},
+	m_suspended{}
+{}
+
+CoroutineFramePool::~CoroutineFramePool()
+{
+	if (m_suspended)
+	{
+		m_suspended.destroy();
+	}
+}
+
+void* CoroutineFramePool::allocate(std::size_t size)
+{
+	if (m_is_used || (size > m_block_size - header_size))
+	{
+		return nullptr;
+	}
+	m_is_used = true;
+	*reinterpret_cast<CoroutineFramePool**>(m_storage) = this;
+	return m_storage + header_size;
+}
+
+void CoroutineFramePool::deallocate(void* frame)
+{
+	std::byte* block = static_cast<std::byte*>(frame) - header_size;
+	(*reinterpret_cast<CoroutineFramePool**>(block))->m_is_used = false;
+}
+
+std::coroutine_handle<> CoroutineFramePool::getSuspended() const
+{
+	return m_suspended;
+}
+
+void CoroutineFramePool::setSuspended(std::coroutine_handle<> coroutine)
+{
+	m_suspended = coroutine;
+}
+
+} /* namespace atcmd::server::detail */
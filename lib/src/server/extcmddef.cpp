@@ -24,8 +24,40 @@
 
 #include <atcmd/detail/extcmddef.h>
 
+#include <cstring>
+
 namespace atcmd::server::detail {
 
+bool ExtCmdParamDef::validate(const uint8_t* block) const
+{
+	if (is_streamed)
+	{
+		// The payload is passed to the handler while a line is parsed, a frame has none
+		return false;
+	}
+
+	switch (param_type) {
+	case TYPE::NUM_DEC:
+	case TYPE::NUM_HEX:
+	case TYPE::NUM_BIN:
+	{
+		uint32_t value = 0;
+		for (std::size_t i = 0; i < sizeof(value); i++)
+		{
+			value |= static_cast<uint32_t>(block[i]) << (8 * i);
+		}
+		return validateNumericRanges(*numeric_ranges, value);
+	}
+	case TYPE::STR:
+		return std::memchr(block, '\0', string_max_len) != nullptr;
+	case TYPE::STR_HEX:
+		return (block[hexstring_max_size] | (block[hexstring_max_size + 1] << 8)) <= hexstring_max_size;
+	case TYPE::ENUM:
+		return block[0] < enumeration->count;
+	}
+	return false;
+}
+
 ExtendedCommandBase::ReadMethod ExtCmdDef::getReadMethod() const
 {
 	if (!m_flags.readable)
@@ -68,4 +100,25 @@ ExtendedCommandBase::TestMethod ExtCmdDef::getTestMethod() const
 	return m_methods.methods[2 - !m_flags.readable - !m_flags.writable].test;
 }
 
+const ExtCmdDef::DataMode* ExtCmdDef::getDataMode() const
+{
+	if (!m_flags.data_mode)
+	{
+		return nullptr;
+	}
+
+	// A data mode command is writable, so it always has a method array
+	return m_methods.methods[m_flags.readable + m_flags.writable + m_flags.custom_testable].data_mode;
+}
+
+ExtendedCommandBase::DataMethod ExtCmdDef::getDataMethod() const
+{
+	if (!m_flags.data_mode && !m_flags.streamed)
+	{
+		return nullptr;
+	}
+
+	return m_methods.methods[m_flags.readable + m_flags.writable + m_flags.custom_testable].data_mode->data;
+}
+
 } /* atcmd::server::detail */
@@ -29,79 +29,81 @@
 
 namespace atcmd::server::detail {
 
-static void emptyCharCb(char /*ch*/, void* /*context*/)
+ExtendedCommandBase::TestServerHandle::ExtendedInformationText::ExtendedInformationText(Server& server, bool is_result_code, const char* name, bool is_suppressed) :
+	InformationText(server, is_result_code, is_suppressed)
 {
-}
-
-ExtendedCommandBase::TestServerHandle::ExtendedInformationText::ExtendedInformationText(Server& server, bool is_result_code, const char* name, bool is_silent) :
-	InformationText(server, is_result_code),
-	m_print_char_callback{m_server.getPrintCharCallback()}
-{
-	if (is_silent)
+	if (!m_is_suppressed)
 	{
-		m_server.setPrintCharCallback(emptyCharCb);
+		m_server.printExtendedInformationTextHeader(name);
 	}
-	m_server.printExtendedInformationTextHeader(name);
-}
-
-ExtendedCommandBase::TestServerHandle::ExtendedInformationText::~ExtendedInformationText()
-{
-	m_server.setPrintCharCallback(m_print_char_callback);
 }
 
-ExtendedCommandBase::TestServerHandle::TestServerHandle(Server& server, bool is_last_command, CALL_TYPE call_type) :
-	ServerHandle(server, is_last_command, call_type)
+ExtendedCommandBase::TestServerHandle::TestServerHandle(Server& server, bool is_last_command, CALL_TYPE call_type, void* async_state) :
+	ServerHandle(server, is_last_command, call_type, async_state)
 {
 
 }
 
-ExtendedCommandBase::WriteServerHandle::WriteServerHandle(const uint8_t* param_start, Server& server, bool is_last_command, CALL_TYPE call_type) :
-	TestServerHandle(server, is_last_command, call_type),
+ExtendedCommandBase::WriteServerHandle::WriteServerHandle(const uint8_t* param_start, Server& server, bool is_last_command, CALL_TYPE call_type, void* async_state) :
+	TestServerHandle(server, is_last_command, call_type, async_state),
 	ParamServerHandle(param_start)
 {}
 
-ExtendedCommandBase::ReadServerHandle::ParameterInformationText::ParameterInformationText(Server& server, bool is_result_code, const char* name, bool is_silent) :
-	ExtendedInformationText(server, is_result_code, name, is_silent)
+ExtendedCommandBase::ReadServerHandle::ParameterInformationText::ParameterInformationText(Server& server, bool is_result_code, const char* name, bool is_suppressed) :
+	ExtendedInformationText(server, is_result_code, name, is_suppressed)
 {}
 
 ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecond
 ExtendedCommandBase::ReadServerHandle::ParameterInformationText::printNumericParameter(uint32_t value, uint8_t base) &&
 {
 	printNumericParameter_(value, base);
-	return ParameterInformationTextSecond(m_server);
+	return ParameterInformationTextSecond(m_server, m_is_suppressed);
 }
 
 ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecond
 ExtendedCommandBase::ReadServerHandle::ParameterInformationText::printStringParameter(const char* s) &&
 {
 	printStringParameter_(s);
-	return ParameterInformationTextSecond(m_server);
+	return ParameterInformationTextSecond(m_server, m_is_suppressed);
 }
 
 ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecond
 ExtendedCommandBase::ReadServerHandle::ParameterInformationText::printHexadecimalStringParameter(const uint8_t* data, uint16_t size) &&
 {
 	printHexadecimalStringParameter_(data, size);
-	return ParameterInformationTextSecond(m_server);
+	return ParameterInformationTextSecond(m_server, m_is_suppressed);
 }
 
 void ExtendedCommandBase::ReadServerHandle::ParameterInformationText::printNumericParameter_(uint32_t value, uint8_t base)
 {
+	if (m_is_suppressed)
+	{
+		return;
+	}
 	m_server.printNumber(value, base);
 }
 
 void ExtendedCommandBase::ReadServerHandle::ParameterInformationText::printStringParameter_(const char* s)
 {
+	if (m_is_suppressed)
+	{
+		return;
+	}
 	m_server.printString(s);
 }
 
 void ExtendedCommandBase::ReadServerHandle::ParameterInformationText::printHexadecimalStringParameter_(const uint8_t* data, uint16_t size)
 {
+	if (m_is_suppressed)
+	{
+		return;
+	}
 	m_server.printHexadecimalString(data, size);
 }
 
-ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecond::ParameterInformationTextSecond(Server& server) :
-	m_server{server}
+ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecond::ParameterInformationTextSecond(Server& server, bool is_suppressed) :
+	m_server{server},
+	m_is_suppressed{is_suppressed}
 {}
 
 ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecond&&
@@ -127,26 +129,48 @@ ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecond::printHexa
 
 void ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecond::printNumericParameter_(uint32_t value, uint8_t base)
 {
+	if (m_is_suppressed)
+	{
+		return;
+	}
 	m_server.printChar(',');
 	m_server.printNumber(value, base);
 }
 
 void ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecond::printStringParameter_(const char* s)
 {
+	if (m_is_suppressed)
+	{
+		return;
+	}
 	m_server.printChar(',');
 	m_server.printString(s);
 }
 
 void ExtendedCommandBase::ReadServerHandle::ParameterInformationTextSecond::printHexadecimalStringParameter_(const uint8_t* data, uint16_t size)
 {
+	if (m_is_suppressed)
+	{
+		return;
+	}
 	m_server.printChar(',');
 	m_server.printHexadecimalString(data, size);
 }
 
-ExtendedCommandBase::ReadServerHandle::ReadServerHandle(Server& server, bool is_last_command, CALL_TYPE call_type) :
-	TestServerHandle(server, is_last_command, call_type)
+ExtendedCommandBase::ReadServerHandle::ReadServerHandle(Server& server, bool is_last_command, CALL_TYPE call_type, void* async_state) :
+	TestServerHandle(server, is_last_command, call_type, async_state)
 {}
 
+const ResponseFraming& ExtendedCommandBase::ReadServerHandle::getResponseFraming()
+{
+	return m_server.getCommunicationParameters().getResponseFraming();
+}
+
+void ExtendedCommandBase::ReadServerHandle::printBuffer(const char* data, std::size_t size)
+{
+	m_server.printBuffer(data, size);
+}
+
 ExtendedCommandBase::ReadServerHandle::ParameterInformationText
 ExtendedCommandBase::ReadServerHandle::makeParameterInformationText(const char* name, bool is_result_code)
 {
@@ -0,0 +1,73 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <atcmd/detail/responseframing.h>
+
+#include <assert.h>
+
+namespace atcmd::server::detail {
+
+void ResponseFraming::compose(char s3, char s4, bool verbose)
+{
+	m_line_break[0] = s3;
+	m_line_break[1] = s4;
+	m_verbose = verbose;
+	m_is_default = (s3 == default_s3) && (s4 == default_s4);
+}
+
+std::string_view ResponseFraming::getResultCode(RESULT_CODE code, char* buf) const
+{
+	assert(code <= RESULT_CODE::NO_ANSWER);
+
+	uint8_t i = static_cast<uint8_t>(code);
+	if (!m_is_default)
+	{
+		return std::string_view(buf, composeResultCode(i, m_line_break[0], m_line_break[1], m_verbose, buf));
+	}
+
+	const ComposedResultCodes& composed = m_verbose ? m_default_verbose : m_default_numeric;
+	return std::string_view(&composed.text[composed.offsets[i]], composed.offsets[i + 1] - composed.offsets[i]);
+}
+
+std::string_view ResponseFraming::getResultCodeHeader() const
+{
+	return std::string_view(m_line_break, m_verbose ? 2 : 0);
+}
+
+std::string_view ResponseFraming::getResultCodeTrailer() const
+{
+	return std::string_view(m_line_break, m_verbose ? 2 : 1);
+}
+
+std::string_view ResponseFraming::getInformationTextHeader() const
+{
+	return getResultCodeHeader();
+}
+
+std::string_view ResponseFraming::getInformationTextTrailer() const
+{
+	return std::string_view(m_line_break, 2);
+}
+
+} /* namespace atcmd::server::detail */
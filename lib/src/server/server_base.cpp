@@ -24,10 +24,15 @@
 
 #include <atcmd/server/server_base.h>
 
+#include <atomic>
+
 #include <atcmd/detail/characters.h>
 
 namespace atcmd::server::detail {
 
+// Added to the generation of each server, a response is replayed only if neither changed since it was recorded
+static std::atomic<uint32_t> l_shared_response_cache_generation{0};
+
 SParameters& Server::getCommunicationParameters()
 {
 	return m_s_parameters;
@@ -35,20 +40,49 @@ SParameters& Server::getCommunicationParameters()
 
 void Server::printChar(char ch)
 {
+	if (m_recorder != nullptr)
+	{
+		m_recorder->record(&ch, 1);
+		if (m_recorder->is_capturing)
+		{
+			return;
+		}
+	}
 	m_print_char_callback(ch, m_context);
 }
 
-void Server::printText(const char* text)
+void Server::printBuffer(const char* data, std::size_t size)
 {
-	while (*text != '\0')
+	if (m_recorder != nullptr)
+	{
+		m_recorder->record(data, size);
+		if (m_recorder->is_capturing)
+		{
+			return;
+		}
+	}
+	if (m_print_text_callback != nullptr)
+	{
+		m_print_text_callback(data, size, m_context);
+	}
+	else
 	{
-		printChar(*text++);
+		for (std::size_t i = 0; i < size; i++)
+		{
+			m_print_char_callback(data[i], m_context);
+		}
 	}
 }
 
+void Server::printText(const char* text)
+{
+	printBuffer(std::string_view(text));
+}
+
 void Server::printNumber(uint32_t number, uint8_t base)
 {
-	atcmd::detail::Characters::printNumber(number, base, m_print_char_callback, m_context);
+	char buf[atcmd::detail::Characters::max_number_size];
+	printBuffer(buf, atcmd::detail::Characters::formatNumber(number, base, buf));
 }
 
 void Server::printString(const char* string)
@@ -60,20 +94,29 @@ void Server::printString(const char* string)
 
 void Server::printHexadecimalString(const uint8_t* data, uint16_t size)
 {
+	static constexpr uint16_t chunk_size = 16;
+	char buf[chunk_size * 2];
+
 	printChar('"');
-	atcmd::detail::Characters::printHexadecimalString(data, size, m_print_char_callback, m_context);
+	while (size != 0)
+	{
+		uint16_t n = size < chunk_size ? size : chunk_size;
+		atcmd::detail::Characters::formatHexadecimalString(data, n, buf);
+		printBuffer(buf, n * 2);
+		data += n;
+		size -= n;
+	}
 	printChar('"');
 }
 
 void Server::printInformationTextHeader()
 {
-	printResultCodeHeader();
+	printBuffer(m_s_parameters.getResponseFraming().getInformationTextHeader());
 }
 
 void Server::printInformationTextTrailer()
 {
-	printChar(m_s_parameters.getCmdLineTerminationChar());
-	printChar(m_s_parameters.getResponseFormattingChar());
+	printBuffer(m_s_parameters.getResponseFraming().getInformationTextTrailer());
 }
 
 void Server::printExtendedInformationTextHeader(const char* name)
@@ -85,48 +128,23 @@ void Server::printExtendedInformationTextHeader(const char* name)
 
 void Server::printResultCodeHeader()
 {
-	if (getCommunicationParameters().isVerbose())
-	{
-		printChar(m_s_parameters.getCmdLineTerminationChar());
-		printChar(m_s_parameters.getResponseFormattingChar());
-	}
+	printBuffer(m_s_parameters.getResponseFraming().getResultCodeHeader());
 }
 
 void Server::printResultCodeTrailer()
 {
-	printChar(m_s_parameters.getCmdLineTerminationChar());
-	if (getCommunicationParameters().isVerbose())
-	{
-		printChar(m_s_parameters.getResponseFormattingChar());
-	}
+	printBuffer(m_s_parameters.getResponseFraming().getResultCodeTrailer());
 }
 
 void Server::printResultCode(RESULT_CODE code)
 {
-	static constexpr const char* codes[] =
-	{
-		"OK",
-		"CONNECT",
-		"RING",
-		"NO CARRIER",
-		"ERROR",
-		"",
-		"NO DIALTONE",
-		"BUSY",
-		"NO ANSWER"
-	};
-	assert(code <= RESULT_CODE::NO_ANSWER);
-
-	printResultCodeHeader();
-	if (getCommunicationParameters().isVerbose())
-	{
-		printText(codes[static_cast<uint8_t>(code)]);
-	}
-	else
-	{
-		printChar('0' + static_cast<uint8_t>(code));
-	}
-	printResultCodeTrailer();
+	char buf[ResponseFraming::max_result_code_size];
+	printBuffer(m_s_parameters.getResponseFraming().getResultCode(code, buf));
+}
+
+void Server::printBuffer(std::string_view text)
+{
+	printBuffer(text.data(), text.size());
 }
 
 PrintCharCallback Server::getPrintCharCallback()
@@ -139,6 +157,16 @@ void Server::setPrintCharCallback(PrintCharCallback print_char_callback)
 	m_print_char_callback = print_char_callback;
 }
 
+PrintTextCallback Server::getPrintTextCallback()
+{
+	return m_print_text_callback;
+}
+
+void Server::setPrintTextCallback(PrintTextCallback print_text_callback)
+{
+	m_print_text_callback = print_text_callback;
+}
+
 void Server::setContext(void* context)
 {
 	m_context = context;
@@ -149,32 +177,58 @@ void* Server::getContext()
 	return m_context;
 }
 
+void Server::invalidateResponseCache()
+{
+	m_response_cache_generation++;
+}
+
+void Server::invalidateAllResponseCaches()
+{
+	l_shared_response_cache_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
 Server::Server(PrintCharCallback print_char_callback, void* context) :
 	m_print_char_callback{print_char_callback},
-	m_context{context}
+	m_print_text_callback{nullptr},
+	m_context{context},
+	m_recorder{nullptr},
+	m_response_cache_generation{0}
 {}
 
+void Server::setOutputRecorder(OutputRecorder* recorder)
+{
+	m_recorder = recorder;
+}
+
+uint32_t Server::getResponseCacheGeneration() const
+{
+	return m_response_cache_generation + l_shared_response_cache_generation.load(std::memory_order_relaxed);
+}
+
 BasicCommandBase::BasicServerHandle Server::getBasicHandle(
 		const uint8_t* param_start,
 		bool is_last_command,
-		BasicCommandBase::BasicServerHandle::CALL_TYPE call_type)
+		BasicCommandBase::BasicServerHandle::CALL_TYPE call_type,
+		void* async_state)
 {
-	return BasicCommandBase::BasicServerHandle(param_start, *this, is_last_command, call_type);
+	return BasicCommandBase::BasicServerHandle(param_start, *this, is_last_command, call_type, async_state);
 }
 
 ExtendedCommandBase::ReadServerHandle Server::getReadHandle(
 		bool is_last_command,
-		ExtendedCommandBase::ReadServerHandle::CALL_TYPE call_type)
+		ExtendedCommandBase::ReadServerHandle::CALL_TYPE call_type,
+		void* async_state)
 {
-	return ExtendedCommandBase::ReadServerHandle(*this, is_last_command, call_type);
+	return ExtendedCommandBase::ReadServerHandle(*this, is_last_command, call_type, async_state);
 }
 
 ExtendedCommandBase::WriteServerHandle Server::getWriteHandle(
 		const uint8_t* param_start,
 		bool is_last_command,
-		ExtendedCommandBase::ReadServerHandle::CALL_TYPE call_type)
+		ExtendedCommandBase::ReadServerHandle::CALL_TYPE call_type,
+		void* async_state)
 {
-	return ExtendedCommandBase::WriteServerHandle(param_start, *this, is_last_command, call_type);
+	return ExtendedCommandBase::WriteServerHandle(param_start, *this, is_last_command, call_type, async_state);
 }
 
 ExtendedCommandBase::TestServerHandle Server::getTestHandle(bool is_last_command)
@@ -182,7 +236,8 @@ ExtendedCommandBase::TestServerHandle Server::getTestHandle(bool is_last_command
 	return ExtendedCommandBase::TestServerHandle(
 				*this,
 				is_last_command,
-				ExtendedCommandBase::TestServerHandle::CALL_TYPE::REQUEST);
+				ExtendedCommandBase::TestServerHandle::CALL_TYPE::REQUEST,
+				nullptr);
 }
 
 } /* namespace atcmd::server::detail */
@@ -31,7 +31,9 @@ SParameters::SParameters() :
 	m_s4{'\n'},
 	m_verbose{true},
 	m_echo_enabled{true}
-{}
+{
+	composeResponseFraming();
+}
 
 char SParameters::getCmdLineTerminationChar() const
 {
@@ -40,7 +42,12 @@ char SParameters::getCmdLineTerminationChar() const
 
 void SParameters::setCmdLineTerminationChar(char ch)
 {
+	if (m_s3 == ch)
+	{
+		return;
+	}
 	m_s3 = ch;
+	composeResponseFraming();
 }
 
 char SParameters::getResponseFormattingChar() const
@@ -50,7 +57,12 @@ char SParameters::getResponseFormattingChar() const
 
 void SParameters::setResponseFormattingChar(char ch)
 {
+	if (m_s4 == ch)
+	{
+		return;
+	}
 	m_s4 = ch;
+	composeResponseFraming();
 }
 
 bool SParameters::isVerbose() const
@@ -60,7 +72,12 @@ bool SParameters::isVerbose() const
 
 void SParameters::setVerbose(bool verbose)
 {
+	if (m_verbose == verbose)
+	{
+		return;
+	}
 	m_verbose = verbose;
+	composeResponseFraming();
 }
 
 bool SParameters::isEchoEnabled() const
@@ -73,4 +90,14 @@ void SParameters::setEchoEnabled(bool enabled)
 	m_echo_enabled = enabled;
 }
 
+const detail::ResponseFraming& SParameters::getResponseFraming() const
+{
+	return m_response_framing;
+}
+
+void SParameters::composeResponseFraming()
+{
+	m_response_framing.compose(m_s3, m_s4, m_verbose);
+}
+
 }
@@ -0,0 +1,126 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <atcmd/server/timerwheel.h>
+
+namespace atcmd::server {
+
+TimerWheel::TimerWheel() :
+	m_slots{},
+	m_time{0}
+{}
+
+void TimerWheel::arm(Timer& timer, uint32_t ticks)
+{
+	cancel(timer);
+	if (ticks == 0)
+	{
+		ticks = 1;
+	}
+	else if (ticks > max_ticks)
+	{
+		ticks = max_ticks;
+	}
+	timer.expiry = m_time + ticks;
+	insert(timer);
+}
+
+void TimerWheel::cancel(Timer& timer)
+{
+	if (!timer.isArmed())
+	{
+		return;
+	}
+	*timer.pprev = timer.next;
+	if (timer.next != nullptr)
+	{
+		timer.next->pprev = timer.pprev;
+	}
+	timer.next = nullptr;
+	timer.pprev = nullptr;
+}
+
+void TimerWheel::tick(uint32_t ticks)
+{
+	while (ticks-- != 0)
+	{
+		m_time++;
+
+		// Timers of the upper levels move down when the lower level wraps around
+		for (uint8_t level = 1; level < level_count; level++)
+		{
+			if ((m_time & ((1u << (level_bits * level)) - 1)) != 0)
+			{
+				break;
+			}
+			cascade(level);
+		}
+
+		Timer*& slot = m_slots[0][m_time & (slot_count - 1)];
+		while (slot != nullptr)
+		{
+			Timer& timer = *slot;
+			cancel(timer);
+			timer.callback(timer.context);
+		}
+	}
+}
+
+uint32_t TimerWheel::getTime() const
+{
+	return m_time;
+}
+
+void TimerWheel::insert(Timer& timer)
+{
+	uint32_t delta = timer.expiry - m_time;
+	uint8_t level = 0;
+	while ((level + 1 < level_count) && (delta >= (1u << (level_bits * (level + 1)))))
+	{
+		level++;
+	}
+
+	Timer*& slot = m_slots[level][(timer.expiry >> (level_bits * level)) & (slot_count - 1)];
+	timer.next = slot;
+	timer.pprev = &slot;
+	if (slot != nullptr)
+	{
+		slot->pprev = &timer.next;
+	}
+	slot = &timer;
+}
+
+void TimerWheel::cascade(uint8_t level)
+{
+	Timer* timer = m_slots[level][(m_time >> (level_bits * level)) & (slot_count - 1)];
+	while (timer != nullptr)
+	{
+		Timer* next = timer->next;
+		cancel(*timer);
+		insert(*timer);
+		timer = next;
+	}
+}
+
+} /* namespace atcmd::server */
@@ -0,0 +1,269 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+// Prints the given number of responses, counted in the state
+struct Countdown : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "CNT";
+
+		struct AsyncState
+		{
+			uint32_t remaining;
+			uint32_t printed;
+		};
+
+		struct Count : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{1, 9}};
+		};
+
+		using Parameters = ParameterList<Count>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle, AsyncState& state)
+		{
+			switch (server_handle.getCallType()) {
+			case WriteServerHandle::CALL_TYPE::REQUEST:
+				state.remaining = Parameters(server_handle).getNumeric<Count>();
+				return atcmd::RESULT_CODE::ASYNC;
+			case WriteServerHandle::CALL_TYPE::RESPONSE:
+			{
+				state.printed++;
+				const char text[] = {'+', 'C', 'N', 'T', ':', static_cast<char>('0' + state.printed), '\0'};
+				server_handle.makeInformationText().printText(text);
+				return --state.remaining == 0 ? atcmd::RESULT_CODE::OK : atcmd::RESULT_CODE::ASYNC;
+			}
+			default:
+				aborted_printed = state.printed;
+				return atcmd::RESULT_CODE::OK;
+			}
+		}
+
+		// The state is value-initialized on every request
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle, AsyncState& state)
+		{
+			if (server_handle.getCallType() == ReadServerHandle::CALL_TYPE::REQUEST)
+			{
+				seen_at_request = state.printed;
+				state.printed = 5;
+				return atcmd::RESULT_CODE::ASYNC;
+			}
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static inline uint32_t aborted_printed = 0;
+		static inline uint32_t seen_at_request = 0;
+	};
+};
+
+// Echoes its parameter from the state
+struct Latch : public atcmd::server::BasicCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "L";
+
+		struct AsyncState
+		{
+			char value;
+		};
+
+		struct Value : public BasicNumericParameter
+		{
+			static constexpr Range ranges[] = {{0, 9}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onExec(BasicServerHandle server_handle, AsyncState& state)
+		{
+			if (server_handle.getCallType() == BasicServerHandle::CALL_TYPE::REQUEST)
+			{
+				state.value = static_cast<char>('0' + Parameters(server_handle).getNumeric<Value>());
+				return atcmd::RESULT_CODE::ASYNC;
+			}
+			const char text[] = {'L', ':', state.value, '\0'};
+			server_handle.makeInformationText().printText(text);
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+// Concurrent command answering with the parameter kept in its state
+template<char id>
+struct Remember : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = {'R', id, '\0'};
+		static constexpr bool concurrent = true;
+
+		struct AsyncState
+		{
+			uint32_t value;
+		};
+
+		struct Value : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 9}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle, AsyncState& state)
+		{
+			switch (server_handle.getCallType()) {
+			case WriteServerHandle::CALL_TYPE::REQUEST:
+				state.value = Parameters(server_handle).template getNumeric<Value>();
+				return atcmd::RESULT_CODE::ASYNC;
+			case WriteServerHandle::CALL_TYPE::RESPONSE:
+			{
+				const char text[] = {'R', id, ':', static_cast<char>('0' + state.value), '\0'};
+				server_handle.makeInformationText().printText(text);
+				return atcmd::RESULT_CODE::OK;
+			}
+			default:
+				aborted_values += static_cast<char>('0' + state.value);
+				return atcmd::RESULT_CODE::OK;
+			}
+		}
+
+		static inline std::string aborted_values;
+	};
+};
+
+using R1 = Remember<'1'>;
+using R2 = Remember<'2'>;
+using R3 = Remember<'3'>;
+
+struct AsyncStateSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<Latch>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Countdown>;
+
+	static constexpr std::size_t max_commands_per_line = 2;
+};
+
+struct ConcurrentAsyncStateSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<R1, R2, R3>;
+
+	static constexpr std::size_t max_commands_per_line = 3;
+};
+
+TEST(AsyncStateTest, KeptAcrossResponses) {
+	TestSession<AsyncStateSettings> session;
+	session.feed("AT+CNT=3\r");
+	session.server.onExtendedCommandWriteUpdate<Countdown>();
+	session.server.onExtendedCommandWriteUpdate<Countdown>();
+	ASSERT_EQ(session.output, "\r\n+CNT:1\r\n\r\n+CNT:2\r\n");
+	session.server.onExtendedCommandWriteUpdate<Countdown>();
+	ASSERT_EQ(session.output, "\r\n+CNT:1\r\n\r\n+CNT:2\r\n\r\n+CNT:3\r\n\r\nOK\r\n");
+}
+
+TEST(AsyncStateTest, ValueInitializedOnRequest) {
+	TestSession<AsyncStateSettings> session;
+	session.feed("AT+CNT=1\r");
+	session.server.onExtendedCommandWriteUpdate<Countdown>();
+	session.output.clear();
+
+	Countdown::Definition::seen_at_request = 0xFF;
+	session.feed("AT+CNT?\r");
+	ASSERT_EQ(Countdown::Definition::seen_at_request, 0u);
+	session.server.onExtendedCommandReadUpdate<Countdown>();
+	ASSERT_EQ(session.output, "\r\nOK\r\n");
+}
+
+TEST(AsyncStateTest, PassedOnAbort) {
+	TestSession<AsyncStateSettings> session;
+	session.feed("AT+CNT=5\r");
+	session.server.onExtendedCommandWriteUpdate<Countdown>();
+	session.server.onExtendedCommandWriteUpdate<Countdown>();
+	Countdown::Definition::aborted_printed = 0;
+	session.server.feed('X', true);
+	ASSERT_EQ(Countdown::Definition::aborted_printed, 2u);
+}
+
+TEST(AsyncStateTest, BasicCommand) {
+	TestSession<AsyncStateSettings> session;
+	session.feed("ATL7\r");
+	session.server.onBasicCommandExecUpdate<Latch>();
+	ASSERT_EQ(session.output, "\r\nL:7\r\n\r\nOK\r\n");
+}
+
+TEST(AsyncStateTest, SessionsAreIndependent) {
+	TestSession<AsyncStateSettings> a;
+	TestSession<AsyncStateSettings> b;
+	a.feed("AT+CNT=2\r");
+	b.feed("AT+CNT=1\r");
+	a.server.onExtendedCommandWriteUpdate<Countdown>();
+	b.server.onExtendedCommandWriteUpdate<Countdown>();
+	a.server.onExtendedCommandWriteUpdate<Countdown>();
+	ASSERT_EQ(a.output, "\r\n+CNT:1\r\n\r\n+CNT:2\r\n\r\nOK\r\n");
+	ASSERT_EQ(b.output, "\r\n+CNT:1\r\n\r\nOK\r\n");
+}
+
+TEST(AsyncStateTest, ConcurrentCommandsHaveOwnStates) {
+	TestSession<ConcurrentAsyncStateSettings> session;
+	session.feed("AT+R1=1;+R2=2;+R3=3\r");
+	session.server.onExtendedCommandWriteUpdate<R3>();
+	session.server.onExtendedCommandWriteUpdate<R2>();
+	session.server.onExtendedCommandWriteUpdate<R1>();
+	ASSERT_EQ(session.output, "\r\nR1:1\r\n\r\nR2:2\r\n\r\nR3:3\r\n\r\nOK\r\n");
+
+	// The slots are reused by the next line
+	session.output.clear();
+	session.feed("AT+R1=4;+R2=5;+R3=6\r");
+	session.server.onExtendedCommandWriteUpdate<R1>();
+	session.server.onExtendedCommandWriteUpdate<R2>();
+	session.server.onExtendedCommandWriteUpdate<R3>();
+	ASSERT_EQ(session.output, "\r\nR1:4\r\n\r\nR2:5\r\n\r\nR3:6\r\n\r\nOK\r\n");
+}
+
+TEST(AsyncStateTest, ConcurrentAbort) {
+	TestSession<ConcurrentAsyncStateSettings> session;
+	R1::Definition::aborted_values.clear();
+	R2::Definition::aborted_values.clear();
+	R3::Definition::aborted_values.clear();
+	session.feed("AT+R1=7;+R2=8;+R3=9\r");
+	session.server.onExtendedCommandWriteUpdate<R1>();
+	session.server.feed('X', true);
+	ASSERT_EQ(R1::Definition::aborted_values, "");
+	ASSERT_EQ(R2::Definition::aborted_values, "8");
+	ASSERT_EQ(R3::Definition::aborted_values, "9");
+}
@@ -0,0 +1,386 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atcmd/client/client.h>
+#include <atcmd/host/epolltransport.h>
+
+static std::string l_log;
+
+struct ClientValue : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "VAL";
+
+		struct Decimal : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 100}};
+		};
+
+		struct Hexadecimal : public HexadecimalNumericParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint32_t default_value = 0x10;
+			static constexpr Range ranges[] = {{0, 0xFF}};
+		};
+
+		struct Binary : public BinaryNumericParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint32_t default_value = 1;
+			static constexpr Range ranges[] = {{0, 7}};
+		};
+
+		struct Text : public StringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_length = 8;
+			static constexpr const char* default_value = "x";
+		};
+
+		struct Bytes : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_size = 4;
+			static constexpr uint8_t default_value[] = {0xEE};
+		};
+
+		using Parameters = ParameterList<Decimal, Hexadecimal, Binary, Text, Bytes>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			l_log += "VAL" + std::to_string(parameters.getNumeric<Decimal>()) + "," +
+					std::to_string(parameters.getNumeric<Hexadecimal>()) + "," +
+					std::to_string(parameters.getNumeric<Binary>()) + "," + parameters.getString<Text>() + ",";
+			for (uint8_t byte : parameters.getHexString<Bytes>())
+			{
+				l_log += std::to_string(byte) + " ";
+			}
+			l_log += ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeParameterInformationText<Parameters>(name)
+					.printNumericParameter<Decimal>(42);
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct ClientList : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "LIST";
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeInformationText().printText("+LIST:1");
+			server_handle.makeInformationText().printText("+LIST:2");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct ClientQuiet : public atcmd::server::BasicCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "Q";
+
+		struct Value : public BasicNumericParameter
+		{
+			static constexpr Range ranges[] = {{0, 1}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onExec(BasicServerHandle server_handle)
+		{
+			l_log += "Q" + std::to_string(Parameters(server_handle).getNumeric<Value>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct ClientReset : public atcmd::server::BasicCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "F";
+
+		struct Profile : public BasicNumericParameter
+		{
+			static constexpr Range ranges[] = {{0, 0}};
+		};
+
+		using Parameters = ParameterList<Profile>;
+
+		static atcmd::RESULT_CODE onExec(BasicServerHandle /*server_handle*/)
+		{
+			l_log += "&F;";
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct ClientSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<ClientQuiet>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<ClientReset>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<ClientValue, ClientList>;
+
+	static constexpr std::size_t max_commands_per_line = 4;
+};
+
+using ClientTransport = atcmd::host::EpollTransport<ClientSettings>;
+using atcmd::client::Line;
+
+static void writeToFd(const char* data, std::size_t size, void* context)
+{
+	int fd = *static_cast<int*>(context);
+	while (size != 0)
+	{
+		ssize_t n = write(fd, data, size);
+		if (n > 0)
+		{
+			data += n;
+			size -= static_cast<std::size_t>(n);
+		}
+		else if ((n < 0) && (errno != EAGAIN) && (errno != EINTR))
+		{
+			return;
+		}
+	}
+}
+
+static void collectResponse(const atcmd::client::Response& response, void* context)
+{
+	static_cast<std::vector<atcmd::client::Response>*>(context)->push_back(response);
+}
+
+class ClientTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		l_log.clear();
+		int fds[2];
+		ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+		fcntl(fds[1], F_SETFL, O_NONBLOCK);
+		m_fd = fds[1];
+		ASSERT_EQ(m_transport.add(fds[0]), 0);
+	}
+
+	void TearDown() override
+	{
+		close(m_fd);
+	}
+
+	// Runs the server loop and feeds the client until it has completed count requests
+	void run(atcmd::client::Client& client, uint64_t count)
+	{
+		for (int i = 0; (i < 1000) && (client.getCompletedCount() < count); i++)
+		{
+			m_transport.poll(1);
+			char buf[512];
+			ssize_t n;
+			while ((n = read(m_fd, buf, sizeof(buf))) > 0)
+			{
+				client.feed(buf, static_cast<std::size_t>(n));
+			}
+		}
+	}
+
+	ClientTransport m_transport;
+	int m_fd;
+	std::vector<atcmd::client::Response> m_responses;
+};
+
+TEST(ClientLine, Encoding) {
+	static constexpr uint8_t bytes[] = {0x01, 0xA2};
+	Line line;
+	line.basic<ClientQuiet>(1).ampersand<ClientReset>(0).write<ClientValue>(5, 0xAB, 5, "hi", bytes)
+			.read<ClientList>().test<ClientValue>();
+	ASSERT_TRUE(line.isValid());
+	ASSERT_EQ(line.getText(), "ATQ1&F0+VAL=5,AB,101,\"hi\",\"01A2\";+LIST?;+VAL=?");
+
+	Line omitted;
+	omitted.write<ClientValue>(7, std::nullopt, 3);
+	ASSERT_TRUE(omitted.isValid());
+	ASSERT_EQ(omitted.getText(), "AT+VAL=7,,11");
+}
+
+TEST(ClientLine, Validation) {
+	static constexpr uint8_t bytes[] = {1, 2, 3, 4, 5};
+	ASSERT_FALSE(Line().write<ClientValue>(101).isValid());
+	ASSERT_FALSE(Line().write<ClientValue>(-1).isValid());
+	ASSERT_FALSE(Line().write<ClientValue>(1, 0x100).isValid());
+	ASSERT_FALSE(Line().write<ClientValue>(1, 0, 0, "123456789").isValid());
+	ASSERT_FALSE(Line().write<ClientValue>(1, 0, 0, "a\"b").isValid());
+	ASSERT_FALSE(Line().write<ClientValue>(1, 0, 0, "", bytes).isValid());
+	ASSERT_FALSE(Line().basic<ClientQuiet>(2).isValid());
+	ASSERT_TRUE(Line().write<ClientValue>(100, 0xFF, 7, "12345678").isValid());
+}
+
+TEST_F(ClientTest, PipelinedRequests) {
+	m_transport.getSession(0).getCommunicationParameters().setEchoEnabled(false);
+	atcmd::client::Client client(writeToFd, &m_fd, 4);
+
+	ASSERT_TRUE(client.send(Line().write<ClientValue>(1, std::nullopt, std::nullopt, "ab"), collectResponse, &m_responses));
+	ASSERT_TRUE(client.send(Line().read<ClientValue>().read<ClientList>(), collectResponse, &m_responses));
+	ASSERT_TRUE(client.send("AT+VAL=200", collectResponse, &m_responses));
+	ASSERT_TRUE(client.send(Line().basic<ClientQuiet>(0).ampersand<ClientReset>(0), collectResponse, &m_responses));
+	ASSERT_TRUE(client.send(Line().read<ClientList>(), collectResponse, &m_responses));
+	ASSERT_FALSE(client.send(Line().basic<ClientQuiet>(3), collectResponse, &m_responses));
+	ASSERT_EQ(client.getInFlightCount(), 4);
+	ASSERT_EQ(client.getQueuedCount(), 1);
+
+	run(client, 5);
+	ASSERT_EQ(m_responses.size(), 5);
+	ASSERT_EQ(m_responses[0].result, atcmd::RESULT_CODE::OK);
+	ASSERT_TRUE(m_responses[0].lines.empty());
+	ASSERT_EQ(m_responses[1].result, atcmd::RESULT_CODE::OK);
+	ASSERT_EQ(m_responses[1].lines, (std::vector<std::string>{"+VAL:42", "+LIST:1", "+LIST:2"}));
+	ASSERT_EQ(m_responses[2].result, atcmd::RESULT_CODE::ERROR);
+	ASSERT_EQ(m_responses[3].result, atcmd::RESULT_CODE::OK);
+	ASSERT_EQ(m_responses[4].lines, (std::vector<std::string>{"+LIST:1", "+LIST:2"}));
+	ASSERT_EQ(l_log, "VAL1,16,1,ab,238 ;Q0;&F;");
+	ASSERT_EQ(client.getInFlightCount(), 0);
+}
+
+TEST_F(ClientTest, Echo) {
+	atcmd::client::Client client(writeToFd, &m_fd, 2);
+	client.setEchoExpected(true);
+	for (int i = 0; i < 3; i++)
+	{
+		ASSERT_TRUE(client.send(Line().read<ClientList>(), collectResponse, &m_responses));
+	}
+	run(client, 3);
+	ASSERT_EQ(m_responses.size(), 3);
+	for (const auto& response : m_responses)
+	{
+		ASSERT_EQ(response.lines, (std::vector<std::string>{"+LIST:1", "+LIST:2"}));
+	}
+}
+
+static void collectLine(std::string_view line, void* context)
+{
+	static_cast<std::vector<std::string>*>(context)->emplace_back(line);
+}
+
+TEST(Client, UnsolicitedLines) {
+	std::string sent;
+	auto write = [](const char* data, std::size_t size, void* context)
+	{
+		static_cast<std::string*>(context)->append(data, size);
+	};
+	std::vector<std::string> unsolicited;
+	std::vector<atcmd::client::Response> responses;
+	atcmd::client::Client client(write, &sent);
+	client.setUnsolicitedCallback(collectLine, &unsolicited);
+
+	client.feed("\r\n+URC:1\r\n", 10);
+	ASSERT_TRUE(client.send("AT+X?", collectResponse, &responses));
+	ASSERT_TRUE(client.send("AT+Y?", collectResponse, &responses));
+	ASSERT_EQ(sent, "AT+X?\r");
+
+	// Split at any point
+	const char reply[] = "\r\n+X:1\r\n\r\nOK\r\n\r\nBUSY\r\n\r\n+URC:2\r\n";
+	for (std::size_t i = 0; i < sizeof(reply) - 1; i++)
+	{
+		client.feed(&reply[i], 1);
+	}
+	ASSERT_EQ(sent, "AT+X?\rAT+Y?\r");
+	ASSERT_EQ(responses.size(), 2);
+	ASSERT_EQ(responses[0].lines, std::vector<std::string>{"+X:1"});
+	ASSERT_EQ(responses[1].result, atcmd::RESULT_CODE::BUSY);
+	ASSERT_EQ(unsolicited, (std::vector<std::string>{"+URC:1", "+URC:2"}));
+}
+
+TEST(Client, UnsolicitedLinesDuringRequest) {
+	std::string sent;
+	auto write = [](const char* data, std::size_t size, void* context)
+	{
+		static_cast<std::string*>(context)->append(data, size);
+	};
+	std::vector<std::string> unsolicited;
+	std::vector<atcmd::client::Response> responses;
+	atcmd::client::Client client(write, &sent);
+	client.setUnsolicitedCallback(collectLine, &unsolicited);
+
+	// Information text of the commands in the line, whatever their case, is part of the response
+	ASSERT_TRUE(client.send("AT+x?;+LIST=\"+URC:\";I", collectResponse, &responses));
+	const char reply[] = "\r\n+X:1\r\n\r\n+URC:3\r\n\r\nRING\r\n\r\n+LIST:2\r\n\r\nv1.0\r\n\r\nOK\r\n";
+	client.feed(reply, sizeof(reply) - 1);
+	ASSERT_EQ(responses.size(), 1);
+	ASSERT_EQ(responses[0].lines, (std::vector<std::string>{"+X:1", "+LIST:2", "v1.0"}));
+	ASSERT_EQ(unsolicited, (std::vector<std::string>{"+URC:3", "RING"}));
+}
+
+TEST(Client, DataMode) {
+	std::string sent;
+	auto write = [](const char* data, std::size_t size, void* context)
+	{
+		static_cast<std::string*>(context)->append(data, size);
+	};
+	std::vector<atcmd::client::Response> responses;
+	atcmd::client::Client client(write, &sent);
+
+	ASSERT_TRUE(client.send("AT+UPL=3", collectResponse, &responses));
+	ASSERT_TRUE(client.send("AT+X?", collectResponse, &responses));
+	ASSERT_FALSE(client.sendData("abc", 3));
+	client.feed("\r\nCONNECT\r\n", 11);
+	ASSERT_EQ(responses.size(), 1);
+	ASSERT_EQ(responses[0].result, atcmd::RESULT_CODE::CONNECT);
+
+	// The next line waits for the end of the payload
+	ASSERT_TRUE(client.sendData("abc", 3));
+	ASSERT_EQ(sent, "AT+UPL=3\rabc");
+	client.feed("\r\n+UPL:3\r\n\r\nOK\r\n", 16);
+	ASSERT_EQ(responses.size(), 2);
+	ASSERT_EQ(responses[1].result, atcmd::RESULT_CODE::OK);
+	ASSERT_EQ(responses[1].lines, std::vector<std::string>{"+UPL:3"});
+	ASSERT_EQ(sent, "AT+UPL=3\rabcAT+X?\r");
+	ASSERT_EQ(client.getInFlightCount(), 1);
+}
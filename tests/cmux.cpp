@@ -0,0 +1,326 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atcmd/cmux.h>
+
+using Codec = atcmd::detail::CmuxCodec;
+
+struct Banner : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "BNR";
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeInformationText().printText("+BNR:0123456789ABCDEFGHIJ");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct CmuxSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Banner>;
+
+	static constexpr std::size_t max_commands_per_line = 1;
+};
+
+using Mux = atcmd::Cmux<CmuxSettings, 2, 16, 256>;
+
+struct ReceivedFrame
+{
+	uint8_t address;
+	uint8_t control;
+	std::string info;
+};
+
+static std::vector<uint8_t> encode(uint8_t address, uint8_t control, std::string_view info = {})
+{
+	std::vector<uint8_t> frame(info.size() + Codec::max_overhead);
+	frame.resize(Codec::encode(frame.data(), address, control, reinterpret_cast<const uint8_t*>(info.data()), info.size()));
+	return frame;
+}
+
+static std::vector<uint8_t> encodeData(uint8_t dlci, std::string_view info)
+{
+	return encode(Codec::makeAddress(dlci, true), Codec::uih, info);
+}
+
+static std::vector<ReceivedFrame> decode(const std::vector<uint8_t>& bytes)
+{
+	std::vector<ReceivedFrame> frames;
+	uint8_t buffer[256];
+	atcmd::detail::CmuxDecoder decoder{buffer, sizeof(buffer)};
+	const uint8_t* data = bytes.data();
+	std::size_t size = bytes.size();
+	while (size != 0)
+	{
+		std::size_t consumed = decoder.feed(data, size);
+		data += consumed;
+		size -= consumed;
+		if (decoder.hasFrame())
+		{
+			atcmd::detail::CmuxFrame frame = decoder.getFrame();
+			frames.push_back({frame.address, frame.control,
+					std::string(reinterpret_cast<const char*>(frame.info.data()), frame.info.size())});
+		}
+	}
+	return frames;
+}
+
+static void writeToVector(const uint8_t* data, std::size_t size, void* context)
+{
+	static_cast<std::vector<uint8_t>*>(context)->insert(static_cast<std::vector<uint8_t>*>(context)->end(), data, data + size);
+}
+
+class CmuxTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		for (std::size_t i = 0; i < 2; i++)
+		{
+			m_mux.getSession(i).getCommunicationParameters().setEchoEnabled(false);
+		}
+	}
+
+	void feed(const std::vector<uint8_t>& data)
+	{
+		m_mux.feed(data.data(), data.size());
+	}
+
+	void open()
+	{
+		for (uint8_t dlci = 0; dlci <= 2; dlci++)
+		{
+			feed(encode(Codec::makeAddress(dlci, true), Codec::sabm | Codec::pf));
+		}
+		ASSERT_TRUE(m_mux.isOpen());
+		ASSERT_TRUE(m_mux.isChannelOpen(1));
+		m_written.clear();
+	}
+
+	std::vector<ReceivedFrame> takeFrames()
+	{
+		std::vector<ReceivedFrame> frames = decode(m_written);
+		m_written.clear();
+		return frames;
+	}
+
+	std::vector<uint8_t> m_written;
+	Mux m_mux{writeToVector, &m_written};
+};
+
+TEST_F(CmuxTest, ControlChannelFrames) {
+	// SABM and UA on DLCI 0 with their FCS as given by the specification
+	std::vector<uint8_t> sabm = encode(Codec::makeAddress(0, true), Codec::sabm | Codec::pf);
+	ASSERT_EQ(sabm, (std::vector<uint8_t>{0xF9, 0x03, 0x3F, 0x01, 0x1C, 0xF9}));
+	feed(sabm);
+	ASSERT_EQ(m_written, (std::vector<uint8_t>{0xF9, 0x03, 0x73, 0x01, 0xD7, 0xF9}));
+	ASSERT_TRUE(m_mux.isOpen());
+}
+
+TEST_F(CmuxTest, ChannelsNeedOpening) {
+	feed(encode(Codec::makeAddress(1, true), Codec::sabm | Codec::pf));
+	std::vector<ReceivedFrame> frames = takeFrames();
+	ASSERT_EQ(frames.size(), 1u);
+	ASSERT_EQ(frames[0].control, Codec::dm | Codec::pf);
+	ASSERT_FALSE(m_mux.isChannelOpen(0));
+
+	feed(encode(Codec::makeAddress(0, true), Codec::sabm | Codec::pf));
+	feed(encodeData(2, "AT\r"));
+	frames = takeFrames();
+	ASSERT_EQ(frames.size(), 2u);
+	ASSERT_EQ(frames[1].address, Codec::makeAddress(2, true));
+	ASSERT_EQ(frames[1].control, Codec::dm);
+}
+
+TEST_F(CmuxTest, ChannelsTakeTurns) {
+	open();
+	std::vector<uint8_t> block = encodeData(1, "AT+BNR?\r");
+	std::vector<uint8_t> second = encodeData(2, "AT\r");
+	block.insert(block.end(), second.begin(), second.end());
+	feed(block);
+
+	std::vector<ReceivedFrame> frames = takeFrames();
+	ASSERT_EQ(frames.size(), 4u);
+	const uint8_t expected_dlcis[] = {1, 2, 1, 1};
+	std::string responses[3];
+	for (std::size_t i = 0; i < frames.size(); i++)
+	{
+		ASSERT_EQ(frames[i].address, Codec::makeAddress(expected_dlcis[i], false));
+		ASSERT_EQ(frames[i].control, Codec::uih);
+		ASSERT_LE(frames[i].info.size(), 16u);
+		responses[expected_dlcis[i]] += frames[i].info;
+	}
+	ASSERT_EQ(responses[1], "\r\n+BNR:0123456789ABCDEFGHIJ\r\n\r\nOK\r\n");
+	ASSERT_EQ(responses[2], "\r\nOK\r\n");
+}
+
+TEST_F(CmuxTest, StreamResynchronizes) {
+	open();
+	std::vector<uint8_t> corrupted = encodeData(1, "AT\r");
+	corrupted[corrupted.size() - 2] ^= 0xFF;
+	std::vector<uint8_t> stream = {0x00, 0x55};
+	stream.insert(stream.end(), corrupted.begin(), corrupted.end());
+	std::vector<uint8_t> valid = encodeData(1, "AT\r");
+	stream.insert(stream.end(), valid.begin(), valid.end());
+	for (uint8_t byte : stream)
+	{
+		m_mux.feed(&byte, 1);
+	}
+	// The noise after the previous frame and the corrupted frame
+	ASSERT_EQ(m_mux.getDiscardedFrameCount(), 2u);
+	std::vector<ReceivedFrame> frames = takeFrames();
+	ASSERT_EQ(frames.size(), 1u);
+	ASSERT_EQ(frames[0].info, "\r\nOK\r\n");
+}
+
+TEST_F(CmuxTest, ControlMessages) {
+	open();
+	feed(encodeData(0, std::string_view("\x23\x07" "ABC", 5)));
+	feed(encodeData(0, std::string_view("\x93\x01", 2)));
+	std::vector<ReceivedFrame> frames = takeFrames();
+	ASSERT_EQ(frames.size(), 2u);
+	// Test command echoed as a response
+	ASSERT_EQ(frames[0].address, Codec::makeAddress(0, false));
+	ASSERT_EQ(frames[0].info, std::string_view("\x21\x07" "ABC", 5));
+	// Not supported
+	ASSERT_EQ(frames[1].info, std::string_view("\x11\x03\x93", 3));
+
+	// Close down
+	feed(encodeData(0, std::string_view("\xC3\x01", 2)));
+	frames = takeFrames();
+	ASSERT_EQ(frames.size(), 1u);
+	ASSERT_EQ(frames[0].info, std::string_view("\xC1\x01", 2));
+	ASSERT_FALSE(m_mux.isOpen());
+	ASSERT_FALSE(m_mux.isChannelOpen(0));
+}
+
+TEST_F(CmuxTest, ModemStatusFlowControl) {
+	open();
+	// The peer stops DLCI 1
+	feed(encodeData(0, std::string_view("\xE3\x05\x07\x0F", 4)));
+	feed(encodeData(1, "AT\r"));
+	std::vector<ReceivedFrame> frames = takeFrames();
+	ASSERT_EQ(frames.size(), 1u);
+	ASSERT_EQ(frames[0].info, std::string_view("\xE1\x05\x07\x0F", 4));
+
+	feed(encodeData(0, std::string_view("\xE3\x05\x07\x0D", 4)));
+	frames = takeFrames();
+	ASSERT_EQ(frames.size(), 2u);
+	ASSERT_EQ(frames[1].address, Codec::makeAddress(1, false));
+	ASSERT_EQ(frames[1].info, "\r\nOK\r\n");
+}
+
+TEST_F(CmuxTest, ParameterNegotiation) {
+	open();
+	// DLCI 1, N1 of 8
+	feed(encodeData(0, std::string_view("\x83\x11\x01\x00\x00\x00\x08\x00\x00\x00", 10)));
+	std::vector<ReceivedFrame> frames = takeFrames();
+	ASSERT_EQ(frames.size(), 1u);
+	ASSERT_EQ(frames[0].info, std::string_view("\x81\x11\x01\x00\x00\x00\x08\x00\x00\x00", 10));
+
+	feed(encodeData(1, "AT+BNR?\r"));
+	frames = takeFrames();
+	ASSERT_EQ(frames.size(), 5u);
+	for (const ReceivedFrame& frame : frames)
+	{
+		ASSERT_LE(frame.info.size(), 8u);
+	}
+}
+
+TEST_F(CmuxTest, ChannelClosing) {
+	open();
+	feed(encode(Codec::makeAddress(1, true), Codec::disc | Codec::pf));
+	feed(encodeData(1, "AT\r"));
+	std::vector<ReceivedFrame> frames = takeFrames();
+	ASSERT_EQ(frames.size(), 2u);
+	ASSERT_EQ(frames[0].control, Codec::ua | Codec::pf);
+	ASSERT_EQ(frames[1].control, Codec::dm);
+	ASSERT_FALSE(m_mux.isChannelOpen(0));
+	ASSERT_TRUE(m_mux.isChannelOpen(1));
+}
+
+static void writeToSocket(const uint8_t* data, std::size_t size, void* context)
+{
+	ASSERT_EQ(write(*static_cast<int*>(context), data, size), static_cast<ssize_t>(size));
+}
+
+TEST(CmuxLoopback, Socket) {
+	int fds[2];
+	ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+	Mux mux{writeToSocket, &fds[0]};
+	mux.getSession(0).getCommunicationParameters().setEchoEnabled(false);
+	mux.getSession(1).getCommunicationParameters().setEchoEnabled(false);
+
+	auto exchange = [&](const std::vector<uint8_t>& request) {
+		EXPECT_EQ(write(fds[1], request.data(), request.size()), static_cast<ssize_t>(request.size()));
+		uint8_t buf[512];
+		ssize_t size = read(fds[0], buf, sizeof(buf));
+		EXPECT_GT(size, 0);
+		mux.feed(buf, static_cast<std::size_t>(size));
+		size = recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+		EXPECT_GT(size, 0);
+		return decode(std::vector<uint8_t>(buf, buf + size));
+	};
+
+	for (uint8_t dlci = 0; dlci <= 2; dlci++)
+	{
+		std::vector<ReceivedFrame> frames = exchange(encode(Codec::makeAddress(dlci, true), Codec::sabm | Codec::pf));
+		ASSERT_EQ(frames.size(), 1u);
+		ASSERT_EQ(frames[0].control, Codec::ua | Codec::pf);
+	}
+
+	for (int i = 0; i < 10; i++)
+	{
+		std::vector<uint8_t> request = encodeData(1, "AT+BNR?\r");
+		std::vector<uint8_t> second = encodeData(2, "AT+BNR?\r");
+		request.insert(request.end(), second.begin(), second.end());
+		std::string responses[3];
+		for (const ReceivedFrame& frame : exchange(request))
+		{
+			responses[frame.address >> 2] += frame.info;
+		}
+		ASSERT_EQ(responses[1], "\r\n+BNR:0123456789ABCDEFGHIJ\r\n\r\nOK\r\n");
+		ASSERT_EQ(responses[2], responses[1]);
+	}
+
+	close(fds[0]);
+	close(fds[1]);
+}
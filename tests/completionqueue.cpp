@@ -0,0 +1,183 @@
+/**
+* Copyright © 2026 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+struct Async : public atcmd::server::ExtendedCommand
+{
+	// Completes after the given number of responses
+	struct Definition
+	{
+		static constexpr char name[] = "ASYNC";
+
+		struct Count : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 1000000}};
+		};
+
+		using Parameters = ParameterList<Count>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			switch (server_handle.getCallType()) {
+			case WriteServerHandle::CALL_TYPE::REQUEST:
+				responses = 0;
+				return atcmd::RESULT_CODE::ASYNC;
+			case WriteServerHandle::CALL_TYPE::RESPONSE:
+				responses++;
+				return responses == parameters.getNumeric<Count>() ? atcmd::RESULT_CODE::OK : atcmd::RESULT_CODE::ASYNC;
+			default:
+				return atcmd::RESULT_CODE::ERROR;
+			}
+		}
+
+		static inline uint32_t responses = 0;
+	};
+};
+
+struct Settings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Async>;
+
+	static constexpr std::size_t max_commands_per_line = 1;
+	static constexpr std::size_t completion_queue_size = 64;
+};
+
+using CompletionQueueTest = ServerFixture<Settings>;
+
+TEST(CompletionQueue, Bounded) {
+	atcmd::server::detail::CompletionQueue<4> queue;
+	for (uint16_t i = 0; i < 4; i++)
+	{
+		ASSERT_TRUE(queue.push({i, atcmd::server::detail::CommandBase::ServerHandle::CALL_TYPE::RESPONSE}));
+	}
+	ASSERT_FALSE(queue.push({4, atcmd::server::detail::CommandBase::ServerHandle::CALL_TYPE::RESPONSE}));
+
+	atcmd::server::detail::Completion completion;
+	for (uint16_t i = 0; i < 4; i++)
+	{
+		ASSERT_TRUE(queue.pop(completion));
+		ASSERT_EQ(completion.cmd_id, i);
+	}
+	ASSERT_FALSE(queue.pop(completion));
+}
+
+TEST(CompletionQueue, MultipleProducers) {
+	static constexpr std::size_t producer_count = 4;
+	static constexpr uint16_t per_producer = 10000;
+
+	atcmd::server::detail::CompletionQueue<16> queue;
+	std::vector<std::thread> producers;
+	for (std::size_t p = 0; p < producer_count; p++)
+	{
+		producers.emplace_back([&queue, p]()
+		{
+			for (uint16_t i = 0; i < per_producer; i++)
+			{
+				uint16_t id = static_cast<uint16_t>((p << 14) | i);
+				while (!queue.push({id, atcmd::server::detail::CommandBase::ServerHandle::CALL_TYPE::RESPONSE}))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	// Every producer's completions arrive in order
+	uint16_t next[producer_count] = {};
+	std::size_t received = 0;
+	atcmd::server::detail::Completion completion;
+	while (received != producer_count * per_producer)
+	{
+		if (!queue.pop(completion))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		std::size_t p = completion.cmd_id >> 14;
+		ASSERT_EQ(completion.cmd_id & 0x3FFF, next[p]);
+		next[p]++;
+		received++;
+	}
+
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+}
+
+TEST_F(CompletionQueueTest, PostedUpdates) {
+	feed("AT+ASYNC=1000\r");
+	ASSERT_EQ(m_output, "");
+
+	std::vector<std::thread> producers;
+	for (std::size_t p = 0; p < 4; p++)
+	{
+		producers.emplace_back([this]()
+		{
+			for (std::size_t i = 0; i < 250; i++)
+			{
+				while (!m_server.postExtendedCommandWriteUpdate<Async>())
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	while (Async::Definition::responses != 1000)
+	{
+		m_server.processCompletions();
+	}
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+}
+
+TEST_F(CompletionQueueTest, PostedAbort) {
+	feed("AT+ASYNC=2\r");
+	ASSERT_TRUE(m_server.postAbort());
+	m_server.processCompletions();
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+
+	// Stale completions are ignored, the next line is handled by feed()
+	m_output.clear();
+	ASSERT_TRUE(m_server.postExtendedCommandWriteUpdate<Async>());
+	feed("AT\r");
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+}
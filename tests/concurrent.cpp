@@ -0,0 +1,215 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+// Answers with its parameter, a zero fails
+template<char id, bool concurrent_>
+struct Query : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = {'Q', id, '\0'};
+		static constexpr bool concurrent = concurrent_;
+
+		struct Value : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 9}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			switch (server_handle.getCallType()) {
+			case WriteServerHandle::CALL_TYPE::REQUEST:
+				requests++;
+				return atcmd::RESULT_CODE::ASYNC;
+			case WriteServerHandle::CALL_TYPE::RESPONSE:
+			{
+				uint32_t value = parameters.template getNumeric<Value>();
+				if (value == 0)
+				{
+					return atcmd::RESULT_CODE::ERROR;
+				}
+				const char text[] = {'Q', id, ':', static_cast<char>('0' + value), '\0'};
+				server_handle.makeInformationText().printText(text);
+				return atcmd::RESULT_CODE::OK;
+			}
+			default:
+				aborts++;
+				return atcmd::RESULT_CODE::OK;
+			}
+		}
+
+		static inline uint32_t requests = 0;
+		static inline uint32_t aborts = 0;
+	};
+};
+
+// Answers right away, even when started ahead of its turn
+struct Now : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "NOW";
+		static constexpr bool concurrent = true;
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeInformationText().printText("+NOW:5");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+using Q1 = Query<'1', true>;
+using Q2 = Query<'2', true>;
+using Q3 = Query<'3', true>;
+using Q4 = Query<'4', false>;
+
+struct ConcurrentSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Q1, Q2, Q3, Q4, Now>;
+
+	static constexpr std::size_t max_commands_per_line = 4;
+	static constexpr std::size_t concurrent_output_size = 16;
+};
+
+class ConcurrentTest : public ServerFixture<ConcurrentSettings>
+{
+protected:
+	void SetUp() override
+	{
+		ServerFixture::SetUp();
+		resetCounters<Q1>();
+		resetCounters<Q2>();
+		resetCounters<Q3>();
+		resetCounters<Q4>();
+	}
+
+	template<class Cmd>
+	static void resetCounters()
+	{
+		Cmd::Definition::requests = 0;
+		Cmd::Definition::aborts = 0;
+	}
+};
+
+TEST_F(ConcurrentTest, StartedTogether) {
+	feed("AT+Q1=1;+Q2=2;+Q3=3\r");
+	ASSERT_EQ(Q1::Definition::requests, 1u);
+	ASSERT_EQ(Q2::Definition::requests, 1u);
+	ASSERT_EQ(Q3::Definition::requests, 1u);
+
+	// Completions arriving out of order are held until the earlier commands are done
+	m_server.onExtendedCommandWriteUpdate<Q3>();
+	m_server.onExtendedCommandWriteUpdate<Q2>();
+	ASSERT_EQ(m_output, "");
+	m_server.onExtendedCommandWriteUpdate<Q1>();
+	ASSERT_EQ(m_output, "\r\nQ1:1\r\n\r\nQ2:2\r\n\r\nQ3:3\r\n\r\nOK\r\n");
+}
+
+TEST_F(ConcurrentTest, InOrderCompletions) {
+	feed("AT+Q1=1;+Q2=2\r");
+	m_server.onExtendedCommandWriteUpdate<Q1>();
+	ASSERT_EQ(m_output, "\r\nQ1:1\r\n");
+	m_server.onExtendedCommandWriteUpdate<Q2>();
+	ASSERT_EQ(m_output, "\r\nQ1:1\r\n\r\nQ2:2\r\n\r\nOK\r\n");
+}
+
+TEST_F(ConcurrentTest, StopsAtSequentialCommand) {
+	feed("AT+Q1=1;+Q4=4;+Q2=2\r");
+	ASSERT_EQ(Q4::Definition::requests, 0u);
+	ASSERT_EQ(Q2::Definition::requests, 0u);
+
+	m_server.onExtendedCommandWriteUpdate<Q1>();
+	ASSERT_EQ(Q4::Definition::requests, 1u);
+	ASSERT_EQ(Q2::Definition::requests, 0u);
+
+	// A sequential command at the head does not start the following ones either
+	m_server.onExtendedCommandWriteUpdate<Q4>();
+	ASSERT_EQ(Q2::Definition::requests, 1u);
+	m_server.onExtendedCommandWriteUpdate<Q2>();
+	ASSERT_EQ(m_output, "\r\nQ1:1\r\n\r\nQ4:4\r\n\r\nQ2:2\r\n\r\nOK\r\n");
+}
+
+TEST_F(ConcurrentTest, ErrorAbortsStarted) {
+	feed("AT+Q1=0;+Q2=2;+Q3=3\r");
+	m_server.onExtendedCommandWriteUpdate<Q2>();
+	m_server.onExtendedCommandWriteUpdate<Q1>();
+
+	// The held completion of Q2 is never delivered, it is aborted along with Q3
+	ASSERT_EQ(Q2::Definition::aborts, 1u);
+	ASSERT_EQ(Q3::Definition::aborts, 1u);
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+
+	// The next line starts from scratch
+	m_output.clear();
+	feed("AT+Q2=2\r");
+	m_server.onExtendedCommandWriteUpdate<Q2>();
+	ASSERT_EQ(m_output, "\r\nQ2:2\r\n\r\nOK\r\n");
+}
+
+TEST_F(ConcurrentTest, AbortAll) {
+	feed("AT+Q1=1;+Q2=2;+Q3=3\r");
+	m_server.feed('A', true);
+	ASSERT_EQ(Q1::Definition::aborts, 1u);
+	ASSERT_EQ(Q2::Definition::aborts, 1u);
+	ASSERT_EQ(Q3::Definition::aborts, 1u);
+
+	// Late completions are ignored
+	m_server.onExtendedCommandWriteUpdate<Q2>();
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+}
+
+TEST_F(ConcurrentTest, SynchronousStartedCommand) {
+	feed("AT+Q1=1;+NOW?;+Q2=2\r");
+	ASSERT_EQ(Q2::Definition::requests, 1u);
+	ASSERT_EQ(m_output, "");
+
+	// The response of the started command is printed in line order
+	m_server.onExtendedCommandWriteUpdate<Q2>();
+	m_server.onExtendedCommandWriteUpdate<Q1>();
+	ASSERT_EQ(m_output, "\r\nQ1:1\r\n\r\n+NOW:5\r\n\r\nQ2:2\r\n\r\nOK\r\n");
+}
+
+TEST_F(ConcurrentTest, StartedOutputOverflow) {
+	// The second response does not fit, the command fails without being printed
+	feed("AT+Q1=1;+NOW?;+NOW?\r");
+	m_server.onExtendedCommandWriteUpdate<Q1>();
+	ASSERT_EQ(m_output, "\r\nQ1:1\r\n\r\n+NOW:5\r\n\r\nERROR\r\n");
+}
@@ -0,0 +1,160 @@
+/**
+* Copyright © 2026 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+struct Steps : public atcmd::server::ExtendedCommand
+{
+	// Prints the step parity on every response, completes after the given number of steps
+	struct Definition
+	{
+		static constexpr char name[] = "STEPS";
+
+		struct Count : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 100}};
+		};
+
+		using Parameters = ParameterList<Count>;
+
+		static Task onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			uint32_t count = parameters.getNumeric<Count>();
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (!co_await Task::nextResponse())
+				{
+					cancelled++;
+					co_return atcmd::RESULT_CODE::ERROR;
+				}
+				server_handle.makeInformationText().printText(i % 2 == 0 ? "+STEPS:even" : "+STEPS:odd");
+			}
+			co_return atcmd::RESULT_CODE::OK;
+		}
+
+		static Task onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeParameterInformationText<Parameters>(name)
+					.printNumericParameter<Count>(cancelled);
+			co_return atcmd::RESULT_CODE::OK;
+		}
+
+		static inline uint32_t cancelled = 0;
+	};
+};
+
+struct W : public atcmd::server::BasicCommand
+{
+	// Waits for one response
+	struct Definition
+	{
+		static constexpr char name[] = "W";
+
+		struct Unused : public BasicNumericParameter
+		{
+			static constexpr Range ranges[] = {{0, 0}};
+		};
+
+		using Parameters = ParameterList<Unused>;
+
+		static Task onExec(BasicServerHandle /*server_handle*/)
+		{
+			co_return co_await Task::nextResponse() ? atcmd::RESULT_CODE::OK : atcmd::RESULT_CODE::ERROR;
+		}
+	};
+};
+
+struct CoroutineSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<W>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Steps>;
+
+	static constexpr std::size_t max_commands_per_line = 4;
+	static constexpr std::size_t coroutine_frame_size = 256;
+};
+
+struct TinyFrameSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Steps>;
+
+	static constexpr std::size_t max_commands_per_line = 1;
+	static constexpr std::size_t coroutine_frame_size = 8;
+};
+
+TEST(Coroutine, CompletesWithoutSuspending) {
+	TestSession<CoroutineSettings> session;
+	session.feed("AT+STEPS=0;+STEPS?\r");
+	ASSERT_EQ(session.output, "\r\n+STEPS:0\r\n\r\nOK\r\n");
+}
+
+TEST(Coroutine, SessionsResumedIndependently) {
+	TestSession<CoroutineSettings> first;
+	TestSession<CoroutineSettings> second;
+	first.feed("AT+STEPS=2\r");
+	second.feed("AT+STEPS=3\r");
+	ASSERT_EQ(first.output, "");
+
+	first.server.onExtendedCommandWriteUpdate<Steps>();
+	second.server.onExtendedCommandWriteUpdate<Steps>();
+	second.server.onExtendedCommandWriteUpdate<Steps>();
+	first.server.onExtendedCommandWriteUpdate<Steps>();
+	ASSERT_EQ(first.output, "\r\n+STEPS:even\r\n\r\n+STEPS:odd\r\n\r\nOK\r\n");
+	ASSERT_EQ(second.output, "\r\n+STEPS:even\r\n\r\n+STEPS:odd\r\n");
+
+	second.server.onExtendedCommandWriteUpdate<Steps>();
+	ASSERT_EQ(second.output, "\r\n+STEPS:even\r\n\r\n+STEPS:odd\r\n\r\n+STEPS:even\r\n\r\nOK\r\n");
+}
+
+TEST(Coroutine, AbortCancels) {
+	Steps::Definition::cancelled = 0;
+	TestSession<CoroutineSettings> session;
+	session.feed("AT+STEPS=5\r");
+	session.server.onExtendedCommandWriteUpdate<Steps>();
+	session.server.feed('A', true);
+	ASSERT_EQ(session.output, "\r\n+STEPS:even\r\n\r\nERROR\r\n");
+
+	// The frame is released
+	session.output.clear();
+	session.feed("AT+STEPS?;W\r");
+	session.server.onBasicCommandExecUpdate<W>();
+	ASSERT_EQ(session.output, "\r\n+STEPS:1\r\n\r\nOK\r\n");
+}
+
+TEST(Coroutine, FrameDoesNotFit) {
+	TestSession<TinyFrameSettings> session;
+	session.feed("AT+STEPS=1\r");
+	ASSERT_EQ(session.output, "\r\nERROR\r\n");
+}
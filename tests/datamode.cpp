@@ -0,0 +1,275 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+// Receives the given number of bytes
+struct Upload : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "UPL";
+
+		struct Size : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{1, 4096}};
+		};
+
+		using Parameters = ParameterList<Size>;
+		using DataSize = Size;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			if (server_handle.getCallType() == WriteServerHandle::CALL_TYPE::REQUEST)
+			{
+				return atcmd::RESULT_CODE::CONNECT;
+			}
+			std::string text = "+UPL:" + std::to_string(payload.size());
+			server_handle.makeInformationText().printText(text.c_str());
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static void onData(WriteServerHandle /*server_handle*/, std::span<const uint8_t> data)
+		{
+			payload.append(data.begin(), data.end());
+			chunks++;
+		}
+
+		static inline std::string payload;
+		static inline uint32_t chunks = 0;
+	};
+};
+
+// Receives bytes up to the escape sequence
+struct Raw : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "RAW";
+		static constexpr char data_escape[] = "+++";
+
+		struct Channel : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 9}};
+		};
+
+		using Parameters = ParameterList<Channel>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			return server_handle.getCallType() == WriteServerHandle::CALL_TYPE::REQUEST ?
+					atcmd::RESULT_CODE::CONNECT :
+					atcmd::RESULT_CODE::OK;
+		}
+
+		static void onData(WriteServerHandle /*server_handle*/, std::span<const uint8_t> data)
+		{
+			payload.append(data.begin(), data.end());
+		}
+
+		static inline std::string payload;
+	};
+};
+
+// Receives bytes up to an escape sequence that overlaps itself
+struct Log : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "LOG";
+		static constexpr char data_escape[] = "--=";
+
+		struct Channel : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 9}};
+		};
+
+		using Parameters = ParameterList<Channel>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			return server_handle.getCallType() == WriteServerHandle::CALL_TYPE::REQUEST ?
+					atcmd::RESULT_CODE::CONNECT :
+					atcmd::RESULT_CODE::OK;
+		}
+
+		static void onData(WriteServerHandle /*server_handle*/, std::span<const uint8_t> data)
+		{
+			payload.append(data.begin(), data.end());
+		}
+
+		static inline std::string payload;
+	};
+};
+
+// Sums the payload bytes in its state
+struct Checksum : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "SUM";
+
+		struct AsyncState
+		{
+			uint32_t sum;
+		};
+
+		struct Size : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{1, 255}};
+		};
+
+		using Parameters = ParameterList<Size>;
+		using DataSize = Size;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle, AsyncState& state)
+		{
+			if (server_handle.getCallType() == WriteServerHandle::CALL_TYPE::REQUEST)
+			{
+				return atcmd::RESULT_CODE::CONNECT;
+			}
+			std::string text = "+SUM:" + std::to_string(state.sum);
+			server_handle.makeInformationText().printText(text.c_str());
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static void onData(WriteServerHandle server_handle, std::span<const uint8_t> data, AsyncState& state)
+		{
+			EXPECT_EQ(server_handle.getCallType(), WriteServerHandle::CALL_TYPE::DATA);
+			for (uint8_t byte : data)
+			{
+				state.sum += byte;
+			}
+		}
+	};
+};
+
+struct DataModeSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Upload, Raw, Log, Checksum>;
+
+	static constexpr std::size_t max_commands_per_line = 2;
+};
+
+class DataModeTest : public ServerFixture<DataModeSettings>
+{
+protected:
+	void SetUp() override
+	{
+		ServerFixture::SetUp();
+		Upload::Definition::payload.clear();
+		Upload::Definition::chunks = 0;
+		Raw::Definition::payload.clear();
+		Log::Definition::payload.clear();
+	}
+};
+
+TEST_F(DataModeTest, SizedPayloadInChunks) {
+	feed("AT+UPL=10\r");
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n");
+
+	// Passed in place, one chunk per block, the rest of the block is parsed again
+	feed("0123");
+	feed("456789AT\r");
+	ASSERT_EQ(Upload::Definition::payload, "0123456789");
+	ASSERT_EQ(Upload::Definition::chunks, 2u);
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n\r\n+UPL:10\r\n\r\nOK\r\n\r\nOK\r\n");
+}
+
+TEST_F(DataModeTest, RawBytesAreNotEchoed) {
+	m_server.getCommunicationParameters().setEchoEnabled(true);
+	feed("AT+UPL=4\r");
+	m_output.clear();
+
+	const char payload[] = {'a', '\r', '\0', 'b'};
+	for (char ch : payload)
+	{
+		m_server.feed(ch);
+	}
+	ASSERT_EQ(Upload::Definition::payload, std::string(payload, sizeof(payload)));
+	ASSERT_EQ(m_output, "\r\n+UPL:4\r\n\r\nOK\r\n");
+}
+
+TEST_F(DataModeTest, EscapeSequence) {
+	feed("AT+RAW=1\r");
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n");
+
+	// Partial matches of the escape sequence are payload, also across blocks
+	feed("ab+");
+	feed("+c++");
+	ASSERT_EQ(Raw::Definition::payload, "ab++c");
+	feed("+AT\r");
+	ASSERT_EQ(Raw::Definition::payload, "ab++c");
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n\r\nOK\r\n\r\nOK\r\n");
+}
+
+TEST_F(DataModeTest, SelfOverlappingEscapeSequence) {
+	feed("AT+LOG=0\r");
+
+	// The broken partial match "--" still ends with the start of the escape
+	feed("x---=");
+	ASSERT_EQ(Log::Definition::payload, "x-");
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n\r\nOK\r\n");
+
+	feed("AT+LOG=0\r");
+	feed("--");
+	feed("-");
+	feed("-=");
+	ASSERT_EQ(Log::Definition::payload, "x---");
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n\r\nOK\r\n\r\nCONNECT\r\n\r\nOK\r\n");
+}
+
+TEST_F(DataModeTest, LineGoesOn) {
+	feed("AT+UPL=2;+RAW=0\r");
+	feed("xyz+++");
+	ASSERT_EQ(Upload::Definition::payload, "xy");
+	ASSERT_EQ(Raw::Definition::payload, "z");
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n\r\n+UPL:2\r\n\r\nCONNECT\r\n\r\nOK\r\n");
+}
+
+TEST_F(DataModeTest, StatefulHandler) {
+	feed("AT+SUM=3\r");
+	feed(std::string("\x01\x02\x03", 3));
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n\r\n+SUM:6\r\n\r\nOK\r\n");
+}
+
+TEST_F(DataModeTest, UpdatesWaitForThePayload) {
+	feed("AT+UPL=2\r");
+	m_server.onExtendedCommandWriteUpdate<Upload>();
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n");
+	feed("12");
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n\r\n+UPL:2\r\n\r\nOK\r\n");
+}
@@ -0,0 +1,174 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <atcmd/client/line.h>
+#include <atcmd/responseparser.h>
+#include <atcmd/server/script.h>
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+struct Radio : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "RADIO";
+
+		// "ON" is a prefix of "ONCE"
+		struct Mode : public EnumParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr const char* values[] = {"ON", "OFF", "AUTO", "ONCE"};
+		};
+
+		struct Band : public EnumParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr const char* values[] = {"B1", "B3", "B20"};
+			static constexpr uint8_t default_value = 1;
+		};
+
+		using Parameters = ParameterList<Mode, Band>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			l_log += "W" + std::to_string(parameters.getEnum<Mode>()) + "," +
+					std::to_string(parameters.getEnum<Band>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeParameterInformationText<Parameters>(name)
+					.printEnumParameter<Mode>(printed_mode)
+					.printEnumParameter<Band>(2);
+			server_handle.printInformationText<Parameters, "+RADIO:\"{}\",\"{}\"">(formatted_mode, uint8_t{0});
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static const char* onTest(TestServerHandle /*server_handle*/)
+		{
+			return name;
+		}
+
+		static inline uint8_t printed_mode = 2;
+		static inline uint8_t formatted_mode = 3;
+	};
+};
+
+struct EnumSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Radio>;
+
+	static constexpr std::size_t max_commands_per_line = 2;
+};
+
+class EnumTest : public ServerFixture<EnumSettings>
+{
+protected:
+	void run(const std::string& text)
+	{
+		l_log.clear();
+		m_output.clear();
+		feed(text);
+	}
+};
+
+TEST_F(EnumTest, Write) {
+	run("AT+RADIO=\"auto\",\"B20\"\r");
+	ASSERT_EQ(l_log, "W2,2;");
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+
+	// A keyword and its prefix, the default value
+	run("AT+RADIO=\"ONCE\";+RADIO=\"On\",\r");
+	ASSERT_EQ(l_log, "W3,1;W0,1;");
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+}
+
+TEST_F(EnumTest, UnknownValue) {
+	for (const char* line : {"AT+RADIO=\"ONX\"\r", "AT+RADIO=\"O\"\r", "AT+RADIO=\"\"\r", "AT+RADIO=ON\r",
+			"AT+RADIO=\"OFF\",\"B2\"\r", "AT+RADIO=,\"B1\"\r"})
+	{
+		run(line);
+		ASSERT_EQ(l_log, "") << line;
+		ASSERT_EQ(m_output, "\r\nERROR\r\n") << line;
+	}
+
+	// The server goes on
+	run("AT+RADIO=\"OFF\",\"b1\"\r");
+	ASSERT_EQ(l_log, "W1,0;");
+}
+
+TEST_F(EnumTest, TestAndRead) {
+	run("AT+RADIO=?\r");
+	ASSERT_EQ(m_output, "\r\n+RADIO:(\"ON\",\"OFF\",\"AUTO\",\"ONCE\"),(\"B1\",\"B3\",\"B20\")\r\n\r\nOK\r\n");
+
+	run("AT+RADIO?\r");
+	ASSERT_EQ(m_output, "\r\n+RADIO:\"AUTO\",\"B20\"\r\n\r\n+RADIO:\"ONCE\",\"B1\"\r\n\r\nOK\r\n");
+}
+
+TEST_F(EnumTest, IndexOutOfRange) {
+	// Asserted in debug builds, an empty keyword is printed otherwise
+	Radio::Definition::printed_mode = 4;
+	EXPECT_DEBUG_DEATH(run("AT+RADIO?\r"), "out of range");
+	Radio::Definition::printed_mode = 2;
+#ifdef NDEBUG
+	ASSERT_EQ(m_output, "\r\n+RADIO:\"\",\"B20\"\r\n\r\n+RADIO:\"ONCE\",\"B1\"\r\n\r\nOK\r\n");
+#endif
+
+	Radio::Definition::formatted_mode = 4;
+	EXPECT_DEBUG_DEATH(run("AT+RADIO?\r"), "out of range");
+	Radio::Definition::formatted_mode = 3;
+#ifdef NDEBUG
+	ASSERT_EQ(m_output, "\r\n+RADIO:\"AUTO\",\"B20\"\r\n\r\n+RADIO:\"\",\"B1\"\r\n\r\nOK\r\n");
+#endif
+}
+
+TEST_F(EnumTest, ScriptAndClient) {
+	static constexpr auto script = atcmd::server::makeScript<EnumSettings, "AT+RADIO=\"once\";+RADIO=\"OFF\",\"B20\"">();
+	ASSERT_TRUE(m_server.execScript(script));
+	ASSERT_EQ(l_log, "W3,1;W1,2;");
+
+	// The client sends the keyword by its index and decodes it back
+	atcmd::client::Line line;
+	line.write<Radio>(2, 0);
+	ASSERT_TRUE(line.isValid());
+	ASSERT_EQ(line.getText(), "AT+RADIO=\"AUTO\",\"B1\"");
+	ASSERT_FALSE(atcmd::client::Line().write<Radio>(4).isValid());
+
+	atcmd::ResponseParser<Radio> parser;
+	std::string_view response = "\r\n+RADIO:\"AUTO\",\"B20\"\r\n";
+	parser.feed(response.data(), response.size());
+	ASSERT_TRUE(parser.hasLine());
+	ASSERT_TRUE(parser.hasFields());
+	ASSERT_EQ(parser.getEnum<Radio::Definition::Mode>(), 2);
+	ASSERT_EQ(parser.getEnum<Radio::Definition::Band>(), 2);
+}
@@ -0,0 +1,232 @@
+/**
+* Copyright © 2026 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <pty.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atcmd/host/epolltransport.h>
+#include <atcmd/host/threadpool.h>
+
+struct Ping : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "PING";
+
+		struct Value : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 255}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeParameterInformationText<Parameters>(name)
+					.printNumericParameter<Value>(1);
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Flash : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "FLASH";
+		static constexpr bool offloadable = true;
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle /*server_handle*/)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct TransportSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Ping, Flash>;
+
+	static constexpr std::size_t max_commands_per_line = 2;
+	static constexpr std::size_t completion_queue_size = 4;
+};
+
+using Transport = atcmd::host::EpollTransport<TransportSettings>;
+
+static constexpr char l_response[] = "\r\n+PING:1\r\n\r\nOK\r\n";
+
+static void writeAll(int fd, const std::string& data)
+{
+	ASSERT_EQ(write(fd, data.data(), data.size()), static_cast<ssize_t>(data.size()));
+}
+
+// Runs the loop until the expected number of bytes is read from the peer
+static std::string readResponse(Transport& transport, int fd, std::size_t size)
+{
+	std::string r;
+	for (int i = 0; (i < 1000) && (r.size() < size); i++)
+	{
+		transport.poll(1);
+		char buf[256];
+		ssize_t n = read(fd, buf, sizeof(buf));
+		if (n > 0)
+		{
+			r.append(buf, static_cast<std::size_t>(n));
+		}
+	}
+	return r;
+}
+
+static int addSocket(Transport& transport, int& peer)
+{
+	int fds[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+	{
+		return -1;
+	}
+	fcntl(fds[1], F_SETFL, O_NONBLOCK);
+	peer = fds[1];
+	int index = transport.add(fds[0]);
+	transport.getSession(index).getCommunicationParameters().setEchoEnabled(false);
+	return index;
+}
+
+TEST(EpollTransport, Socket) {
+	Transport transport;
+	ASSERT_TRUE(transport.isValid());
+	int peer;
+	ASSERT_EQ(addSocket(transport, peer), 0);
+
+	// A line split over several reads
+	writeAll(peer, "AT+PI");
+	transport.poll(0);
+	writeAll(peer, "NG?\r");
+	ASSERT_EQ(readResponse(transport, peer, sizeof(l_response) - 1), l_response);
+
+	// Several lines in a single read
+	writeAll(peer, "AT+PING?\rAT+PING?\r");
+	ASSERT_EQ(readResponse(transport, peer, 2 * (sizeof(l_response) - 1)), std::string(l_response) + l_response);
+
+	close(peer);
+	transport.poll(0);
+	ASSERT_FALSE(transport.isOpen(0));
+}
+
+TEST(EpollTransport, ManySockets) {
+	static constexpr std::size_t count = 200;
+
+	Transport transport;
+	std::vector<int> peers(count);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		ASSERT_EQ(addSocket(transport, peers[i]), static_cast<int>(i));
+	}
+	for (int peer : peers)
+	{
+		writeAll(peer, "AT+PING?;+PING?\r");
+	}
+	for (int peer : peers)
+	{
+		ASSERT_EQ(readResponse(transport, peer, 21), "\r\n+PING:1\r\n\r\n+PING:1\r\n\r\nOK\r\n");
+		close(peer);
+	}
+}
+
+TEST(EpollTransport, Pty) {
+	Transport transport;
+	int master;
+	int slave;
+	termios attributes;
+	ASSERT_EQ(openpty(&master, &slave, nullptr, nullptr, nullptr), 0);
+	ASSERT_EQ(tcgetattr(slave, &attributes), 0);
+	cfmakeraw(&attributes);
+	ASSERT_EQ(tcsetattr(slave, TCSANOW, &attributes), 0);
+	fcntl(slave, F_SETFL, O_NONBLOCK);
+
+	int index = transport.add(master, true);
+	ASSERT_EQ(index, 0);
+
+	// Echo is on by default
+	writeAll(slave, "AT+PING?\r");
+	ASSERT_EQ(readResponse(transport, slave, 9 + sizeof(l_response) - 1), std::string("AT+PING?\r") + l_response);
+	close(slave);
+}
+
+TEST(EpollTransport, EmulatedPort) {
+	Transport transport;
+	std::string name;
+	int index = transport.addPty(&name);
+	ASSERT_EQ(index, 0);
+	transport.getSession(index).getCommunicationParameters().setEchoEnabled(false);
+
+	int port = open(name.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	ASSERT_GE(port, 0);
+	writeAll(port, "AT+PING?\r");
+	ASSERT_EQ(readResponse(transport, port, sizeof(l_response) - 1), l_response);
+	close(port);
+}
+
+TEST(EpollTransport, OffloadedHandlerWakesLoop) {
+	Transport transport;
+	atcmd::host::ThreadPool pool(1);
+	int peer;
+	ASSERT_EQ(addSocket(transport, peer), 0);
+	transport.getSession(0).setExecutor(atcmd::host::ThreadPool::execute, &pool);
+
+	// The input following the offloaded line waits without the loop polling
+	static constexpr char expected[] = "\r\nOK\r\n\r\n+PING:1\r\n\r\nOK\r\n";
+	writeAll(peer, "AT+FLASH?\rAT+PING?\r");
+	auto start = std::chrono::steady_clock::now();
+	std::string r;
+	while (r.size() < sizeof(expected) - 1)
+	{
+		ASSERT_TRUE(transport.poll(5000));
+		char buf[64];
+		ssize_t n = read(peer, buf, sizeof(buf));
+		if (n > 0)
+		{
+			r.append(buf, static_cast<std::size_t>(n));
+		}
+	}
+	ASSERT_EQ(r, expected);
+	ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+	close(peer);
+}
@@ -0,0 +1,293 @@
+/**
+* Copyright © 2026 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <atcmd/server/server.h>
+#include <atcmd/host/threadpool.h>
+
+#include "testsession.h"
+
+static std::thread::id l_server_thread;
+static bool l_printed_elsewhere = false;
+
+static void printCharOnServerThread(char ch, void* context)
+{
+	printChar(ch, context);
+	l_printed_elsewhere |= std::this_thread::get_id() != l_server_thread;
+}
+
+struct Slow : public atcmd::server::ExtendedCommand
+{
+	// Blocks for the given number of milliseconds, zero fails
+	struct Definition
+	{
+		static constexpr char name[] = "SLOW";
+		static constexpr bool offloadable = true;
+
+		struct Delay : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 1000}};
+		};
+
+		using Parameters = ParameterList<Delay>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			thread_id = std::this_thread::get_id();
+			uint32_t delay = parameters.getNumeric<Delay>();
+			if (delay == 0)
+			{
+				return atcmd::RESULT_CODE::ERROR;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+			value = delay;
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			thread_id = std::this_thread::get_id();
+			server_handle.makeParameterInformationText<Parameters>(name, true)
+					.printNumericParameter<Delay>(value);
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static inline uint32_t value = 0;
+		static inline std::thread::id thread_id;
+	};
+};
+
+struct Fast : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "FAST";
+
+		struct Value : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 255}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeParameterInformationText<Parameters>(name)
+					.printNumericParameter<Value>(1);
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Dial : public atcmd::server::ExtendedCommand
+{
+	// Blocks while dialing, the call is then connected asynchronously
+	struct Definition
+	{
+		static constexpr char name[] = "DIAL";
+		static constexpr bool offloadable = true;
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			if (server_handle.getCallType() == ReadServerHandle::CALL_TYPE::ABORT)
+			{
+				return atcmd::RESULT_CODE::NO_CARRIER;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			return atcmd::RESULT_CODE::ASYNC;
+		}
+	};
+};
+
+struct ExecutorSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Slow, Fast, Dial>;
+
+	static constexpr std::size_t max_commands_per_line = 8;
+	static constexpr std::size_t completion_queue_size = 8;
+};
+
+class ExecutorTest : public ServerFixture<ExecutorSettings, printCharOnServerThread>
+{
+protected:
+	void SetUp() override
+	{
+		ServerFixture::SetUp();
+		l_server_thread = std::this_thread::get_id();
+		l_printed_elsewhere = false;
+		Slow::Definition::value = 0;
+	}
+
+	void wait()
+	{
+		while (m_server.isOffloaded())
+		{
+			m_server.processCompletions();
+			std::this_thread::yield();
+		}
+	}
+
+	std::string runInline(std::string_view line)
+	{
+		m_server.setExecutor(nullptr);
+		feed(line);
+		std::string output = m_output;
+		m_output.clear();
+		Slow::Definition::value = 0;
+		return output;
+	}
+
+	atcmd::host::ThreadPool m_pool{2};
+};
+
+TEST(ThreadPool, RunsAllJobs) {
+	static constexpr std::size_t job_count = 10000;
+
+	struct Context
+	{
+		atcmd::host::ThreadPool* pool;
+		std::atomic<std::size_t> done;
+	};
+
+	atcmd::host::ThreadPool pool(4);
+	Context context{&pool, 0};
+	for (std::size_t i = 0; i < job_count / 2; i++)
+	{
+		// Every job submits another one from the worker thread
+		pool.submit([](void* arg) {
+			Context* context = static_cast<Context*>(arg);
+			context->pool->submit([](void* arg) {
+				static_cast<Context*>(arg)->done.fetch_add(1);
+			}, arg);
+			context->done.fetch_add(1);
+		}, &context);
+	}
+	while (context.done.load() != job_count)
+	{
+		std::this_thread::yield();
+	}
+}
+
+TEST_F(ExecutorTest, InlineWithoutExecutor) {
+	feed("AT+SLOW=1;+SLOW?\r");
+	ASSERT_FALSE(m_server.isOffloaded());
+	ASSERT_EQ(m_output, "\r\n+SLOW:1\r\n\r\nOK\r\n");
+	ASSERT_EQ(Slow::Definition::thread_id, std::this_thread::get_id());
+}
+
+TEST_F(ExecutorTest, SameResponsesAsInline) {
+	static constexpr const char* line = "AT+SLOW?;+FAST?;+SLOW=5;+FAST?;+SLOW?\r";
+	std::string expected = runInline(line);
+
+	m_server.setExecutor(atcmd::host::ThreadPool::execute, &m_pool);
+	feed(line);
+	ASSERT_TRUE(m_server.isOffloaded());
+	wait();
+	ASSERT_EQ(m_output, expected);
+	ASSERT_NE(Slow::Definition::thread_id, std::this_thread::get_id());
+	ASSERT_FALSE(l_printed_elsewhere);
+}
+
+TEST_F(ExecutorTest, ErrorStopsLine) {
+	static constexpr const char* line = "AT+FAST?;+SLOW=0;+FAST?\r";
+	std::string expected = runInline(line);
+	ASSERT_EQ(expected, "\r\n+FAST:1\r\n\r\nERROR\r\n");
+
+	m_server.setExecutor(atcmd::host::ThreadPool::execute, &m_pool);
+	feed(line);
+	wait();
+	ASSERT_EQ(m_output, expected);
+}
+
+TEST_F(ExecutorTest, InputDroppedWhileOffloaded) {
+	m_server.setExecutor(atcmd::host::ThreadPool::execute, &m_pool);
+	feed("AT+SLOW=20\r");
+	// Characters fed one at a time are dropped while the line is offloaded
+	for (char ch : std::string_view("AT+FAST?\r"))
+	{
+		m_server.feed(ch);
+	}
+	wait();
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+
+	feed("AT+SLOW?\r");
+	wait();
+	ASSERT_EQ(m_output, "\r\nOK\r\n\r\n+SLOW:20\r\n\r\nOK\r\n");
+}
+
+TEST_F(ExecutorTest, WakeCallbackAfterHandler) {
+	static std::atomic<int> wakes = 0;
+	m_server.setExecutor(atcmd::host::ThreadPool::execute, &m_pool);
+	m_server.setWakeCallback([](void* /*context*/) { wakes.fetch_add(1); });
+	feed("AT+SLOW=5\r");
+	while (wakes.load() == 0)
+	{
+		std::this_thread::yield();
+	}
+	ASSERT_TRUE(m_server.isOffloaded());
+	ASSERT_TRUE(m_output.empty());
+
+	m_server.processCompletions();
+	ASSERT_FALSE(m_server.isOffloaded());
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+	ASSERT_EQ(wakes.load(), 1);
+}
+
+TEST_F(ExecutorTest, AbortableCharacterWhileOffloaded) {
+	m_server.setExecutor(atcmd::host::ThreadPool::execute, &m_pool);
+	feed("AT+DIAL?\r");
+	ASSERT_TRUE(m_server.isOffloaded());
+	m_server.feed('A', true);
+	wait();
+	ASSERT_EQ(m_output, "\r\nNO CARRIER\r\n");
+}
+
+TEST_F(ExecutorTest, QueuedJobRunWhenPoolDestroyed) {
+	{
+		atcmd::host::ThreadPool pool(1);
+		// Keeps the only worker busy, so the handler is still queued when the pool is destroyed
+		pool.submit([](void* /*arg*/) { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }, nullptr);
+		m_server.setExecutor(atcmd::host::ThreadPool::execute, &pool);
+		feed("AT+SLOW=5\r");
+	}
+	m_server.setExecutor(nullptr);
+	m_server.processCompletions();
+	ASSERT_FALSE(m_server.isOffloaded());
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+}
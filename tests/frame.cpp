@@ -0,0 +1,221 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+#include <atcmd/server/frame.h>
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+struct Tune : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "TUNE";
+
+		struct Level : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 100}};
+		};
+
+		struct Label : public StringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_length = 4;
+			static constexpr const char* default_value = "X";
+		};
+
+		struct Key : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_size = 2;
+			static constexpr uint8_t default_value[] = {0xAB};
+		};
+
+		struct Power : public EnumParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr const char* values[] = {"LOW", "HIGH"};
+			static constexpr uint8_t default_value = 0;
+		};
+
+		using Parameters = ParameterList<Level, Label, Key, Power>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			l_log += "W" + std::to_string(parameters.getNumeric<Level>()) + "," + parameters.getString<Label>() + ",";
+			for (uint8_t byte : parameters.getHexString<Key>())
+			{
+				l_log += std::to_string(byte) + " ";
+			}
+			l_log += std::to_string(parameters.getEnum<Power>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static const char* onTest(TestServerHandle /*server_handle*/)
+		{
+			return name;
+		}
+	};
+};
+
+struct Probe : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "PROBE";
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeInformationText().printText("+PROBE:1");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct FrameSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Tune, Probe>;
+
+	static constexpr std::size_t max_commands_per_line = 3;
+};
+
+using FrameEncoder = atcmd::server::FrameEncoder<FrameSettings>;
+
+class FrameTest : public ServerFixture<FrameSettings>
+{
+protected:
+	void run(std::span<const uint8_t> frame)
+	{
+		l_log.clear();
+		m_output.clear();
+		ASSERT_TRUE(m_server.execFrame(frame));
+	}
+};
+
+TEST_F(FrameTest, SameAsParsed) {
+	static constexpr uint8_t key[] = {0x01, 0x02};
+	std::array<uint8_t, 64> buffer;
+	FrameEncoder encoder(buffer);
+	encoder.write<Tune>(7, "ab", key, 1).read<Probe>().write<Tune>(100);
+	ASSERT_TRUE(encoder.isValid());
+
+	// The layout of the command line, as filled by the parser
+	static constexpr auto script =
+			atcmd::server::makeScript<FrameSettings, "AT+TUNE=7,\"ab\",\"0102\",\"HIGH\";+PROBE?;+TUNE=100">();
+	ASSERT_EQ(std::vector<uint8_t>(encoder.getFrame().begin(), encoder.getFrame().end()),
+			std::vector<uint8_t>(script.data.begin(), script.data.end()));
+
+	run(encoder.getFrame());
+	ASSERT_EQ(l_log, "W7,ab,1 2 1;W100,X,171 0;");
+	ASSERT_EQ(m_output, "\r\n+PROBE:1\r\n\r\nOK\r\n");
+}
+
+TEST_F(FrameTest, TestCommand) {
+	std::array<uint8_t, 8> buffer;
+	run(FrameEncoder(buffer).test<Tune>().getFrame());
+	ASSERT_EQ(m_output, "\r\n+TUNE:(0-100),(s:4),(hs:2),(\"LOW\",\"HIGH\")\r\n\r\nOK\r\n");
+}
+
+TEST_F(FrameTest, InvalidCommands) {
+	std::array<uint8_t, 64> buffer;
+	FrameEncoder encoder(buffer);
+	encoder.write<Tune>(1);
+	std::vector<uint8_t> valid(encoder.getFrame().begin(), encoder.getFrame().end());
+
+	// The offsets of Level, Label, Key with its size and Power after the command id
+	std::vector<std::vector<uint8_t>> frames;
+	frames.push_back(valid);
+	frames.back()[2] = 101;
+	frames.push_back(valid);
+	std::fill_n(&frames.back()[6], 5, 'A');
+	frames.push_back(valid);
+	frames.back()[11 + 2] = 3;
+	frames.push_back(valid);
+	frames.back()[15] = 2;
+	frames.push_back({valid.begin(), valid.end() - 1});
+	// A read of a write-only command, a write of a read-only one, a read of a command that is not there
+	frames.push_back({0x00, 0x00});
+	frames.push_back({0x05, 0x00});
+	frames.push_back({0x08, 0x00});
+	frames.push_back({0x07});
+
+	for (std::size_t i = 0; i < frames.size(); i++)
+	{
+		// The valid command before is run
+		std::vector<uint8_t> frame = valid;
+		frame.insert(frame.end(), frames[i].begin(), frames[i].end());
+		run(frame);
+		ASSERT_EQ(l_log, "W1,X,171 0;") << i;
+		ASSERT_EQ(m_output, "\r\nERROR\r\n") << i;
+	}
+
+	// Too many commands for the command line buffer
+	frames.clear();
+	std::vector<uint8_t> frame;
+	for (std::size_t i = 0; i < 4; i++)
+	{
+		frame.insert(frame.end(), valid.begin(), valid.end());
+	}
+	run(frame);
+	ASSERT_EQ(l_log, "W1,X,171 0;W1,X,171 0;W1,X,171 0;");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+}
+
+TEST_F(FrameTest, Encoder) {
+	std::array<uint8_t, 64> buffer;
+	ASSERT_FALSE(FrameEncoder(buffer).write<Tune>(101).isValid());
+	ASSERT_FALSE(FrameEncoder(buffer).write<Tune>(1, "abcde").isValid());
+	ASSERT_FALSE(FrameEncoder(buffer).write<Tune>(1, std::nullopt, std::nullopt, 2).isValid());
+	ASSERT_TRUE(FrameEncoder(buffer).write<Tune>(1, std::nullopt, std::nullopt, 1).isValid());
+
+	// The buffer is too small
+	std::array<uint8_t, 8> small;
+	ASSERT_FALSE(FrameEncoder(small).write<Tune>(1).isValid());
+}
+
+TEST_F(FrameTest, WaitsForTheLine) {
+	std::array<uint8_t, 8> buffer;
+	FrameEncoder encoder(buffer);
+	encoder.read<Probe>();
+
+	m_server.feed("AT+PRO", 6);
+	ASSERT_FALSE(m_server.execFrame(encoder.getFrame()));
+	m_server.feed("BE?\r", 4);
+	m_output.clear();
+	run(encoder.getFrame());
+	ASSERT_EQ(m_output, "\r\n+PROBE:1\r\n\r\nOK\r\n");
+}
@@ -0,0 +1,203 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <atcmd/server/server.h>
+#include <atcmd/server/macrocommand.h>
+
+#include "testsession.h"
+
+struct Status : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "STAT";
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			l_log += "STAT;";
+			server_handle.makeInformationText().printText("+STAT:1");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Level : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "LVL";
+
+		struct Value : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 9}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			l_log += "LVL" + std::to_string(Parameters(server_handle).getNumeric<Value>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+// Its text is passed in chunks while the line is parsed
+struct Note : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "NOTE";
+
+		struct Text : public StringParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr uint32_t max_length = 64;
+			static constexpr uint16_t chunk_size = 4;
+		};
+
+		using Parameters = ParameterList<Text>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle /*server_handle*/)
+		{
+			l_log += "NOTE;";
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static void onData(WriteServerHandle /*server_handle*/, std::span<const uint8_t> /*data*/)
+		{}
+	};
+};
+
+struct MacroSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Status, Level, Note, atcmd::server::MacroCommand<MacroSettings>>;
+
+	static constexpr std::size_t max_commands_per_line = 4;
+	static constexpr std::size_t macro_slot_count = 3;
+	static constexpr std::size_t macro_max_size = 16;
+};
+
+using MacroServer = atcmd::server::Server<MacroSettings>;
+
+using MacroTest = ServerFixture<MacroSettings>;
+
+TEST_F(MacroTest, StoresTheReceivedLine) {
+	feed("AT+STAT?;+LVL=3\r");
+	ASSERT_TRUE(m_server.storeMacro(1));
+	ASSERT_TRUE(m_server.isMacroStored(1));
+	ASSERT_FALSE(m_server.isMacroStored(0));
+	l_log.clear();
+	m_output.clear();
+
+	ASSERT_TRUE(m_server.execMacro(1));
+	ASSERT_EQ(l_log, "STAT;LVL3;");
+	ASSERT_EQ(m_output, "\r\n+STAT:1\r\n\r\nOK\r\n");
+
+	// A/ repeats the replayed line
+	feed("A/");
+	ASSERT_EQ(l_log, "STAT;LVL3;STAT;LVL3;");
+
+	m_server.clearMacro(1);
+	ASSERT_FALSE(m_server.execMacro(1));
+}
+
+TEST_F(MacroTest, RejectsFailedAndOversizedLines) {
+	feed("AT+LVL=10\r");
+	ASSERT_FALSE(m_server.storeMacro(0));
+
+	// 3 writes of 6 bytes each
+	feed("AT+LVL=1;+LVL=2;+LVL=3\r");
+	ASSERT_FALSE(m_server.storeMacro(0));
+	ASSERT_FALSE(m_server.storeMacro(3));
+
+	// The streamed text is not kept in the line
+	feed("AT+NOTE=\"abc\"\r");
+	ASSERT_FALSE(m_server.storeMacro(0));
+
+	// Not while a line is received
+	feed("AT+LVL=1");
+	ASSERT_FALSE(m_server.storeMacro(0));
+	ASSERT_FALSE(m_server.execMacro(0));
+}
+
+TEST_F(MacroTest, ScriptsAndOtherServers) {
+	static constexpr auto script = atcmd::server::makeScript<MacroSettings, "AT+LVL=7;+STAT?">();
+	ASSERT_TRUE(m_server.storeMacro(2, script));
+
+	std::string output;
+	MacroServer other{printChar, &output};
+	ASSERT_TRUE(other.storeMacro(0, m_server, 2));
+	ASSERT_FALSE(other.storeMacro(1, m_server, 0));
+	ASSERT_TRUE(other.execMacro(0));
+	ASSERT_EQ(l_log, "LVL7;STAT;");
+	ASSERT_EQ(output, "\r\n+STAT:1\r\n\r\nOK\r\n");
+}
+
+TEST_F(MacroTest, Command) {
+	// The rest of the line is stored instead of executed
+	feed("AT+LVL=1;+MACRO=0;+LVL=2;+STAT?\r");
+	ASSERT_EQ(l_log, "LVL1;");
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+	l_log.clear();
+	m_output.clear();
+
+	feed("AT+MACRO?\r");
+	ASSERT_EQ(m_output, "\r\n+MACRO:0\r\n\r\nOK\r\n");
+	m_output.clear();
+
+	// Expanded in place of the command, before the rest of the line
+	feed("AT+MACRO=0,1;+LVL=5\r");
+	ASSERT_EQ(l_log, "LVL2;STAT;LVL5;");
+	ASSERT_EQ(m_output, "\r\n+STAT:1\r\n\r\nOK\r\n");
+	l_log.clear();
+	m_output.clear();
+
+	feed("AT+MACRO=1,1\r");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+	m_output.clear();
+
+	feed("AT+MACRO=3\r");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+	m_output.clear();
+
+	feed("AT+MACRO=?\r");
+	ASSERT_EQ(m_output, "\r\n+MACRO:(0-2),(0-1)\r\n\r\nOK\r\n");
+	m_output.clear();
+
+	feed("AT+MACRO=1;+NOTE=\"abc\"\r");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+	ASSERT_FALSE(m_server.isMacroStored(1));
+	ASSERT_EQ(l_log, "");
+}
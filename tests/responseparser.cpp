@@ -0,0 +1,243 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <atcmd/responseparser.h>
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+struct Report : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "REP";
+
+		struct Level : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 100000}};
+		};
+
+		struct Label : public StringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_length = 8;
+			static constexpr const char* default_value = "";
+		};
+
+		struct Key : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_size = 4;
+			static constexpr uint8_t default_value[] = {0x00};
+		};
+
+		struct Mask : public HexadecimalNumericParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr Range ranges[] = {{0, 0xFFFF}};
+			static constexpr uint32_t default_value = 0;
+		};
+
+		using Parameters = ParameterList<Level, Label, Key, Mask>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			static constexpr uint8_t key[] = {0x01, 0xA2, 0xFF};
+			server_handle.makeParameterInformationText<Parameters>(name)
+					.printNumericParameter<Level>(12345)
+					.printStringParameter<Label>("a, b")
+					.printHexadecimalStringParameter<Key>(key, sizeof(key))
+					.printNumericParameter<Mask>(0xBEEF);
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct ResponseSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Report>;
+	static constexpr std::size_t max_commands_per_line = 1;
+};
+
+using Level = Report::Definition::Level;
+using Label = Report::Definition::Label;
+using Key = Report::Definition::Key;
+using Mask = Report::Definition::Mask;
+
+class ResponseParserTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		TestSession<ResponseSettings> session;
+		session.feed("AT+REP?\r");
+		m_output = session.output;
+	}
+
+	// Feeds the chunks and collects the complete lines
+	void feed(const std::vector<std::string_view>& chunks)
+	{
+		for (std::string_view chunk : chunks)
+		{
+			std::size_t offset = 0;
+			while (offset != chunk.size())
+			{
+				offset += m_parser.feed(&chunk[offset], chunk.size() - offset);
+				if (m_parser.hasLine())
+				{
+					m_lines.push_back(std::string(m_parser.getLine()));
+					if (m_parser.hasFields())
+					{
+						checkFields();
+					}
+				}
+			}
+		}
+	}
+
+	void checkFields()
+	{
+		ASSERT_TRUE(m_parser.isPresent<Level>());
+		ASSERT_EQ(m_parser.getNumeric<Level>(), 12345u);
+		ASSERT_EQ(m_parser.getString<Label>(), "a, b");
+		ASSERT_EQ(m_parser.getHexString<Key>(), "01A2FF");
+		uint8_t key[Key::max_size];
+		ASSERT_EQ(m_parser.decodeHexString<Key>(key), 3u);
+		ASSERT_EQ(key[0], 0x01);
+		ASSERT_EQ(key[1], 0xA2);
+		ASSERT_EQ(key[2], 0xFF);
+		ASSERT_EQ(m_parser.getNumeric<Mask>(), 0xBEEFu);
+		m_matched++;
+	}
+
+	std::string m_output;
+	atcmd::ResponseParser<Report> m_parser;
+	std::vector<std::string> m_lines;
+	std::size_t m_matched = 0;
+};
+
+TEST_F(ResponseParserTest, InPlace) {
+	ASSERT_EQ(m_output, "\r\n+REP:12345,\"a, b\",\"01A2FF\",BEEF\r\n\r\nOK\r\n");
+	std::size_t offset = m_parser.feed(m_output.data(), m_output.size());
+	ASSERT_TRUE(m_parser.hasFields());
+	// The fields point into the received data
+	ASSERT_EQ(m_parser.getLine().data(), &m_output[2]);
+	ASSERT_EQ(m_parser.getString<Label>().data(), &m_output[14]);
+	checkFields();
+
+	offset += m_parser.feed(&m_output[offset], m_output.size() - offset);
+	ASSERT_TRUE(m_parser.hasLine());
+	ASSERT_FALSE(m_parser.hasFields());
+	ASSERT_EQ(m_parser.getLine(), "OK");
+
+	offset += m_parser.feed(&m_output[offset], m_output.size() - offset);
+	ASSERT_EQ(offset, m_output.size());
+	ASSERT_FALSE(m_parser.hasLine());
+}
+
+TEST_F(ResponseParserTest, SplitChunks) {
+	std::string_view output = m_output;
+	for (std::size_t split = 0; split <= output.size(); split++)
+	{
+		SCOPED_TRACE(split);
+		m_lines.clear();
+		m_matched = 0;
+		feed({output.substr(0, split), output.substr(split)});
+		ASSERT_EQ(m_matched, 1u);
+		ASSERT_EQ(m_lines, (std::vector<std::string>{"+REP:12345,\"a, b\",\"01A2FF\",BEEF", "OK"}));
+	}
+
+	m_lines.clear();
+	m_matched = 0;
+	std::vector<std::string_view> bytes;
+	for (std::size_t i = 0; i < output.size(); i++)
+	{
+		bytes.push_back(output.substr(i, 1));
+	}
+	feed(bytes);
+	ASSERT_EQ(m_matched, 1u);
+	ASSERT_EQ(m_lines.size(), 2u);
+	ASSERT_EQ(m_parser.getDiscarded(), 0u);
+}
+
+TEST_F(ResponseParserTest, Fields) {
+	auto parse = [this](std::string_view line)
+	{
+		m_parser.feed(line.data(), line.size());
+		return m_parser.hasLine() && m_parser.hasFields();
+	};
+
+	// A space after the colon, the fields after the last printed one are absent
+	ASSERT_TRUE(parse("+REP: 7\n"));
+	ASSERT_EQ(m_parser.getNumeric<Level>(), 7u);
+	ASSERT_FALSE(m_parser.isPresent<Label>());
+	ASSERT_FALSE(m_parser.isPresent<Mask>());
+
+	// Empty fields
+	ASSERT_TRUE(parse("+REP:1,,\"00\",ff\n"));
+	ASSERT_FALSE(m_parser.isPresent<Label>());
+	ASSERT_TRUE(m_parser.isPresent<Key>());
+	ASSERT_EQ(m_parser.getNumeric<Mask>(), 0xFFu);
+
+	ASSERT_FALSE(parse("+REP:1,abc\n"));
+	ASSERT_FALSE(parse("+REP:1,\"abc\n"));
+	ASSERT_FALSE(parse("+REP:1,\"123456789\"\n"));
+	ASSERT_FALSE(parse("+REP:1,,\"0G\"\n"));
+	ASSERT_FALSE(parse("+REP:1,,\"012\"\n"));
+	ASSERT_FALSE(parse("+REP:1,,\"0102030405\"\n"));
+	ASSERT_FALSE(parse("+REP:1A\n"));
+	ASSERT_FALSE(parse("+REP:99999999999\n"));
+	ASSERT_FALSE(parse("+REP:1,,,1,2\n"));
+	ASSERT_FALSE(parse("+REPE:1\n"));
+	ASSERT_FALSE(parse("+RE:1\n"));
+	ASSERT_TRUE(m_parser.hasLine());
+	ASSERT_EQ(m_parser.getLine(), "+RE:1");
+}
+
+TEST_F(ResponseParserTest, Overflow) {
+	// A split line that does not fit in the buffer is skipped, a line within one chunk never is
+	std::string line(200, 'x');
+	ASSERT_EQ(m_parser.feed(line.data(), line.size()), line.size());
+	ASSERT_FALSE(m_parser.hasLine());
+	line = "yy\r\n";
+	ASSERT_EQ(m_parser.feed(line.data(), line.size()), 3u);
+	ASSERT_FALSE(m_parser.hasLine());
+	ASSERT_EQ(m_parser.getDiscarded(), 1u);
+
+	line = std::string(200, 'z') + "\r";
+	ASSERT_EQ(m_parser.feed(line.data(), line.size()), line.size());
+	ASSERT_TRUE(m_parser.hasLine());
+	ASSERT_EQ(m_parser.getLine().size(), 200u);
+
+	feed({m_output});
+	ASSERT_EQ(m_matched, 1u);
+}
@@ -0,0 +1,157 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+#include <atcmd/rxring.h>
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+struct RxRingSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<>;
+
+	static constexpr std::size_t max_commands_per_line = 1;
+};
+
+TEST(RxRing, WrapsAround) {
+	atcmd::RxRing<8> ring;
+	ASSERT_TRUE(ring.isEmpty());
+	ASSERT_EQ(ring.write("abcdef", 6), 6u);
+	ring.consume(4);
+
+	// The free space wraps, the write is split over two spans
+	ASSERT_EQ(ring.writeSpan().size(), 2u);
+	ASSERT_EQ(ring.write("ghijk", 5), 5u);
+
+	std::string r;
+	ASSERT_EQ(ring.drain([&r](const char* data, std::size_t size)
+	{
+		r.append(data, size);
+		return size;
+	}), 7u);
+	ASSERT_EQ(r, "efghijk");
+	ASSERT_TRUE(ring.isEmpty());
+}
+
+TEST(RxRing, DropsWhenFull) {
+	atcmd::RxRing<4> ring;
+	ASSERT_EQ(ring.write("abcdef", 6), 4u);
+	ASSERT_FALSE(ring.push('g'));
+	ASSERT_EQ(ring.getDropped(), 3u);
+
+	// A partial feed stops the drain and keeps the rest
+	ASSERT_EQ(ring.drain([](const char* /*data*/, std::size_t /*size*/) { return std::size_t(1); }), 1u);
+	ASSERT_EQ(ring.readSpan().size(), 3u);
+	ASSERT_EQ(ring.readSpan()[0], 'b');
+}
+
+TEST(RxRing, TwoThreads) {
+	static constexpr uint32_t count = 100000;
+
+	atcmd::RxRing<64> ring;
+	std::thread producer([&ring]()
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			while (!ring.writeSpan().size())
+			{
+				std::this_thread::yield();
+			}
+			ring.push(static_cast<char>(i));
+		}
+	});
+
+	uint32_t received = 0;
+	bool in_order = true;
+	while (received != count)
+	{
+		if (ring.drain([&](const char* data, std::size_t size)
+		{
+			for (std::size_t i = 0; i < size; i++)
+			{
+				in_order &= data[i] == static_cast<char>(received++);
+			}
+			return size;
+		}) == 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+	ASSERT_TRUE(in_order);
+	ASSERT_EQ(ring.getDropped(), 0u);
+}
+
+TEST(RxRing, FeedsServer) {
+	static constexpr std::size_t lines = 10000;
+
+	atcmd::RxRing<32> ring;
+	TestSession<RxRingSettings> session;
+
+	std::thread producer([&ring]()
+	{
+		static constexpr char line[] = "AT\r";
+		for (std::size_t i = 0; i < lines; i++)
+		{
+			std::size_t written = 0;
+			while (written != sizeof(line) - 1)
+			{
+				std::span<char> span = ring.writeSpan();
+				if (span.empty())
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				span[0] = line[written++];
+				ring.commit(1);
+			}
+		}
+	});
+
+	while (session.output.size() != lines * 6)
+	{
+		if (ring.drain([&session](const char* data, std::size_t size)
+		{
+			return session.server.feed(data, size);
+		}) == 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+
+	std::string expected;
+	for (std::size_t i = 0; i < lines; i++)
+	{
+		expected += "\r\nOK\r\n";
+	}
+	ASSERT_EQ(session.output, expected);
+}
@@ -0,0 +1,197 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+struct Mode : public atcmd::server::BasicCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "M";
+
+		struct Value : public BasicNumericParameter
+		{
+			static constexpr Range ranges[] = {{0, 3}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onExec(BasicServerHandle server_handle)
+		{
+			l_log += "M" + std::to_string(Parameters(server_handle).getNumeric<Value>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Factory : public atcmd::server::BasicCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "F";
+
+		struct Profile : public BasicNumericParameter
+		{
+			static constexpr Range ranges[] = {{0, 1}};
+		};
+
+		using Parameters = ParameterList<Profile>;
+
+		static atcmd::RESULT_CODE onExec(BasicServerHandle server_handle)
+		{
+			l_log += "F" + std::to_string(Parameters(server_handle).getNumeric<Profile>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Config : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "CFG";
+
+		struct Level : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{1, 100}};
+		};
+
+		struct Label : public StringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_length = 8;
+			static constexpr const char* default_value = "def";
+		};
+
+		struct Key : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_size = 4;
+			static constexpr uint8_t default_value[] = {0xAB};
+		};
+
+		struct Mask : public HexadecimalNumericParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr Range ranges[] = {{0, 0xFF}};
+			static constexpr uint32_t default_value = 0x10;
+		};
+
+		using Parameters = ParameterList<Level, Label, Key, Mask>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			l_log += "CFG" + std::to_string(parameters.getNumeric<Level>()) + "," + parameters.getString<Label>() + ",";
+			for (uint8_t byte : parameters.getHexString<Key>())
+			{
+				l_log += std::to_string(byte) + " ";
+			}
+			l_log += "," + std::to_string(parameters.getNumeric<Mask>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeInformationText().printText("+CFG:1");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct ScriptSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<Factory, Mode>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<Factory>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Config>;
+
+	static constexpr std::size_t max_commands_per_line = 4;
+};
+
+class ScriptTest : public ServerFixture<ScriptSettings>
+{
+protected:
+	// The script does what the parsed line does
+	template<atcmd::detail::FormatString line>
+	void expectParsedBehaviour()
+	{
+		static constexpr auto script = atcmd::server::makeScript<ScriptSettings, line>();
+		SCOPED_TRACE(line.text);
+
+		feed(std::string(line.text) + "\r");
+		std::string parsed_log = l_log;
+		std::string parsed_output = m_output;
+		l_log.clear();
+		m_output.clear();
+
+		ASSERT_TRUE(m_server.execScript(script));
+		ASSERT_EQ(l_log, parsed_log);
+		ASSERT_EQ(m_output, parsed_output);
+		l_log.clear();
+		m_output.clear();
+	}
+};
+
+TEST_F(ScriptTest, Encoding) {
+	// The basic commands follow the extended command ids, after the S-parameters
+	static constexpr auto script = atcmd::server::makeScript<ScriptSettings, "AT M 2 S3=10">();
+	const uint8_t expected[] = {6, 0, 2, 0, 0, 0, 4, 0, 0x83, 10};
+	ASSERT_EQ(script.data.size(), sizeof(expected));
+	for (std::size_t i = 0; i < sizeof(expected); i++)
+	{
+		ASSERT_EQ(script.data[i], expected[i]);
+	}
+}
+
+TEST_F(ScriptTest, SameAsParsed) {
+	expectParsedBehaviour<"ATM2&F+CFG=5,\"aB c\",\"01-02\",1F;+CFG?">();
+	expectParsedBehaviour<"at+cfg=7">();
+	expectParsedBehaviour<"AT+CFG=1,,\"CAFE\"">();
+	expectParsedBehaviour<"AT+CFG=100,\"12345678\",,FF;+CFG=?">();
+	expectParsedBehaviour<"ATFS4?">();
+	expectParsedBehaviour<"AT">();
+}
+
+TEST_F(ScriptTest, DefaultHexString) {
+	static constexpr auto script = atcmd::server::makeScript<ScriptSettings, "AT+CFG=3">();
+	ASSERT_TRUE(m_server.execScript(script));
+	ASSERT_EQ(l_log, "CFG3,def,171 ,16;");
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+}
+
+TEST_F(ScriptTest, WaitsForTheLine) {
+	static constexpr auto script = atcmd::server::makeScript<ScriptSettings, "ATM1\r">();
+	m_server.feed("AT", 2);
+	ASSERT_FALSE(m_server.execScript(script));
+	m_server.feed('\r');
+	ASSERT_TRUE(m_server.execScript(script));
+	ASSERT_EQ(l_log, "M1;");
+}
@@ -0,0 +1,658 @@
+/**
+* Copyright © 2026 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <atcmd/server/server.h>
+
+static std::string l_output;
+
+static std::size_t l_text_writes;
+
+static std::string l_log;
+
+static void printChar(char ch, void* /*context*/)
+{
+	l_output += ch;
+}
+
+static void printText(const char* text, std::size_t size, void* /*context*/)
+{
+	l_output.append(text, size);
+	l_text_writes++;
+}
+
+struct V : public atcmd::server::BasicCommand
+{
+	// Verbose mode
+	struct Definition
+	{
+		static constexpr char name[] = "V";
+
+		struct Verbose : public BasicNumericParameter
+		{
+			static constexpr Range ranges[] = {{0, 1}};
+		};
+
+		using Parameters = ParameterList<Verbose>;
+
+		static atcmd::RESULT_CODE onExec(BasicServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			server_handle.getServer().getCommunicationParameters().setVerbose(parameters.getNumeric<Verbose>());
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Rc : public atcmd::server::ExtendedCommand
+{
+	// Prints its value as a result code
+	struct Definition
+	{
+		static constexpr char name[] = "RC";
+
+		struct Value : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 255}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			sink_swapped |= server_handle.getServer().getPrintCharCallback() != printChar;
+			server_handle.makeParameterInformationText<Parameters>(name, true)
+					.printNumericParameter<Value>(5);
+			sink_swapped |= server_handle.getServer().getPrintCharCallback() != printChar;
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static const char* onTest(TestServerHandle /*server_handle*/)
+		{
+			return "ALIAS";
+		}
+
+		static inline bool sink_swapped = false;
+	};
+};
+
+struct Txt : public atcmd::server::ExtendedCommand
+{
+	// Prints information text with two parameters
+	struct Definition
+	{
+		static constexpr char name[] = "TXT";
+
+		struct Number : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 255}};
+		};
+
+		struct Text : public StringParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr uint16_t max_length = 10;
+		};
+
+		using Parameters = ParameterList<Number, Text>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			server_handle.makeParameterInformationText<Parameters>(name)
+					.printNumericParameter<Number>(7)
+					.printStringParameter<Text>("abc");
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static const char* onTest(TestServerHandle /*server_handle*/)
+		{
+			return name;
+		}
+	};
+};
+
+struct Num : public atcmd::server::ExtendedCommand
+{
+	// Accepts every kind of parameter
+	struct Definition
+	{
+		static constexpr char name[] = "NUM";
+
+		struct Decimal : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{1, 1}};
+		};
+
+		struct Hexadecimal : public HexadecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 255}};
+		};
+
+		struct Binary : public BinaryNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 3}};
+		};
+
+		struct Hexstring : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr uint16_t max_size = 4;
+		};
+
+		using Parameters = ParameterList<Decimal, Hexadecimal, Binary, Hexstring>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle /*server_handle*/)
+		{
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static const char* onTest(TestServerHandle /*server_handle*/)
+		{
+			return name;
+		}
+	};
+};
+
+struct Id : public atcmd::server::ExtendedCommand
+{
+	// Cached identification
+	struct Definition
+	{
+		static constexpr char name[] = "ID";
+
+		struct Value : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr uint16_t max_size = 2;
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static constexpr uint16_t read_cache_size = 16;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			std::span<const uint8_t> v = parameters.getHexString<Value>();
+			value.assign(v.begin(), v.end());
+			server_handle.getServer().invalidateAllResponseCaches();
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			reads++;
+			server_handle.makeParameterInformationText<Parameters>(name)
+					.printHexadecimalStringParameter<Value>(value.data(), value.size());
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static inline std::vector<uint8_t> value = {0x12};
+		static inline std::size_t reads = 0;
+	};
+};
+
+struct Fmt : public atcmd::server::ExtendedCommand
+{
+	// Prints information text from a response template
+	struct Definition
+	{
+		static constexpr char name[] = "FMT";
+
+		struct Number : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 255}};
+		};
+
+		struct Mask : public HexadecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 255}};
+		};
+
+		struct Text : public StringParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr uint16_t max_length = 4;
+		};
+
+		struct Data : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr uint16_t max_size = 2;
+		};
+
+		using Parameters = ParameterList<Number, Mask, Text, Data>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			static constexpr uint8_t data[] = {0x0A, 0xBC};
+			server_handle.printInformationText<Parameters, "+FMT: {},{},\"{}\",\"{}\"">(7, 0x2A, "abcdef", data);
+			server_handle.printResultCodeText<ParameterList<Number>, "+FMT: {}">(1);
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle /*server_handle*/)
+		{
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Dump : public atcmd::server::ExtendedCommand
+{
+	// Prints information text longer than the buffer it is composed in
+	struct Definition
+	{
+		static constexpr char name[] = "DUMP";
+
+		struct Data : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr uint16_t max_size = 48;
+		};
+
+		using Parameters = ParameterList<Data>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			uint8_t data[max_size];
+			for (uint8_t i = 0; i < max_size; i++)
+			{
+				data[i] = i;
+			}
+			server_handle.printInformationText<Parameters, "+DUMP:\"{}\"">(std::span<const uint8_t>(data));
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static constexpr uint8_t max_size = Data::max_size;
+	};
+};
+
+struct Speaker : public atcmd::server::BasicCommand
+{
+	// Monitor speaker mode
+	struct Definition
+	{
+		static constexpr char name[] = "M";
+
+		struct Mode : public BasicNumericParameter
+		{
+			static constexpr Range ranges[] = {{0, 2}};
+		};
+
+		using Parameters = ParameterList<Mode>;
+
+		static atcmd::RESULT_CODE onExec(BasicServerHandle server_handle)
+		{
+			l_log += "M" + std::to_string(Parameters(server_handle).getNumeric<Mode>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Store : public atcmd::server::BasicCommand
+{
+	// Stores the active profile
+	struct Definition
+	{
+		static constexpr char name[] = "W";
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onExec(BasicServerHandle /*server_handle*/)
+		{
+			l_log += "&W;";
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct Key : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "KEY";
+
+		struct Slot : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 9}};
+		};
+
+		struct Value : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr uint16_t max_size = 4;
+			static constexpr uint8_t default_value[] = {0xAB, 0xCD};
+		};
+
+		struct Mask : public HexadecimalNumericParameter
+		{
+			static constexpr bool is_optional = true;
+			static constexpr Range ranges[] = {{0, 0xFF}};
+			static constexpr uint32_t default_value = 0x10;
+		};
+
+		using Parameters = ParameterList<Slot, Value, Mask>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			l_log += "KEY" + std::to_string(parameters.getNumeric<Slot>()) + ",";
+			for (uint8_t byte : parameters.getHexString<Value>())
+			{
+				l_log += std::to_string(byte) + " ";
+			}
+			l_log += "," + std::to_string(parameters.getNumeric<Mask>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+struct ServerSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<Speaker, V>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<Store>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Rc, Txt, Num, Id, Fmt, Dump, Key>;
+
+	static constexpr std::size_t max_commands_per_line = 3;
+};
+
+class ServerTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		l_output.clear();
+		l_log.clear();
+		m_server.getCommunicationParameters().setEchoEnabled(false);
+	}
+
+	void feed(const char* line)
+	{
+		while (*line != '\0')
+		{
+			m_server.feed(*line++);
+		}
+	}
+
+	atcmd::server::Server<ServerSettings> m_server{printChar};
+};
+
+TEST_F(ServerTest, InformationText) {
+	feed("AT+TXT?\r");
+	ASSERT_EQ(l_output, "\r\n+TXT:7,\"abc\"\r\n\r\nOK\r\n");
+}
+
+TEST_F(ServerTest, BasicCommandFollowedByAnother) {
+	// The character after the numeric parameter starts the next command
+	feed("ATM2&W\r");
+	ASSERT_EQ(l_log, "M2;&W;");
+	ASSERT_EQ(l_output, "\r\nOK\r\n");
+
+	l_log.clear();
+	l_output.clear();
+	feed("ATM1+KEY=1\r");
+	ASSERT_EQ(l_log, "M1;KEY1,171 205 ,16;");
+	ASSERT_EQ(l_output, "\r\nOK\r\n");
+}
+
+TEST_F(ServerTest, ParameterlessAmpersandCommand) {
+	feed("AT&W\r");
+	ASSERT_EQ(l_log, "&W;");
+	ASSERT_EQ(l_output, "\r\nOK\r\n");
+
+	l_log.clear();
+	l_output.clear();
+	feed("AT&W&WM0\r");
+	ASSERT_EQ(l_log, "&W;&W;M0;");
+	ASSERT_EQ(l_output, "\r\nOK\r\n");
+}
+
+TEST_F(ServerTest, OmittedHexadecimalStringDefault) {
+	// The default is stored in the slot of the parameter and the following ones are still completed
+	feed("AT+KEY=3\r");
+	ASSERT_EQ(l_log, "KEY3,171 205 ,16;");
+
+	l_log.clear();
+	feed("AT+KEY=4,,1F\r");
+	ASSERT_EQ(l_log, "KEY4,171 205 ,31;");
+
+	l_log.clear();
+	feed("AT+KEY=5,\"01\"\r");
+	ASSERT_EQ(l_log, "KEY5,1 ,16;");
+	ASSERT_EQ(l_output, "\r\nOK\r\n\r\nOK\r\n\r\nOK\r\n");
+}
+
+TEST_F(ServerTest, ResultCodeText) {
+	feed("AT+RC?\r");
+	ASSERT_EQ(l_output, "\r\n+RC:5\r\n\r\nOK\r\n");
+}
+
+TEST_F(ServerTest, ResultCodeTextSuppressed) {
+	Rc::Definition::sink_swapped = false;
+	feed("AT+RC?;+TXT?;+RC?\r");
+	ASSERT_EQ(l_output, "\r\n+TXT:7,\"abc\"\r\n\r\n+RC:5\r\n\r\nOK\r\n");
+	ASSERT_FALSE(Rc::Definition::sink_swapped);
+}
+
+TEST_F(ServerTest, NumericResultCode) {
+	feed("ATV0\r");
+	ASSERT_EQ(l_output, "0\r");
+	l_output.clear();
+	feed("AT+RC?\r");
+	ASSERT_EQ(l_output, "+RC:5\r0\r");
+	l_output.clear();
+	feed("AT+NONE\r");
+	ASSERT_EQ(l_output, "4\r");
+	l_output.clear();
+	feed("ATV1\r");
+	ASSERT_EQ(l_output, "\r\nOK\r\n");
+}
+
+TEST_F(ServerTest, ResponseFormattingCharacters) {
+	feed("ATS3=10S4=13\r");
+	ASSERT_EQ(l_output, "\n\rOK\n\r");
+	l_output.clear();
+	feed("AT+TXT?\n");
+	ASSERT_EQ(l_output, "\n\r+TXT:7,\"abc\"\n\r\n\rOK\n\r");
+}
+
+TEST_F(ServerTest, SingleWriteResultCode) {
+	m_server.setPrintTextCallback(printText);
+	l_text_writes = 0;
+	feed("AT\r");
+	ASSERT_EQ(l_output, "\r\nOK\r\n");
+	ASSERT_EQ(l_text_writes, 1);
+}
+
+TEST_F(ServerTest, TestCommand) {
+	feed("AT+TXT=?\r");
+	ASSERT_EQ(l_output, "\r\n+TXT:(0-255),(s:10)\r\n\r\nOK\r\n");
+	l_output.clear();
+	feed("AT+NUM=?;+RC=?\r");
+	ASSERT_EQ(l_output, "\r\n+NUM:(1),(0-FF),(0-11),(hs:4)\r\n\r\n+ALIAS:(0-255)\r\n\r\nOK\r\n");
+}
+
+TEST_F(ServerTest, ResponseCache) {
+	Id::Definition::value = {0x12};
+	Id::Definition::reads = 0;
+	m_server.invalidateResponseCache();
+	feed("AT+ID?\r");
+	ASSERT_EQ(l_output, "\r\n+ID:\"12\"\r\n\r\nOK\r\n");
+	l_output.clear();
+	feed("AT+ID?\r");
+	ASSERT_EQ(l_output, "\r\n+ID:\"12\"\r\n\r\nOK\r\n");
+	ASSERT_EQ(Id::Definition::reads, 1);
+
+	// Invalidated by the write handler
+	l_output.clear();
+	feed("AT+ID=\"ABCD\";+ID?\r");
+	ASSERT_EQ(l_output, "\r\n+ID:\"ABCD\"\r\n\r\nOK\r\n");
+	ASSERT_EQ(Id::Definition::reads, 2);
+
+	// Invalidated by the application
+	Id::Definition::value = {0x34};
+	m_server.invalidateResponseCache<Id>();
+	l_output.clear();
+	feed("AT+ID?\r");
+	ASSERT_EQ(l_output, "\r\n+ID:\"34\"\r\n\r\nOK\r\n");
+	ASSERT_EQ(Id::Definition::reads, 3);
+
+	// Recorded again when the framing changes
+	l_output.clear();
+	feed("ATV0\r");
+	l_output.clear();
+	feed("AT+ID?\r");
+	ASSERT_EQ(l_output, "+ID:\"34\"\r\n0\r");
+	ASSERT_EQ(Id::Definition::reads, 4);
+	feed("ATV1\r");
+}
+
+TEST_F(ServerTest, SharedResponseCache) {
+	Id::Definition::value = {0x12};
+	atcmd::server::Server<ServerSettings> other{printChar};
+	other.getCommunicationParameters().setEchoEnabled(false);
+	for (char ch : std::string_view("AT+ID?\r"))
+	{
+		other.feed(ch);
+	}
+	ASSERT_EQ(l_output, "\r\n+ID:\"12\"\r\n\r\nOK\r\n");
+
+	// The handler of another session changes the data, the response cached by this one is dropped too
+	feed("AT+ID=\"56\"\r");
+	l_output.clear();
+	for (char ch : std::string_view("AT+ID?\r"))
+	{
+		other.feed(ch);
+	}
+	ASSERT_EQ(l_output, "\r\n+ID:\"56\"\r\n\r\nOK\r\n");
+}
+
+TEST_F(ServerTest, ResponseTemplate) {
+	m_server.setPrintTextCallback(printText);
+	l_text_writes = 0;
+	feed("AT+FMT?\r");
+	ASSERT_EQ(l_output, "\r\n+FMT: 7,2A,\"abcd\",\"0ABC\"\r\n\r\n+FMT: 1\r\n\r\nOK\r\n");
+	ASSERT_EQ(l_text_writes, 3);
+
+	// The result code text of a non-final command is suppressed
+	l_output.clear();
+	feed("AT+FMT?;+TXT?\r");
+	ASSERT_EQ(l_output, "\r\n+FMT: 7,2A,\"abcd\",\"0ABC\"\r\n\r\n+TXT:7,\"abc\"\r\n\r\nOK\r\n");
+}
+
+TEST_F(ServerTest, LongResponseTemplate) {
+	std::string data;
+	for (uint8_t i = 0; i < Dump::Definition::max_size; i++)
+	{
+		static constexpr char digits[] = "0123456789ABCDEF";
+		data += digits[i >> 4];
+		data += digits[i & 0xF];
+	}
+	feed("AT+DUMP?\r");
+	ASSERT_EQ(l_output, "\r\n+DUMP:\"" + data + "\"\r\n\r\nOK\r\n");
+}
+
+struct EmptySettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<>;
+
+	static constexpr std::size_t max_commands_per_line = 3;
+};
+
+struct Poll : public atcmd::server::ExtendedCommand
+{
+	// Asynchronous command keeping its progress in an AsyncState
+	struct Definition
+	{
+		static constexpr char name[] = "POLL";
+
+		struct AsyncState
+		{
+			uint32_t remaining;
+		};
+
+		struct Count : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{1, 9}};
+		};
+
+		using Parameters = ParameterList<Count>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle, AsyncState& state)
+		{
+			if (server_handle.getCallType() == WriteServerHandle::CALL_TYPE::REQUEST)
+			{
+				state.remaining = Parameters(server_handle).getNumeric<Count>();
+				return atcmd::RESULT_CODE::ASYNC;
+			}
+			return --state.remaining == 0 ? atcmd::RESULT_CODE::OK : atcmd::RESULT_CODE::ASYNC;
+		}
+	};
+};
+
+// Response cache, URC queue and AsyncState slots on top of the empty configuration
+struct TypicalSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Id, Poll>;
+
+	static constexpr std::size_t max_commands_per_line = 3;
+	static constexpr std::size_t urc_queue_size = 4;
+	static constexpr std::size_t urc_max_length = 32;
+};
+
+TEST(SessionTest, SizeBudget) {
+	// Callbacks, context, output recorder and the state pointer plus the scalar per-channel state
+	// and the command line buffer
+	ASSERT_LE(sizeof(atcmd::server::Session<EmptySettings>), 6 * sizeof(void*) + 64);
+
+	// Each feature adds its storage only: the URC entries with their size, priority and order, the count and
+	// the dropped counter, the cache slot with its data, the AsyncState with its slot index, plus padding
+	static constexpr std::size_t urc_size =
+			TypicalSettings::urc_queue_size * (TypicalSettings::urc_max_length + 4) + 1 + sizeof(uint32_t);
+	static constexpr std::size_t cache_size =
+			sizeof(atcmd::server::detail::ResponseCacheSlot) + Id::Definition::read_cache_size;
+	static constexpr std::size_t async_state_size = sizeof(Poll::Definition::AsyncState) + 1;
+	static_assert(sizeof(atcmd::server::Session<TypicalSettings>) <=
+			sizeof(atcmd::server::Session<EmptySettings>) + urc_size + cache_size + async_state_size + 16);
+}
@@ -0,0 +1,234 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+// Takes a text of up to a megabyte, received in chunks of 8 characters
+struct Blob : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "BLOB";
+
+		struct Slot : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 3}};
+		};
+
+		struct Text : public StringParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr uint32_t max_length = 1000000;
+			static constexpr uint16_t chunk_size = 8;
+		};
+
+		using Parameters = ParameterList<Slot, Text>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			Parameters parameters(server_handle);
+			l_log += "W" + std::to_string(parameters.getNumeric<Slot>()) + "," +
+					std::to_string(parameters.getStreamedSize<Text>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static void onData(WriteServerHandle server_handle, std::span<const uint8_t> data)
+		{
+			// The parameters before the streamed one are already set
+			std::string slot = std::to_string(Parameters(server_handle).getNumeric<Slot>());
+			if (server_handle.getCallType() == WriteServerHandle::CALL_TYPE::ABORT)
+			{
+				l_log += "A" + slot + ";";
+				return;
+			}
+			EXPECT_EQ(server_handle.getCallType(), WriteServerHandle::CALL_TYPE::DATA);
+			l_log += "D" + slot + ":" + std::string(data.begin(), data.end()) + ";";
+		}
+
+		static const char* onTest(TestServerHandle /*server_handle*/)
+		{
+			return name;
+		}
+	};
+};
+
+// Takes up to 4 bytes, received in chunks of 2 bytes
+struct Firmware : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "FW";
+
+		struct Image : public HexadecimalStringParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr uint32_t max_size = 4;
+			static constexpr uint16_t chunk_size = 2;
+		};
+
+		using Parameters = ParameterList<Image>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			l_log += "W" + std::to_string(Parameters(server_handle).getStreamedSize<Image>()) + ";";
+			return atcmd::RESULT_CODE::OK;
+		}
+
+		static void onData(WriteServerHandle server_handle, std::span<const uint8_t> data)
+		{
+			if (server_handle.getCallType() == WriteServerHandle::CALL_TYPE::ABORT)
+			{
+				l_log += "A;";
+				return;
+			}
+			l_log += "D";
+			for (uint8_t byte : data)
+			{
+				l_log += " " + std::to_string(byte);
+			}
+			l_log += ";";
+		}
+	};
+};
+
+// Always fails
+struct Reject : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "REJ";
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle /*server_handle*/)
+		{
+			return atcmd::RESULT_CODE::ERROR;
+		}
+	};
+};
+
+struct StreamSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Blob, Firmware, Reject>;
+
+	static constexpr std::size_t max_commands_per_line = 2;
+};
+
+using StreamServer = atcmd::server::Server<StreamSettings>;
+
+// Only a chunk is reserved for a streamed parameter, not its maximum size
+static_assert(sizeof(StreamServer) < 1024);
+
+using StreamTest = ServerFixture<StreamSettings>;
+
+TEST_F(StreamTest, Chunks) {
+	// The chunks are passed while the line is received, before the command runs
+	feed("AT+BLOB=2,\"Hello, streamed wo");
+	ASSERT_EQ(l_log, "D2:Hello, s;D2:treamed ;");
+	ASSERT_EQ(m_output, "");
+
+	feed("rld\"\r");
+	ASSERT_EQ(l_log, "D2:Hello, s;D2:treamed ;D2:world;W2,21;");
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+}
+
+TEST_F(StreamTest, HexString) {
+	feed("AT+FW=\"01 0A-ff\"\r");
+	ASSERT_EQ(l_log, "D 1 10;D 255;W3;");
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+
+	l_log.clear();
+	feed("AT+FW=\"\";+BLOB=0,\"\"\r");
+	ASSERT_EQ(l_log, "W0;W0,0;");
+}
+
+TEST_F(StreamTest, TestCommand) {
+	feed("AT+BLOB=?\r");
+	ASSERT_EQ(m_output, "\r\n+BLOB:(0-3),(s:1000000)\r\n\r\nOK\r\n");
+}
+
+TEST_F(StreamTest, AbortedLine) {
+	// The line fails after chunks were passed
+	feed("AT+BLOB=1,\"0123456789\"X\r");
+	ASSERT_EQ(l_log, "D1:01234567;D1:89;A1;");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+
+	// Too long
+	l_log.clear();
+	m_output.clear();
+	feed("AT+FW=\"0102030405\"\r");
+	ASSERT_EQ(l_log, "D 1 2;D 3 4;A;");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+
+	// The closing quote passes the rest of the chunk
+	l_log.clear();
+	m_output.clear();
+	feed("AT+BLOB=1,\"0123\"X\r");
+	ASSERT_EQ(l_log, "D1:0123;A1;");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+
+	// Nothing was passed yet
+	l_log.clear();
+	m_output.clear();
+	feed("AT+BLOB=9,\"0123\"\r");
+	ASSERT_EQ(l_log, "");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+
+	// The command before is run, the streamed one is not
+	l_log.clear();
+	m_output.clear();
+	feed("AT+REJ?;+BLOB=3,\"abc\"\r");
+	ASSERT_EQ(l_log, "D3:abc;A3;");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+
+	// The server goes on
+	l_log.clear();
+	m_output.clear();
+	feed("AT+BLOB=0,\"x\";+BLOB=1,\"y\"\r");
+	ASSERT_EQ(l_log, "D0:x;D1:y;W0,1;W1,1;");
+	ASSERT_EQ(m_output, "\r\nOK\r\n");
+}
+
+TEST_F(StreamTest, NotRepeated) {
+	// The payload is not kept, A/ can not run the handler again
+	feed("AT+BLOB=2,\"abc\"\r");
+	l_log.clear();
+	m_output.clear();
+	feed("A/");
+	ASSERT_EQ(l_log, "");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+
+	m_output.clear();
+	feed("A/");
+	ASSERT_EQ(m_output, "\r\nERROR\r\n");
+}
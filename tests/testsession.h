@@ -0,0 +1,82 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief Shared fixtures of the server tests
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#ifndef ATCMD_TESTS_TESTSESSION_H
+#define ATCMD_TESTS_TESTSESSION_H
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+#include <atcmd/server/server.h>
+
+// Trace of the command handlers, cleared before each test
+inline std::string l_log;
+
+// Output callback appending to the std::string passed as the context
+inline void printChar(char ch, void* context)
+{
+	*static_cast<std::string*>(context) += ch;
+}
+
+// Server with the echo disabled, collecting its output. Used directly where a test needs several servers
+template<class Settings, void (*print)(char, void*) = printChar>
+struct TestSession
+{
+	TestSession()
+	{
+		server.getCommunicationParameters().setEchoEnabled(false);
+	}
+
+	void feed(std::string_view data)
+	{
+		ASSERT_EQ(server.feed(data.data(), data.size()), data.size());
+	}
+
+	std::string output;
+	atcmd::server::Server<Settings> server{print, &output};
+};
+
+// Fixture of the tests running against a single server. Derived fixtures overriding SetUp() call this one first
+template<class Settings, void (*print)(char, void*) = printChar>
+class ServerFixture : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		l_log.clear();
+		m_server.getCommunicationParameters().setEchoEnabled(false);
+	}
+
+	void feed(std::string_view data)
+	{
+		ASSERT_EQ(m_server.feed(data.data(), data.size()), data.size());
+	}
+
+	std::string m_output;
+	atcmd::server::Server<Settings> m_server{print, &m_output};
+};
+
+#endif // ATCMD_TESTS_TESTSESSION_H
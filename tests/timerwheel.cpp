@@ -0,0 +1,211 @@
+/**
+* Copyright © 2026 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <atcmd/server/server.h>
+#include <atcmd/server/timerwheel.h>
+
+#include "testsession.h"
+
+struct Wait : public atcmd::server::ExtendedCommand
+{
+	// Completes on a read update only
+	struct Definition
+	{
+		static constexpr char name[] = "WAIT";
+		static constexpr uint32_t timeout = 10;
+
+		struct Value : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 255}};
+		};
+
+		using Parameters = ParameterList<Value>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			switch (server_handle.getCallType()) {
+			case ReadServerHandle::CALL_TYPE::REQUEST:
+				return atcmd::RESULT_CODE::ASYNC;
+			case ReadServerHandle::CALL_TYPE::ABORT:
+				aborts++;
+				return atcmd::RESULT_CODE::ASYNC;
+			default:
+				return atcmd::RESULT_CODE::OK;
+			}
+		}
+
+		static inline uint32_t aborts = 0;
+	};
+};
+
+struct TimeoutSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Wait>;
+
+	static constexpr std::size_t max_commands_per_line = 2;
+	static constexpr uint32_t inter_character_timeout = 5;
+};
+
+struct TimeoutSession : public TestSession<TimeoutSettings>
+{
+	TimeoutSession(atcmd::server::TimerWheel& wheel)
+	{
+		server.setTimerWheel(wheel);
+	}
+};
+
+struct Expiry
+{
+	atcmd::server::TimerWheel::Timer timer;
+	atcmd::server::TimerWheel* wheel;
+	uint32_t expected;
+	uint32_t expired;
+};
+
+static void onExpired(void* context)
+{
+	Expiry* expiry = static_cast<Expiry*>(context);
+	expiry->expired = expiry->wheel->getTime();
+}
+
+TEST(TimerWheel, ExpiresOnTime) {
+	atcmd::server::TimerWheel wheel;
+	wheel.tick(1000);
+
+	std::mt19937 random(1);
+	std::vector<uint32_t> delays = {1, 2, 63, 64, 65, 127, 128, 4095, 4096, 4097, 262143, 262144, 300000};
+	for (std::size_t i = 0; i < 2000; i++)
+	{
+		delays.push_back(1 + random() % 100000);
+	}
+
+	std::vector<Expiry> expiries(delays.size());
+	for (std::size_t i = 0; i < delays.size(); i++)
+	{
+		expiries[i] = {{}, &wheel, wheel.getTime() + delays[i], 0};
+		expiries[i].timer.callback = onExpired;
+		expiries[i].timer.context = &expiries[i];
+		wheel.arm(expiries[i].timer, delays[i]);
+		// Different phases of the lower levels
+		wheel.tick(1);
+	}
+
+	wheel.tick(300000);
+	for (const Expiry& expiry : expiries)
+	{
+		ASSERT_FALSE(expiry.timer.isArmed());
+		ASSERT_EQ(expiry.expired, expiry.expected);
+	}
+}
+
+TEST(TimerWheel, Cancel) {
+	atcmd::server::TimerWheel wheel;
+	Expiry first{{}, &wheel, 0, 0};
+	Expiry second{{}, &wheel, 0, 0};
+	for (Expiry* expiry : {&first, &second})
+	{
+		expiry->timer.callback = onExpired;
+		expiry->timer.context = expiry;
+		wheel.arm(expiry->timer, 100);
+	}
+	atcmd::server::TimerWheel::cancel(first.timer);
+	ASSERT_FALSE(first.timer.isArmed());
+	wheel.tick(100);
+	ASSERT_EQ(first.expired, 0);
+	ASSERT_EQ(second.expired, 100);
+}
+
+TEST(TimerWheel, CommandTimeout) {
+	atcmd::server::TimerWheel wheel;
+	TimeoutSession session(wheel);
+	Wait::Definition::aborts = 0;
+
+	session.feed("AT+WAIT?\r");
+	wheel.tick(9);
+	ASSERT_EQ(session.output, "");
+	wheel.tick(1);
+	ASSERT_EQ(session.output, "\r\nERROR\r\n");
+	ASSERT_EQ(Wait::Definition::aborts, 1);
+
+	// Late completions are ignored
+	session.server.onExtendedCommandReadUpdate<Wait>();
+	session.feed("AT\r");
+	ASSERT_EQ(session.output, "\r\nERROR\r\n\r\nOK\r\n");
+}
+
+TEST(TimerWheel, CompletionCancelsTimeout) {
+	atcmd::server::TimerWheel wheel;
+	TimeoutSession session(wheel);
+
+	session.feed("AT+WAIT?;+WAIT?\r");
+	wheel.tick(5);
+	session.server.onExtendedCommandReadUpdate<Wait>();
+	// The second command has its own deadline
+	wheel.tick(9);
+	session.server.onExtendedCommandReadUpdate<Wait>();
+	wheel.tick(100);
+	ASSERT_EQ(session.output, "\r\nOK\r\n");
+}
+
+TEST(TimerWheel, InterCharacterTimeout) {
+	atcmd::server::TimerWheel wheel;
+	TimeoutSession session(wheel);
+
+	session.feed("AT+WA");
+	wheel.tick(4);
+	session.feed("IT?");
+	wheel.tick(5);
+	session.feed("\rAT\r");
+	ASSERT_EQ(session.output, "\r\nOK\r\n");
+}
+
+TEST(TimerWheel, ManySessions) {
+	atcmd::server::TimerWheel wheel;
+	std::vector<std::unique_ptr<TimeoutSession>> sessions;
+	for (std::size_t i = 0; i < 2000; i++)
+	{
+		sessions.push_back(std::make_unique<TimeoutSession>(wheel));
+		sessions.back()->feed("AT+WAIT?\r");
+		if (i % 2 == 0)
+		{
+			sessions.back()->server.onExtendedCommandReadUpdate<Wait>();
+		}
+	}
+	wheel.tick(10);
+	for (std::size_t i = 0; i < sessions.size(); i++)
+	{
+		ASSERT_EQ(sessions[i]->output, i % 2 == 0 ? "\r\nOK\r\n" : "\r\nERROR\r\n");
+	}
+}
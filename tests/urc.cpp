@@ -0,0 +1,145 @@
+/**
+* Copyright © 2025 Valentin Gorelov
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+* documentation files (the “Software”), to deal in the Software without restriction,
+* including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so,
+* subject to the following conditions:
+*
+* The above copyright notice and this permission notice
+* shall be included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/**
+ * @brief
+ * @author Valentin Gorelov <gorelov.valentin@gmail.com>
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <atcmd/server/server.h>
+
+#include "testsession.h"
+
+// Prints two responses, the second one on an update
+struct Measure : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "MEAS";
+
+		using Parameters = ParameterList<>;
+
+		static atcmd::RESULT_CODE onRead(ReadServerHandle server_handle)
+		{
+			if (server_handle.getCallType() == ReadServerHandle::CALL_TYPE::REQUEST)
+			{
+				server_handle.makeInformationText().printText("+MEAS:1");
+				return atcmd::RESULT_CODE::ASYNC;
+			}
+			server_handle.makeInformationText().printText("+MEAS:2");
+			return atcmd::RESULT_CODE::OK;
+		}
+	};
+};
+
+// Waits for the escape sequence
+struct Pipe : public atcmd::server::ExtendedCommand
+{
+	struct Definition
+	{
+		static constexpr char name[] = "PIPE";
+		static constexpr char data_escape[] = "+++";
+
+		struct Channel : public DecimalNumericParameter
+		{
+			static constexpr bool is_optional = false;
+			static constexpr Range ranges[] = {{0, 9}};
+		};
+
+		using Parameters = ParameterList<Channel>;
+
+		static atcmd::RESULT_CODE onWrite(WriteServerHandle server_handle)
+		{
+			return server_handle.getCallType() == WriteServerHandle::CALL_TYPE::REQUEST ?
+					atcmd::RESULT_CODE::CONNECT :
+					atcmd::RESULT_CODE::OK;
+		}
+
+		static void onData(WriteServerHandle /*server_handle*/, std::span<const uint8_t> /*data*/)
+		{}
+	};
+};
+
+struct UrcTestSettings
+{
+	using BasicCommands = atcmd::server::BasicCommandList<>;
+	using AmpersandCommands = atcmd::server::AmpersandCommandList<>;
+	using ExtendedCommands = atcmd::server::ExtendedCommandList<Measure, Pipe>;
+
+	static constexpr std::size_t max_commands_per_line = 1;
+	static constexpr std::size_t urc_queue_size = 3;
+	static constexpr std::size_t urc_max_length = 16;
+};
+
+using UrcTest = ServerFixture<UrcTestSettings>;
+
+TEST_F(UrcTest, PrintedWhenIdle) {
+	ASSERT_TRUE(m_server.postUrc("RING"));
+	ASSERT_EQ(m_output, "\r\nRING\r\n");
+}
+
+TEST_F(UrcTest, HeldWhileLineIsTyped) {
+	feed("AT+ME");
+	ASSERT_TRUE(m_server.postUrc("RING"));
+	ASSERT_EQ(m_output, "");
+	feed("AS?");
+	ASSERT_EQ(m_output, "");
+	feed("\r");
+	m_server.onExtendedCommandReadUpdate<Measure>();
+	ASSERT_EQ(m_output, "\r\n+MEAS:1\r\n\r\nRING\r\n\r\n+MEAS:2\r\n\r\nOK\r\n");
+}
+
+TEST_F(UrcTest, PriorityAndCoalescing) {
+	feed("AT");
+	ASSERT_TRUE(m_server.postUrc("+CSQ:10,99", 0, true));
+	ASSERT_TRUE(m_server.postUrc("+CREG:1", 0));
+	ASSERT_TRUE(m_server.postUrc("+CSQ:20,99", 0, true));
+	ASSERT_TRUE(m_server.postUrc("RING", 1));
+	feed("\r");
+	ASSERT_EQ(m_output, "\r\nOK\r\n\r\nRING\r\n\r\n+CREG:1\r\n\r\n+CSQ:20,99\r\n");
+}
+
+TEST_F(UrcTest, BoundedQueue) {
+	feed("AT");
+	ASSERT_TRUE(m_server.postUrc("+A:1"));
+	ASSERT_TRUE(m_server.postUrc("+B:1"));
+	ASSERT_TRUE(m_server.postUrc("+C:1"));
+	// Full of URCs of the same priority
+	ASSERT_FALSE(m_server.postUrc("+D:1"));
+	// The last URC of the lowest priority is evicted
+	ASSERT_TRUE(m_server.postUrc("+E:1", 2));
+	// Too long
+	ASSERT_FALSE(m_server.postUrc("+F:0123456789ABCDEF", 3));
+	ASSERT_EQ(m_server.getDroppedUrcCount(), 3u);
+	feed("\r");
+	ASSERT_EQ(m_output, "\r\nOK\r\n\r\n+E:1\r\n\r\n+A:1\r\n\r\n+B:1\r\n");
+}
+
+TEST_F(UrcTest, HeldInDataMode) {
+	feed("AT+PIPE=0\r");
+	ASSERT_TRUE(m_server.postUrc("RING"));
+	feed("ab");
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n");
+	feed("+++");
+	ASSERT_EQ(m_output, "\r\nCONNECT\r\n\r\nOK\r\n\r\nRING\r\n");
+}